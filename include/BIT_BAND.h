@@ -0,0 +1,42 @@
+#ifndef BIT_BAND_H
+#define BIT_BAND_H
+
+#include "STD_TYPES.h"
+
+/*
+ * Cortex-M3 bit-band: every bit of the first MB of SRAM (0x20000000) and of the peripherals (0x40000000)
+ * has its own 32-bit alias word (0x22000000 / 0x42000000). Storing 0 or 1 to the alias is a single
+ * store that the bus turns into an atomic read-modify-write of that bit only, so it cannot lose a
+ * concurrent ISR update, and reading the alias returns the bit.
+ * The core registers (NVIC, SysTick, SCB at 0xE000xxxx) are not bit-banded, keep BIT_MATH.h there.
+ * rc_w1 registers (EXTI PR) must not go through the alias either: the write-back of the other bits
+ * read as 1 would clear them, write the single bit mask instead.
+ */
+
+#define BITBAND_SRAM_START			0x20000000UL
+#define BITBAND_SRAM_ALIAS			0x22000000UL
+#define BITBAND_PERIPH_START		0x40000000UL
+#define BITBAND_PERIPH_ALIAS		0x42000000UL
+#define BITBAND_REGION_SIZE			0x00100000UL
+
+/* Alias word of bit BIT of the register at target address ADDRESS (either region) */
+#define BITBAND_ALIAS_ADDRESS(ADDRESS, BIT)	\
+	((((u32)(ADDRESS)) & 0xF0000000UL) + 0x02000000UL + ((((u32)(ADDRESS)) & 0x000FFFFFUL) << 5) + ((u32)(BIT) << 2))
+
+/* Single bit access of a register (lvalue, e.g. RCC->APB1ENR) */
+#ifdef HOST_SIM
+/* host build: the SIM module maps the alias back onto its register memory */
+#include "SIM_interface.h"
+#define BITBAND_SET(REG, BIT)		SIM_voidBitBandWrite(&(REG), (BIT), 1)
+#define BITBAND_CLR(REG, BIT)		SIM_voidBitBandWrite(&(REG), (BIT), 0)
+#define BITBAND_WRITE(REG, BIT, VAL)	SIM_voidBitBandWrite(&(REG), (BIT), ((VAL) != 0))
+#define BITBAND_GET(REG, BIT)		SIM_u32BitBandRead(&(REG), (BIT))
+#else
+#define BITBAND_WORD(REG, BIT)		(*(volatile u32 *)BITBAND_ALIAS_ADDRESS(&(REG), (BIT)))
+#define BITBAND_SET(REG, BIT)		(BITBAND_WORD(REG, BIT) = 1)
+#define BITBAND_CLR(REG, BIT)		(BITBAND_WORD(REG, BIT) = 0)
+#define BITBAND_WRITE(REG, BIT, VAL)	(BITBAND_WORD(REG, BIT) = ((VAL) != 0))
+#define BITBAND_GET(REG, BIT)		(BITBAND_WORD(REG, BIT))
+#endif
+
+#endif
@@ -9,7 +9,8 @@
 #define DIO_H_
 
 #include "Dio_Cfg.h"
-#include "STD_Types.h"
+#include "STD_TYPES.h"
+#include "stm32f103C8.h"
 
 /* Id for the company in the AUTOSAR for example 1999 */
 #define DIO_VENDOR_ID    (1999U)
@@ -32,6 +33,14 @@
 #define DIO_PORTA					   	((Dio_PortType)0)
 #define DIO_PORTB					   	((Dio_PortType)1)
 #define DIO_PORTC					   	((Dio_PortType)2)
+#define DIO_PORT_COUNT				   	(3U)
+
+/* Channel ID -> port / pin, a channel is Port * 16 + Pin */
+#define DIO_CHANNEL_PORT(CHANNEL)		((Dio_PortType)((CHANNEL) >> 4))
+#define DIO_CHANNEL_PIN(CHANNEL)		((CHANNEL) & 0x0F)
+
+/* BSRR word of a pin mask: low half sets the pins, high half resets them (no branch on the level) */
+#define DIO_BSRR_VALUE(PINMASK, LEVEL)	((u32)(PINMASK) << (((LEVEL) == STD_LOW) << 4))
 
 typedef u8 Dio_ChannelType;		/* Numeric ID of a DIO channel. */
 typedef u8 Dio_PortType;		/* Numeric ID of a DIO port. */
@@ -74,6 +83,29 @@ Dio_LevelType Dio_ReadChannel( Dio_ChannelType ChannelId );
  */
 void Dio_WriteChannel( Dio_ChannelType ChannelId, Dio_LevelType Level );
 
+/* GPIO register blocks of DIO_PORTA..DIO_PORTC, evenly spaced: computed from the port without a table load,
+ * folds to one block for a constant channel */
+#define DIO_GPIO_PORT_STRIDE			(GPIO_u32_GPIOB_BASE_ADDRESS - GPIO_u32_GPIOA_BASE_ADDRESS)
+#define DIO_PORT_GPIO(PORT)				((GPIO_RegDef_t *)PERIPH_BASE(GPIO_u32_GPIOA_BASE_ADDRESS + \
+										 ((u32)(PORT) * DIO_GPIO_PORT_STRIDE)))
+#define DIO_CHANNEL_GPIO(CHANNEL)		DIO_PORT_GPIO(DIO_CHANNEL_PORT(CHANNEL))
+
+/*
+ * Service name: Dio_ReadChannelInline / Dio_WriteChannelInline
+ * Description: Inlineable variants for compile-time constant channel IDs, the port and pin fold to constants
+ * 				and a write is one store to BSRR. No check of the channel ID or of the configured direction:
+ * 				only use them on valid channels that Port_Init set up for this direction.
+ */
+static inline Dio_LevelType Dio_ReadChannelInline( Dio_ChannelType ChannelId )
+{
+	return (Dio_LevelType)((DIO_CHANNEL_GPIO(ChannelId)->IDR >> DIO_CHANNEL_PIN(ChannelId)) & 1);
+}
+
+static inline void Dio_WriteChannelInline( Dio_ChannelType ChannelId, Dio_LevelType Level )
+{
+	DIO_CHANNEL_GPIO(ChannelId)->BSRR = DIO_BSRR_VALUE(1UL << DIO_CHANNEL_PIN(ChannelId), Level);
+}
+
 /*
  * Service name: Dio_ReadPort
  * Parameters (in): PortId -> ID of DIO Port
@@ -0,0 +1,13 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : DMA1                                    */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef DMA_CONFIG_H
+#define DMA_CONFIG_H
+
+/* Enable the half transfer interrupt of every started channel (DMA_ENABLE, DMA_DISABLE) */
+#define DMA_HALF_TRANSFER_INT		DMA_DISABLE
+
+#endif
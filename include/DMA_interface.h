@@ -0,0 +1,74 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : DMA1                                    */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef DMA_INTERFACE_H
+#define DMA_INTERFACE_H
+
+/* DMA_Address_t */
+#include "stm32f103C8.h"
+
+/* DMA1 channels */
+#define DMA_CHANNEL1		0
+#define DMA_CHANNEL2		1
+#define DMA_CHANNEL3		2
+#define DMA_CHANNEL4		3
+#define DMA_CHANNEL5		4
+#define DMA_CHANNEL6		5
+#define DMA_CHANNEL7		6
+
+/* NVIC position number of DMA1 channel x interrupt */
+#define DMA_CHANNEL_IRQN(CHANNEL)	(11 + (CHANNEL))
+
+/* Transfer direction */
+#define DMA_PERIPH_TO_MEM	0
+#define DMA_MEM_TO_PERIPH	1
+
+/* Peripheral / memory data size */
+#define DMA_SIZE_8BIT		0
+#define DMA_SIZE_16BIT		1
+#define DMA_SIZE_32BIT		2
+
+/* Increment and circular options */
+#define DMA_DISABLE			0
+#define DMA_ENABLE			1
+
+/* Channel priority */
+#define DMA_PRIORITY_LOW		0
+#define DMA_PRIORITY_MEDIUM		1
+#define DMA_PRIORITY_HIGH		2
+#define DMA_PRIORITY_VERY_HIGH	3
+
+/* Events passed to the channel callback */
+#define DMA_EV_TRANSFER_CMPLT	0
+#define DMA_EV_HALF_TRANSFER	1
+#define DMA_EV_TRANSFER_ERROR	2
+
+typedef struct
+{
+	u8 Direction;		/* DMA_PERIPH_TO_MEM, DMA_MEM_TO_PERIPH */
+	u8 PeriphSize;		/* DMA_SIZE_8BIT, DMA_SIZE_16BIT, DMA_SIZE_32BIT */
+	u8 MemSize;			/* DMA_SIZE_8BIT, DMA_SIZE_16BIT, DMA_SIZE_32BIT */
+	u8 MemIncrement;	/* DMA_ENABLE, DMA_DISABLE */
+	u8 Circular;		/* DMA_ENABLE, DMA_DISABLE */
+	u8 Priority;		/* DMA_PRIORITY_x */
+}DMA_ChannelConfig_t;
+
+/*
+ * The DMA1 clock (RCC_AHB, bit 0) has to be enabled and the channel interrupt
+ * enabled in the NVIC (DMA_CHANNEL_IRQN) for the callbacks to be called.
+ */
+
+u8  DMA_u8ChannelInit     (u8 Copy_u8Channel, const DMA_ChannelConfig_t * Copy_pstrConfig);
+
+u8  DMA_u8StartTransfer   (u8 Copy_u8Channel, DMA_Address_t Copy_PeriphAdd, DMA_Address_t Copy_MemAdd, u16 Copy_u16Count);
+
+void DMA_voidStopTransfer (u8 Copy_u8Channel);
+
+u16 DMA_u16GetRemaining   (u8 Copy_u8Channel);
+
+u8  DMA_u8SetCallBack     (u8 Copy_u8Channel, void (*Copy_pfCallBack)(u8 Copy_u8Event));
+
+#endif
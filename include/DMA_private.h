@@ -0,0 +1,32 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : DMA1                                    */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef DMA_PRIVATE_H
+#define DMA_PRIVATE_H
+
+#define DMA_NUMBER_OF_CHANNELS	7
+
+/* Bit position definitions for DMA_CCRx */
+#define DMA_CCR_MEM2MEM		14
+#define DMA_CCR_PL			12
+#define DMA_CCR_MSIZE		10
+#define DMA_CCR_PSIZE		8
+#define DMA_CCR_MINC		7
+#define DMA_CCR_PINC		6
+#define DMA_CCR_CIRC		5
+#define DMA_CCR_DIR			4
+#define DMA_CCR_TEIE		3
+#define DMA_CCR_HTIE		2
+#define DMA_CCR_TCIE		1
+#define DMA_CCR_EN			0
+
+/* Flags of channel x in DMA_ISR / DMA_IFCR */
+#define DMA_ISR_GIF(CHANNEL)	(4 * (CHANNEL))
+#define DMA_ISR_TCIF(CHANNEL)	(4 * (CHANNEL) + 1)
+#define DMA_ISR_HTIF(CHANNEL)	(4 * (CHANNEL) + 2)
+#define DMA_ISR_TEIF(CHANNEL)	(4 * (CHANNEL) + 3)
+
+#endif
@@ -52,7 +52,8 @@ typedef enum
 	GPT_MODE_NORMAL=0,
 	GPT_MODE_SLEEP,
 	GPT_MODE_PWM,
-	External_Clock_MODE
+	External_Clock_MODE,
+	Input_Capture_MODE
 } Gpt_ModeType;
 
 
@@ -60,7 +61,20 @@ typedef enum
 
 
 
-#define     GPT_CHANNEL_CNT        5
+#define     GPT_CHANNEL_CNT        3
+
+/* Timer values are in channel ticks: the 16-bit counter expires after 2 to 65536 ticks */
+#define     GPT_VALUE_MIN          2
+#define     GPT_VALUE_MAX          0x10000UL
+
+/* NVIC position numbers of the timers interrupts */
+#define     TIM2_IRQN              28
+#define     TIM3_IRQN              29
+#define     TIM4_IRQN              30
+#define     TIM5_IRQN              50
+
+/* NVIC position of the interrupt of a GPT channel */
+#define     GPT_CHANNEL_IRQN(CHANNEL)   (TIM2_IRQN + (CHANNEL))
 
 #define     PWM_edge_aligned_mode_UP      1
 #define     PWM_edge_aligned_mode_DOWN    2
@@ -76,7 +90,7 @@ Gpt_ValueType Gpt_GetTimeElapsed(Gpt_ChannelType channel);
 
 Gpt_ValueType Gpt_GetTimeRemaining( Gpt_ChannelType channel );
 
-void Gpt_StartTimer(Gpt_ChannelType channel, Gpt_ValueType value);
+u8 Gpt_StartTimer(Gpt_ChannelType channel, Gpt_ValueType value);
 
 void Gpt_StopTimer(Gpt_ChannelType channel);
 
@@ -94,4 +108,20 @@ void Gpt_EnableWakeup( Gpt_ChannelType channel );
 
 u16 Gpt_u16GetCounter();
 
+Gpt_ValueType Gpt_u32UsToTicks(Gpt_ChannelType channel, u32 us);
+
+Gpt_ValueType Gpt_u32MsToTicks(Gpt_ChannelType channel, u32 ms);
+
+u32 Gpt_u32TicksToUs(Gpt_ChannelType channel, Gpt_ValueType ticks);
+
+u32 Gpt_u32GetCaptureTime(void);
+
+u32 Gpt_u32GetCapturePeriod(void);
+
+u32 Gpt_u32GetLastCaptureTime(void);
+
+u32 Gpt_u32GetCaptureEdgeCount(void);
+
+void Gpt_SetCaptureNotification(void (*notification)(void));
+
 #endif /*GPT_H_*/
@@ -12,13 +12,33 @@
 #define GPT_CONFIG_H_
 
 
-#define CHANNEL_NUM2   2
+/* Channel ids: one channel per general purpose timer. In this application TIM2
+   is the hall input capture and TIM3 / TIM4 belong to the PWM driver */
+#define GPT_CHANNEL_TIM2       0
 
-#define CHANNEL_NUM3   3
+#define GPT_CHANNEL_TIM3       1
 
-#define CHANNEL_NUM4   4
+#define GPT_CHANNEL_TIM4       2
 
-#define CHANNEL_NUM5   5
+/* Ends the channel list given to Gpt_Init */
+#define GPT_CHANNEL_ILL        0xFF
+
+/* Channels whose timer another driver owns (bit per channel id): Gpt_Init skips them and the
+   other services leave them alone, Gpt_StartTimer returns STD_TYPES_NOK. TIM2 is also left alone
+   while the input capture runs on it, so this application has no free GPT channel: take a timer
+   out of this mask (and away from the PWM driver) before giving GPT a channel to run */
+#define GPT_RESERVED_CHANNELS  ((1UL << GPT_CHANNEL_TIM3) | (1UL << GPT_CHANNEL_TIM4))
+
+
+/* Timers input clock (APB1 timer clock) */
+#define GPT_TIMER_CLK_HZ       8000000
+
+#define GPT_TIMER_CLK_MHZ      (GPT_TIMER_CLK_HZ / 1000000)
+
+/* Input capture time base: one count every GPT_CAPTURE_TICK_US */
+#define GPT_CAPTURE_TICK_US    1
+
+#define GPT_CAPTURE_PRESCALE   ((GPT_TIMER_CLK_HZ / 1000000) * GPT_CAPTURE_TICK_US - 1)
 
 
 
@@ -26,7 +46,7 @@
 typedef u8 Gpt_ChannelType;
 
 
-/* Channel behavior */
+/* Channel behavior: one-shot channels stop at the first expiry, continuous ones reload */
 typedef enum
 {
 	GPT_MODE_ONESHOT=0,
@@ -35,11 +55,14 @@ typedef enum
 
 
 
+/* One entry per used channel, the list ends with GptChannelId = GPT_CHANNEL_ILL.
+   A channel ticks at GPT_TIMER_CLK_HZ / (GptChannelPrescale + 1), the NVIC
+   priority is applied by the application along with the TIMx interrupt enable */
 typedef struct  {
 	u32 GptChannelClkSrc;
 	 Gpt_ChannelType GptChannelId;
 	Gpt_ChannelMode GptChannelMode;
-	void (*GptNotification)();
+	void (*GptNotification)(void);
 	u8 GptNotificationPriority;
 	u32 GptChannelPrescale;
 
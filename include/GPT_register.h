@@ -11,42 +11,38 @@
 
 
 
-typedef struct{
+#include "stm32f103C8.h"
 
-	volatile u32 CR1;
-	volatile u32 CR2;
-	volatile u32 SMCR;
-	volatile u32 DIER;
-	volatile u32 SR;
-	volatile u32 EGR;
-	volatile u32 CCMR1;
-	volatile u32 CCMR2;
-	volatile u32 CCER;
-	volatile u32 CNT;
-	volatile u32 PSC;	
-	volatile u32 ARR;
-	volatile u32 reserved;
-	volatile u32 CCR1;
-	volatile u32 CCR2;
-	volatile u32 CCR3;
-	volatile u32 CCR4;
-	volatile u32 DCR;
-	volatile u32 DMAR;
-}TIM_t;
+/* TIMx register blocks of stm32f103C8.h */
+#define TIM2  TIMER2
 
+#define TIM3  TIMER3
 
+#define TIM4  TIMER4
 
+#define TIM5  TIMER5
 
-#define TIM2  ((volatile TIM_t*)0x40000000)
 
-#define TIM3  ((volatile TIM_t*)0x40000400)
+/* CR1 bits */
+#define TIM_CR1_CEN		(1 << 0)
+#define TIM_CR1_UDIS	(1 << 1)
+#define TIM_CR1_URS		(1 << 2)
+#define TIM_CR1_OPM		(1 << 3)
+#define TIM_CR1_DIR		(1 << 4)
 
-#define TIM4  ((volatile TIM_t*)0x40000800)
-
-#define TIM5  ((volatile TIM_t*)0x40000C00)
+/* DIER bits */
+#define TIM_DIER_UIE	(1 << 0)
+#define TIM_DIER_CC1IE	(1 << 1)
 
+/* SR bits */
+#define TIM_SR_UIF		(1 << 0)
+#define TIM_SR_CC1IF	(1 << 1)
 
+/* EGR bits */
+#define TIM_EGR_UG		(1 << 0)
 
+/* CCER bits */
+#define TIM_CCER_CC1E	(1 << 0)
 
 
 
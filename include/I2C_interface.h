@@ -48,6 +48,60 @@
 #define I2C_RECEIVE			1
 #define I2C_TRANSMIT		0
 
+/*
+ * NVIC position numbers of the I2C interrupts
+ */
+#define I2C1_EV_IRQN		31
+#define I2C1_ER_IRQN		32
+#define I2C2_EV_IRQN		33
+#define I2C2_ER_IRQN		34
+
+/*
+ * Transaction engine states
+ */
+#define I2C_STATE_READY		0
+#define I2C_STATE_BUSY_TX	1
+#define I2C_STATE_BUSY_RX	2
+
+/*
+ * Application events passed to the transaction callback
+ */
+#define I2C_EV_CMPLT		0
+#define I2C_ERROR_BERR		1
+#define I2C_ERROR_ARLO		2
+#define I2C_ERROR_AF		3
+#define I2C_ERROR_OVR		4
+#define I2C_ERROR_TIMEOUT	5
+#define I2C_EV_ABORTED		6
+#define I2C_ERROR_DMA		7
+
+/*
+ * Transaction data transfer modes
+ */
+#define I2C_MODE_INTERRUPT	0	/* Every byte is moved by the event ISR */
+#define I2C_MODE_DMA		1	/* Data bytes are moved by DMA1 (single byte receptions fall back to the ISR) */
+
+/*
+ * I2C_Transaction_t: Describes one master transaction for the interrupt driven engine.
+ * 		The TxLen bytes of pTxBuffer are written first, then (if RxLen != 0) a repeated start is generated
+ * 		and RxLen bytes are read into pRxBuffer. Buffers must stay valid until the callback is called.
+ * 		SlaveAdd: (u8) 7-bit address of the slave.
+ * 		RepeatedState: (u8) I2C_NO_REPEAT_S to end with a stop condition, I2C_REPEAT_S to keep the bus (write only transactions).
+ * 		TransferMode: (u8) I2C_MODE_INTERRUPT or I2C_MODE_DMA, the DMA1 channel interrupts of I2Cx must be enabled in the NVIC for DMA mode.
+ * 		pfCallBack: called from interrupt context with I2C_EV_CMPLT or one of the I2C_ERROR_x events (may be NULL).
+ */
+typedef struct
+{
+	u8 SlaveAdd;
+	u8 * pTxBuffer;
+	u8 TxLen;
+	u8 * pRxBuffer;
+	u8 RxLen;
+	u8 RepeatedState;
+	u8 TransferMode;
+	void (*pfCallBack)(u8 I2Cx, u8 AppEv);
+}I2C_Transaction_t;
+
 /********************************************************/
 /*					API prototypes						*/
 /********************************************************/
@@ -88,6 +142,29 @@ void I2C_voidMasterSendData(u8 I2Cx, u8 * pTxBuffer, u8 Len, u8 SlaveAdd, u8 Rep
  */
 void I2C_voidMasterReceiveData(u8 I2Cx, u8 * pTxBuffer, u8 Len, u8 SlaveAdd);
 
+/*
+ * I2C_u8SubmitTransaction: Starts a non-blocking master transaction driven by the event/error interrupts.
+ * 		The I2Cx event and error interrupts must be enabled in the NVIC (I2Cx_EV_IRQN, I2Cx_ER_IRQN).
+ * Parameters:  I2Cx: (u8) The I2C name macro Values: I2C1, I2C2.
+ * 				pTransaction: (pointer to I2C_Transaction_t) The transaction to execute, it is copied by the driver.
+ * Return type: u8 STD_TYPES_OK if the transaction was started, STD_TYPES_NOK if the engine is busy or the parameters are invalid.
+ */
+u8 I2C_u8SubmitTransaction(u8 I2Cx, const I2C_Transaction_t * pTransaction);
+
+/*
+ * I2C_u8GetState: Returns the state of the transaction engine.
+ * Parameters:  I2Cx: (u8) The I2C name macro Values: I2C1, I2C2.
+ * Return type: u8 I2C_STATE_READY, I2C_STATE_BUSY_TX or I2C_STATE_BUSY_RX.
+ */
+u8 I2C_u8GetState(u8 I2Cx);
+
+/*
+ * I2C_voidAbortTransaction: Stops the running transaction, releases the bus and calls its callback with I2C_EV_ABORTED.
+ * Parameters:  I2Cx: (u8) The I2C name macro Values: I2C1, I2C2.
+ * Return type: void.
+ */
+void I2C_voidAbortTransaction(u8 I2Cx);
+
 /*
  * Application callback
  */
@@ -41,6 +41,7 @@
  * Bit position definitions for I2C_CR1
  */
 #define I2C_CR1_SWRST		15
+#define I2C_CR1_POS			11
 #define I2C_CR1_ACK			10
 #define I2C_CR1_STOP		9
 #define I2C_CR1_START		8
@@ -50,6 +51,11 @@
 /*
  * Bit position definitions for I2C_CR2
  */
+#define I2C_CR2_LAST		12
+#define I2C_CR2_DMAEN		11
+#define I2C_CR2_ITBUFEN		10
+#define I2C_CR2_ITEVTEN		9
+#define I2C_CR2_ITERREN		8
 #define I2C_CR2_FREQ		0
 
 /*
@@ -61,6 +67,11 @@
 /*
  * Bit position definitions for I2C_SR1
  */
+#define I2C_SR1_TIMEOUT		14
+#define I2C_SR1_OVR			11
+#define I2C_SR1_AF			10
+#define I2C_SR1_ARLO		9
+#define I2C_SR1_BERR		8
 #define I2C_SR1_TXE			7
 #define I2C_SR1_RXNE		6
 #define I2C_SR1_BTF			2
@@ -83,6 +94,43 @@
 #define I2C_CCR_DUTY		14
 
 
+/*
+ * Number of I2C peripherals handled by the transaction engine (I2C1, I2C2)
+ */
+#define I2C_NUMBER_OF_PERIPHERALS	2
+
+/*
+ * I2C_HANDLE_INDEX: Maps I2C1/I2C2 name macros to an index in the handles array
+ */
+#define I2C_HANDLE_INDEX(I2Cx)		((I2Cx) - I2C1)
+
+/*
+ * DMA1 channels hardwired to the I2C requests
+ */
+#define I2C1_TX_DMA_CHANNEL			DMA_CHANNEL6
+#define I2C1_RX_DMA_CHANNEL			DMA_CHANNEL7
+#define I2C2_TX_DMA_CHANNEL			DMA_CHANNEL4
+#define I2C2_RX_DMA_CHANNEL			DMA_CHANNEL5
+
+/*
+ * Transaction engine handle: the submitted transaction plus its progress
+ */
+typedef struct
+{
+	I2C_Transaction_t Transaction;	/* Copy of the submitted transaction */
+	u8 State;						/* I2C_STATE_READY, I2C_STATE_BUSY_TX, I2C_STATE_BUSY_RX */
+	u8 TxCount;						/* Bytes already written to DR */
+	u8 RxCount;						/* Bytes already read from DR */
+	u8 TxDmaChannel;				/* DMA1 channel of the I2Cx TX request */
+	u8 RxDmaChannel;				/* DMA1 channel of the I2Cx RX request */
+}I2C_Handle_t;
+
+/*
+ * I2C_DMA_PHASE: True when the bytes of the current phase are moved by DMA (single byte receptions use the ISR)
+ */
+#define I2C_DMA_PHASE(pHandle)	(((pHandle)->Transaction.TransferMode == I2C_MODE_DMA) && \
+								 (((pHandle)->State == I2C_STATE_BUSY_TX) || ((pHandle)->Transaction.RxLen > 1)))
+
 /*
  * Private functions
  */
@@ -99,6 +147,15 @@
 /* I2C_VOID_ENABLE_ACK: Enables Auto ACKing for I2Cx peripheral */
 #define	I2C_VOID_ENABLE_ACK(pI2Cx)	(SET_BIT(pI2Cx->CR1, I2C_CR1_ACK));
 
+/* I2C_VOID_CLEAR_ADDR: Clears ADDR by reading SR1 followed by SR2 */
+#define	I2C_VOID_CLEAR_ADDR(pI2Cx)	do{ (void)pI2Cx->SR1; (void)pI2Cx->SR2; }while(0)
+
+/* Event, buffer and error interrupt enable bits of CR2 */
+#define I2C_CR2_IT_MASK		((1 << I2C_CR2_ITEVTEN) | (1 << I2C_CR2_ITBUFEN) | (1 << I2C_CR2_ITERREN))
+
+/* DMA request enable bits of CR2 */
+#define I2C_CR2_DMA_MASK	((1 << I2C_CR2_DMAEN) | (1 << I2C_CR2_LAST))
+
 
 
 
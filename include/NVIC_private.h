@@ -0,0 +1,12 @@
+#ifndef NVIC_PRIVATE_H
+#define NVIC_PRIVATE_H
+
+/* ISER / ICER / ISPR / ICPR are write-one-to-set / clear, the other bits are not touched */
+#ifdef HOST_SIM
+/* the simulated NVIC is plain memory: the writes accumulate and the SIM module applies them */
+#define NVIC_WRITE_ONE_TO_SET(REG, VALUE)	((REG) |= (VALUE))
+#else
+#define NVIC_WRITE_ONE_TO_SET(REG, VALUE)	((REG) = (VALUE))
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : PROF (DWT cycle counter profiling)      */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _PROF_CONFIG_H
+#define _PROF_CONFIG_H
+
+/* Profiling zones are compiled in unless the build is a release one (NDEBUG),
+ * -DPROF_ENABLE=0 / 1 overrides this */
+#ifndef PROF_ENABLE
+#ifdef NDEBUG
+#define PROF_ENABLE					0
+#else
+#define PROF_ENABLE					1
+#endif
+#endif
+
+/* Zones, one slot each in PROF_Zones */
+#define PROF_ZONE_ACC				0		/* ACC() control law */
+#define PROF_ZONE_HALL_GET_SPEED	1		/* HALL_GetSpeed() */
+#define PROF_ZONE_I2C1_TRANSACTION	2		/* submit to close of an I2C1 transaction (bus time included) */
+#define PROF_ZONE_I2C2_TRANSACTION	3		/* same on I2C2 */
+#define PROF_ZONE_PORT_INIT			4		/* Port_Init() */
+
+/* Benchmark zones, only filled by BENCH_Run (bench_config.h), one call per measurement */
+#define PROF_ZONE_BENCH_BASELINE	5		/* empty zone, cost of the markers themselves */
+#define PROF_ZONE_BENCH_DIO_READ	6		/* Dio_ReadChannel() */
+#define PROF_ZONE_BENCH_DIO_WRITE	7		/* Dio_WriteChannel() */
+#define PROF_ZONE_BENCH_PORT_INIT	8		/* Port_Init() */
+#define PROF_ZONE_BENCH_PWM_DUTY	9		/* MPWM_SetDutyCycle() */
+#define PROF_ZONE_BENCH_HALL_SPEED	10		/* HALL_GetSpeed() */
+#define PROF_ZONE_BENCH_REQ_DISTANCE	11	/* getRequiredDistance() */
+#define PROF_ZONE_BENCH_REQ_SPEED	12		/* getRequiredSpeed() */
+#define PROF_ZONE_BENCH_ACC			13		/* one full ACC() iteration */
+#define PROF_ZONE_BENCH_DIO_WRITE_INLINE	14	/* Dio_WriteChannelInline() on a constant channel */
+#define PROF_ZONE_BENCH_TRACKER		15		/* TRACKER_u8Update() on a closing gap */
+
+#define PROF_ZONE_COUNT				16
+
+#endif
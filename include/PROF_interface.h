@@ -0,0 +1,60 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : PROF (DWT cycle counter profiling)      */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _PROF_INTERFACE_H
+#define _PROF_INTERFACE_H
+
+#include "STD_TYPES.h"
+#include "PROF_config.h"
+
+/* One zone: cycles between PROF_BEGIN and PROF_END, interrupts taken inside the zone included */
+typedef struct
+{
+	u32 Start;			/* CYCCNT at the last PROF_BEGIN */
+	u32 Count;			/* completed measurements */
+	u32 Min;
+	u32 Max;
+	u64 Total;			/* sum of all measurements, Total / Count is the mean */
+} PROF_Zone_t;
+
+/* Summary of one zone */
+typedef struct
+{
+	u32 Count;
+	u32 Min;
+	u32 Max;
+	u32 Mean;
+} PROF_Stats_t;
+
+/* Zone table, readable from a debugger (PROF_Zones[PROF_ZONE_x]) */
+extern PROF_Zone_t PROF_Zones[PROF_ZONE_COUNT];
+
+/* Zone markers, compiled out when PROF_ENABLE is 0 */
+#if PROF_ENABLE
+#define PROF_BEGIN(ZONE)			PROF_voidBegin(ZONE)
+#define PROF_END(ZONE)				PROF_voidEnd(ZONE)
+#else
+#define PROF_BEGIN(ZONE)			((void)0)
+#define PROF_END(ZONE)				((void)0)
+#endif
+
+/* Starts the DWT cycle counter and clears the zone table */
+void PROF_voidInit(void);
+
+/* Clears the zone table */
+void PROF_voidReset(void);
+
+void PROF_voidBegin(u8 Copy_u8Zone);
+
+void PROF_voidEnd(u8 Copy_u8Zone);
+
+/* Takes a fixed cost (the markers themselves) off every measurement of a zone, saturating at 0 */
+void PROF_voidSubtract(u8 Copy_u8Zone, u32 Copy_u32Cycles);
+
+/* Copies the summary of a zone, returns STD_TYPES_NOK for an unknown or never measured zone */
+u8 PROF_u8GetStats(u8 Copy_u8Zone, PROF_Stats_t * Copy_pStats);
+
+#endif
@@ -0,0 +1,20 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : PROF (DWT cycle counter profiling)      */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _PROF_PRIVATE_H
+#define _PROF_PRIVATE_H
+
+#define PROF_DEMCR_TRCENA_BIT		24		/* Enables the DWT and ITM units */
+#define PROF_DWT_CYCCNTENA_BIT		0		/* Enables the cycle counter */
+
+/* Cycle counter: DWT CYCCNT on the target, the virtual counter of the SIM module on the host */
+#ifdef HOST_SIM
+#define PROF_CYCLES()				SIM_u32GetCycleCount()
+#else
+#define PROF_CYCLES()				(DWT->CYCCNT)
+#endif
+
+#endif
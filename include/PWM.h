@@ -9,7 +9,7 @@
 #define PWM_H_
 
 
-#include "STM32F103C8.h"
+#include "stm32f103C8.h"
 #include "PWM_Cfg.h"
 
 
@@ -36,11 +36,53 @@
 #define Mode2  1
 /***************************************************************************/
 
-/* Number Of Channel */
-#define  MPWM_Channel_1  1
-#define  MPWM_Channel_2  2
-#define  MPWM_Channel_3  3
-#define  MPWM_Channel_4  4
+/* Channel Identifiers: TIM2, TIM3 and TIM4, four channels each */
+#define  MPWM_TIM2_CH1   0
+#define  MPWM_TIM2_CH2   1
+#define  MPWM_TIM2_CH3   2
+#define  MPWM_TIM2_CH4   3
+#define  MPWM_TIM3_CH1   4
+#define  MPWM_TIM3_CH2   5
+#define  MPWM_TIM3_CH3   6
+#define  MPWM_TIM3_CH4   7
+#define  MPWM_TIM4_CH1   8
+#define  MPWM_TIM4_CH2   9
+#define  MPWM_TIM4_CH3   10
+#define  MPWM_TIM4_CH4   11
+#define  MPWM_TIM1_CH1   12   /* TIM1: complementary CHx / CHxN outputs, dead-time and BKIN break */
+#define  MPWM_TIM1_CH2   13
+#define  MPWM_TIM1_CH3   14
+#define  MPWM_TIM1_CH4   15   /* no complementary output */
+
+#define  MPWM_CHANNELS_PER_TIMER  4
+#define  MPWM_TIMER_COUNT         4
+#define  MPWM_CHANNEL_COUNT       (MPWM_CHANNELS_PER_TIMER * MPWM_TIMER_COUNT)
+
+/* Number Of Channel (TIMER3) */
+#define  MPWM_Channel_1  MPWM_TIM3_CH1
+#define  MPWM_Channel_2  MPWM_TIM3_CH2
+#define  MPWM_Channel_3  MPWM_TIM3_CH3
+#define  MPWM_Channel_4  MPWM_TIM3_CH4
+/***************************************************************************/
+
+/* TIM1 break input (BKIN) */
+#define MPWM_BREAK_DISABLED    0
+#define MPWM_BREAK_ACTIVE_LOW  1
+#define MPWM_BREAK_ACTIVE_HIGH 2
+
+/* TIM1 outputs state */
+#define MPWM_BREAK_CLEARED     0   /* outputs driven by the PWM */
+#define MPWM_BREAK_ACTIVE      1   /* outputs forced to their idle (off) level by a break */
+/***************************************************************************/
+
+/* Duty ramp profiles */
+#define MPWM_RAMP_LINEAR       0   /* constant duty step per period */
+#define MPWM_RAMP_S_CURVE      1   /* smoothstep 3x^2 - 2x^3: no duty step at both ends */
+/***************************************************************************/
+
+/* Commit of a multi-channel duty update */
+#define MPWM_SYNC_NEXT_PERIOD  0   /* at the next counter overflow, the running period is kept */
+#define MPWM_SYNC_IMMEDIATE    1   /* at once with UG, the running period restarts */
 /***************************************************************************/
 
 /* Prescaler Value */
@@ -77,6 +119,18 @@ typedef struct ConfigType
 }MPWM_ConfigType;
 /*********************************************************************/
 
+/* One channel of a synchronized duty update. */
+typedef struct DutyUpdateType
+{
+	MPWM_ChannelType     Channel;
+	MPWM_DutyCycleType   DutyCycle;
+}MPWM_DutyUpdateType;
+/*********************************************************************/
+
+/* Called from the DMA interrupt once the last duty of a ramp is written. */
+typedef void (*MPWM_RampNotificationType)(MPWM_ChannelType Channel);
+/*********************************************************************/
+
 // Defines the class of a PWM channel.
 typedef enum ChannelClassType
 {
@@ -129,6 +183,53 @@ void MPWM_Init(const MPWM_ConfigType* ConfigPtr);
 /****************************************************************************/
 void MPWM_SetDutyCycle(MPWM_ChannelType ChannelNumber,MPWM_DutyCycleType DutyCycle);
 
+/* Service name      : MPWM_SetDutyCycles
+   Syntax            : void MPWM_SetDutyCycles(const MPWM_DutyUpdateType* Updates,u8 Count).
+   Sync/Async        : Synchronous.
+   Reentrancy        : Non Reentrant.
+   Parameters (in)   : Updates       ------> Channels and duty cycles, on any timers.
+                       Count         ------> Number of updates.
+   Parameters(inout) : None.
+   Parameters (out)  : None.
+   Return value      : None.
+   Description       : Service sets the duty cycles of several channels, the outputs of a timer
+                       switch to the new set together at one update event (MPWM_Sync_Update). */
+/**********************************************************************************************/
+void MPWM_SetDutyCycles(const MPWM_DutyUpdateType* Updates,u8 Count);
+
+/* Service name      : MPWM_u8StartRamp
+   Syntax            : u8 MPWM_u8StartRamp(MPWM_ChannelType ChannelNumber,MPWM_DutyCycleType DutyCycle,u16 Periods,u8 Profile,MPWM_RampNotificationType Notification).
+   Sync/Async        : Asynchronous.
+   Reentrancy        : Non Reentrant.
+   Parameters (in)   : ChannelNumber ------> TIMER3 channel (MPWM_Channel_1..4).
+                       DutyCycle     ------> Duty cycle at the end of the ramp.
+                       Periods       ------> Ramp length in PWM periods, 1..MPWM_Ramp_Max_Periods.
+                       Profile       ------> MPWM_RAMP_LINEAR, MPWM_RAMP_S_CURVE.
+                       Notification  ------> Called at the end of the ramp, may be NULL.
+   Parameters(inout) : None.
+   Parameters (out)  : None.
+   Return value      : STD_TYPES_OK, STD_TYPES_NOK for a bad channel, length or profile.
+   Description       : Service precomputes the duty of every period from the current duty and
+                       streams it into CCRx with the TIM3 update DMA request, no CPU per period.
+                       A running ramp is replaced, MPWM_GetDutyCycle follows the progress and a
+                       duty written to the channel by the other services cancels the ramp. The DMA
+                       interrupt (DMA_CHANNEL_IRQN(MPWM_Ramp_Dma_Channel)) has to be enabled. */
+/**********************************************************************************************/
+u8 MPWM_u8StartRamp(MPWM_ChannelType ChannelNumber,MPWM_DutyCycleType DutyCycle,u16 Periods,u8 Profile,MPWM_RampNotificationType Notification);
+
+/* Service name      : MPWM_StopRamp
+   Syntax            : void MPWM_StopRamp(void).
+   Sync/Async        : Synchronous.
+   Reentrancy        : Non Reentrant.
+   Parameters (in)   : None.
+   Parameters(inout) : None.
+   Parameters (out)  : None.
+   Return value      : None.
+   Description       : Service stops a running ramp, the channel keeps the duty reached so far
+                       and the notification is not called. */
+/**********************************************************************************************/
+void MPWM_StopRamp(void);
+
 /* Service name      : MPWM_SetPeriodAndDuty
    Syntax            : void MPwm_SetPeriodAndDuty(PWM_ChannelType ChannelNumber,PWM_PeriodType Period,u16 DutyCycle).
    Sync/Async        : Synchronous.
@@ -142,6 +243,44 @@ void MPWM_SetDutyCycle(MPWM_ChannelType ChannelNumber,MPWM_DutyCycleType DutyCyc
 /**********************************************************************************************/
 void MPWM_SetPeriodAndDuty(MPWM_ChannelType ChannelNumber,MPWM_PeriodType Period,MPWM_DutyCycleType DutyCycle);
 
+/* Service name      : MPWM_GenerateBreak
+   Syntax            : void MPWM_GenerateBreak(void).
+   Sync/Async        : Synchronous.
+   Reentrancy        : Reentrant.
+   Parameters (in)   : None.
+   Parameters(inout) : None.
+   Parameters (out)  : None.
+   Return value      : None.
+   Description       : Service cuts the TIM1 outputs through the hardware break path, as BKIN
+                       does: every output goes to its idle (off) level after the dead-time. */
+/**********************************************************************************************/
+void MPWM_GenerateBreak(void);
+
+/* Service name      : MPWM_u8GetBreakState
+   Syntax            : u8 MPWM_u8GetBreakState(void).
+   Sync/Async        : Synchronous.
+   Reentrancy        : Reentrant.
+   Parameters (in)   : None.
+   Parameters(inout) : None.
+   Parameters (out)  : None.
+   Return value      : MPWM_BREAK_ACTIVE once a break cut the TIM1 outputs, MPWM_BREAK_CLEARED.
+   Description       : Service reads the TIM1 main output enable. */
+/**********************************************************************************************/
+u8 MPWM_u8GetBreakState(void);
+
+/* Service name      : MPWM_ClearBreak
+   Syntax            : void MPWM_ClearBreak(void).
+   Sync/Async        : Synchronous.
+   Reentrancy        : Non Reentrant.
+   Parameters (in)   : None.
+   Parameters(inout) : None.
+   Parameters (out)  : None.
+   Return value      : None.
+   Description       : Service re-enables the TIM1 outputs after a break. It has no effect while
+                       BKIN is still at its active level, the break is latched until then. */
+/**********************************************************************************************/
+void MPWM_ClearBreak(void);
+
 /* Service name      : MPWM_SetOutputToIdle
    Syntax            : void MPwm_SetOutputToIdle(PWM_ChannelType ChannelNumber).
    Sync/Async        : Synchronous.
@@ -152,7 +291,9 @@ void MPWM_SetPeriodAndDuty(MPWM_ChannelType ChannelNumber,MPWM_PeriodType Period
    Parameters(inout) : None.
    Parameters (out)  : None.
    Return value      : None.
-   Description       : Service sets the PWM output to the configured Idle state. */
+   Description       : Service sets the PWM output to the configured Idle state: the ramp of the channel
+                       is cancelled, the counter stopped and the output disabled (CCxE, and CCxNE on
+                       TIM1 CH1..CH3, cleared). MPWM_Init enables it again. */
 /**********************************************************************************************/
 void MPWM_SetOutputToIdle(MPWM_ChannelType ChannelNumber);
 
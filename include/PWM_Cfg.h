@@ -22,6 +22,18 @@
 
 #define MPWM_Polarity            Active_High
 
+#define MPWM_Sync_Update         MPWM_SYNC_NEXT_PERIOD
+
+/* TIM1 motor drive: dead-time inserted between CHx and CHxN, break input polarity */
+#define MPWM_Tim1_Dead_Time_Ns   500
+
+#define MPWM_Tim1_Break          MPWM_BREAK_ACTIVE_LOW
+
+/* Duty ramps: DMA1 channel of the TIM3_UP request and the longest ramp in PWM periods */
+#define MPWM_Ramp_Dma_Channel    DMA_CHANNEL3
+
+#define MPWM_Ramp_Max_Periods    64
+
 
 
 
@@ -0,0 +1,85 @@
+/*Header File Guard*/
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "STD_TYPES.h"
+
+/*lock-free single producer / single consumer ring of timestamped samples*/
+/*the producer (usually an ISR) only writes Head and Dropped, the consumer (a task) only writes Tail,*/
+/*so neither side has to disable interrupts*/
+
+/*one sample: when it was taken, its value and who produced it (sonar index, speed method ...)*/
+typedef struct
+{
+	u32 TimeStamp;
+	u32 Value;
+	u8 Source;
+} RING_Sample_t;
+
+typedef struct
+{
+	volatile u32 Head;		/*free running count of pushed samples, producer side*/
+	volatile u32 Tail;		/*free running count of popped samples, consumer side*/
+	u32 Mask;				/*size - 1, the size is a power of two*/
+	volatile u32 Dropped;	/*samples lost because the ring was full, producer side*/
+	RING_Sample_t *pBuffer;
+} RING_Buffer_t;
+
+/*orders the sample accesses against the index update, a compiler barrier alone is not enough once*/
+/*the sample could sit in the write buffer when the other side sees the new index*/
+#if defined(__arm__)
+#define RING_BARRIER() __asm volatile("dmb" ::: "memory")
+#else
+#define RING_BARRIER() __sync_synchronize()
+#endif
+
+/*defines a ring and its storage, Size must be a power of two (checked at compile time)*/
+#define RING_DEFINE(Name, Size)                                                            \
+	typedef char Name##_SizeIsPowerOfTwo[(((Size) > 1) && (((Size) & ((Size) - 1)) == 0)) ? 1 : -1]; \
+	static RING_Sample_t Name##_Storage[(Size)];                                          \
+	static RING_Buffer_t Name = {0, 0, (Size) - 1, 0, Name##_Storage}
+
+/*producer side: copies one sample in, returns STD_TYPES_NOK (and counts a drop) if the ring is full*/
+static inline u8 RING_u8Push(RING_Buffer_t *Copy_pRing, const RING_Sample_t *Copy_pSample)
+{
+	u32 LOC_u32Head = Copy_pRing->Head;
+
+	if ((LOC_u32Head - Copy_pRing->Tail) > Copy_pRing->Mask)
+	{
+		Copy_pRing->Dropped++;
+		return STD_TYPES_NOK;
+	}
+	Copy_pRing->pBuffer[LOC_u32Head & Copy_pRing->Mask] = *Copy_pSample;
+	/*the sample must be in memory before the consumer sees the new head*/
+	RING_BARRIER();
+	Copy_pRing->Head = LOC_u32Head + 1;
+
+	return STD_TYPES_OK;
+}
+
+/*consumer side: copies the oldest sample out, returns STD_TYPES_NOK if the ring is empty*/
+static inline u8 RING_u8Pop(RING_Buffer_t *Copy_pRing, RING_Sample_t *Copy_pSample)
+{
+	u32 LOC_u32Tail = Copy_pRing->Tail;
+
+	if (LOC_u32Tail == Copy_pRing->Head)
+	{
+		return STD_TYPES_NOK;
+	}
+	/*the sample is read only after the head that published it*/
+	RING_BARRIER();
+	*Copy_pSample = Copy_pRing->pBuffer[LOC_u32Tail & Copy_pRing->Mask];
+	/*and before its slot is handed back to the producer*/
+	RING_BARRIER();
+	Copy_pRing->Tail = LOC_u32Tail + 1;
+
+	return STD_TYPES_OK;
+}
+
+/*number of samples waiting, exact for the consumer and a lower bound for anyone else*/
+static inline u32 RING_u32Count(const RING_Buffer_t *Copy_pRing)
+{
+	return Copy_pRing->Head - Copy_pRing->Tail;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SCH (time-triggered scheduler)          */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SCH_CONFIG_H
+#define _SCH_CONFIG_H
+
+/* Scheduler tick in milliseconds (SysTick period) */
+#define SCH_TICK_MS					1
+
+/* Idle mode when no task is due
+ * Available options:-
+ * 						SCH_IDLE_BUSY
+ * 						SCH_IDLE_WFI
+ * 						SCH_IDLE_TICKLESS	*/
+#ifndef SCH_IDLE_MODE
+#define SCH_IDLE_MODE				SCH_IDLE_TICKLESS
+#endif
+
+/* Tickless sleeps shorter than this many ticks keep the periodic tick (plain WFI) */
+#define SCH_TICKLESS_MIN_TICKS		2
+
+/* Idle versus active time measurement (SCH_voidGetLoad): 1 enabled, 0 disabled */
+#ifndef SCH_IDLE_MEASURE
+#define SCH_IDLE_MEASURE			1
+#endif
+
+/* Number of entries of the task table in SCH_Lcfg.c */
+#define SCH_NUMBER_OF_TASKS			5
+
+/* Task ids, index in the task table (the order is the priority inside one tick),
+   the software timers go first so that the other tasks see the expiries of their tick */
+#define SCH_TASK_TIMERS				0
+#define SCH_TASK_SONAR				1
+#define SCH_TASK_SPEED				2
+#define SCH_TASK_ACC				3
+#define SCH_TASK_TELEMETRY			4
+
+#endif
@@ -0,0 +1,59 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SCH (time-triggered scheduler)          */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SCH_INTERFACE_H
+#define _SCH_INTERFACE_H
+
+/* Idle modes of SCH_IDLE_MODE (SCH_config.h) */
+#define SCH_IDLE_BUSY				0		/* Spin in the dispatch loop */
+#define SCH_IDLE_WFI				1		/* Sleep until the next interrupt, SysTick keeps its period */
+#define SCH_IDLE_TICKLESS			2		/* SysTick reprogrammed to the next release, then sleep */
+
+/* Static description of one periodic task (see SCH_Lcfg.c) */
+typedef struct
+{
+	void (*pfTask)(void);		/* Task body, runs to completion in the main loop */
+	u32 Period;					/* Release period in scheduler ticks */
+	u32 Offset;					/* Tick of the first release, used to spread the tasks */
+}SCH_Task_t;
+
+/* Run time statistics of one task */
+typedef struct
+{
+	u32 NextRelease;			/* Tick of the next release */
+	u32 RunCount;				/* Number of executions */
+	u32 OverrunCount;			/* Releases missed because the task (or the ones before it) ran too long */
+	u32 MaxLateness;			/* Worst delay between release and start in ticks (jitter bound) */
+	u32 LastExecTimeUs;			/* Execution time of the last run */
+	u32 WcetUs;					/* Worst observed execution time */
+}SCH_TaskStats_t;
+
+/* Idle and active time of the measurement window (SCH_IDLE_MEASURE) */
+typedef struct
+{
+	u32 IdleUs;					/* Time spent in the idle mode, no task due */
+	u32 ActiveUs;				/* Time spent running tasks and interrupts */
+}SCH_Load_t;
+
+void SCH_voidInit                       ( void                );
+
+void SCH_voidTick                       ( void                );
+
+void SCH_voidDispatch                   ( void                );
+
+u32 SCH_u32GetTickCount                 ( void                );
+
+u32 SCH_u32GetTimeUs                    ( void                );
+
+const SCH_TaskStats_t * SCH_pGetTaskStats ( u8 Copy_u8TaskId  );
+
+void SCH_voidDeferTask                  ( u8 Copy_u8TaskId, u32 Copy_u32Tick );
+
+void SCH_voidAdvanceTask                ( u8 Copy_u8TaskId, u32 Copy_u32Tick );
+
+void SCH_voidGetLoad                    ( SCH_Load_t * Copy_pLoad );
+
+#endif
@@ -0,0 +1,45 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SCH (time-triggered scheduler)          */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SCH_PRIVATE_H
+#define _SCH_PRIVATE_H
+
+/* SysTick input clock, from the STK configuration */
+#if   (MSTK_CLKSOURCE == MSTK_CLKSOURCE_AHB_8)
+	#define SCH_STK_CLK				(MSTK_AHB_CLK/8)
+#elif (MSTK_CLKSOURCE == MSTK_CLKSOURCE_AHB)
+	#define SCH_STK_CLK				(MSTK_AHB_CLK)
+#endif
+
+/* SysTick counts in one scheduler tick */
+#define SCH_COUNTS_PER_TICK			((SCH_STK_CLK / 1000) * SCH_TICK_MS)
+
+/* Longest tickless sleep, SysTick is a 24-bit down counter */
+#define SCH_STK_MAX_LOAD			0x00FFFFFFUL
+
+/* Called when a dispatch pass released no task: the host build advances its virtual time there,
+   WFI returns once an interrupt handler ran and the interrupt mask is only a target concern.
+   After each task the host build turns the cycles the task was charged into virtual time,
+   so its execution time and the active part of SCH_voidGetLoad are not zero */
+#ifdef HOST_SIM
+#include "SIM_interface.h"
+#define SCH_IDLE_HOOK()				SIM_voidIdle()
+#define SCH_TASK_DONE_HOOK()		SIM_voidSettle()
+#define SCH_WFI()					SIM_voidWaitForInterrupt()
+#define SCH_IRQ_DISABLE()
+#define SCH_IRQ_ENABLE()
+#else
+#define SCH_IDLE_HOOK()
+#define SCH_TASK_DONE_HOOK()
+#define SCH_WFI()					__asm volatile ("wfi" ::: "memory")
+#define SCH_IRQ_DISABLE()			__asm volatile ("cpsid i" ::: "memory")
+#define SCH_IRQ_ENABLE()			__asm volatile ("cpsie i" ::: "memory")
+#endif
+
+/* Static task table (SCH_Lcfg.c) */
+extern const SCH_Task_t SCH_Tasks[SCH_NUMBER_OF_TASKS];
+
+#endif
@@ -0,0 +1,66 @@
+/*******************************************************/
+/* Layer     : Host simulation                         */
+/* SWC       : SIM (virtual STM32F103)                 */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SIM_CONFIG_H
+#define _SIM_CONFIG_H
+
+/* Core / bus clock of the simulated MCU (SYSCLK = HCLK = PCLK1 = PCLK2 = timers clock) */
+#define SIM_CPU_CLK_HZ				8000000UL
+
+/* Virtual time added every time the scheduler finds nothing to run */
+#define SIM_IDLE_STEP_US			50
+
+/* Longest time slice of the peripheral models, keeps I2C / USART events in order */
+#define SIM_MAX_SLICE_US			50
+
+/* Simulated run length, the host program exits with a summary after it (override with -DSIM_RUN_TIME_MS=...) */
+#ifndef SIM_RUN_TIME_MS
+#define SIM_RUN_TIME_MS				60000UL
+#endif
+
+/* DWT CYCCNT model: virtual time counts at SIM_CPU_CLK_HZ, plus the firmware cycles not yet turned
+ * into virtual time. Builds with -finstrument-functions charge SIM_CYCLES_PER_CALL cycles per firmware
+ * function call, the others run the firmware code in zero cycles */
+#ifndef SIM_CYCLES_PER_CALL
+#define SIM_CYCLES_PER_CALL			20ULL
+#endif
+
+/* Host time spent in firmware code (outside the peripheral models) added to CYCCNT at
+ * SIM_HOST_CYCLES_PER_US cycles per host microsecond: 1 enabled, 0 disabled (repeatable counts) */
+#ifndef SIM_CYCCNT_HOST_TIME
+#define SIM_CYCCNT_HOST_TIME		0
+#endif
+#define SIM_HOST_CYCLES_PER_US		1000ULL
+
+/* File receiving the USART1 output (telemetry frames), NULL to drop it */
+#define SIM_USART1_SINK_FILE		"usart1.bin"
+
+/* SCL frequency of the simulated I2C buses */
+#define SIM_I2C_SCL_HZ				100000UL
+
+/* Maximum number of I2C slave models per bus */
+#define SIM_I2C_MAX_SLAVES			8
+
+/* World (SIM_Lcfg.c): ego car driven by the speed controller PWM outputs, lead car ahead of it */
+#define SIM_MAX_ACCEL_MS2			3.0			/* full motor duty */
+#define SIM_MAX_BRAKE_MS2			8.0			/* full brake duty */
+#define SIM_DRAG_PER_S				0.08		/* speed lost per second, per m/s */
+#define SIM_INITIAL_GAP_M			40.0
+#define SIM_LEAD_SPEED_KMH			60.0		/* cruise speed of the lead car */
+#define SIM_LEAD_SLOW_SPEED_KMH		20.0		/* speed of the lead car while it slows down */
+#define SIM_LEAD_SLOW_START_MS		20000UL
+#define SIM_LEAD_SLOW_END_MS		40000UL
+#define SIM_LEAD_ACCEL_MS2			2.0			/* speed change rate of the lead car */
+#define SIM_REAR_GAP_CM				300			/* distance seen by the back sonars */
+#define SIM_SONAR_MAX_CM			8000		/* range of the forward sensors, no echo (0) beyond it, past the 56 m safe distance of 80 km/h */
+#define SIM_MIN_GAP_M				5.0			/* the run fails (exit status 1) if the gap ever gets below it */
+
+/* TIM1 BKIN pin asserted from this time on (SPEEDCTRL_HBRIDGE drive), 0 to never assert it */
+#ifndef SIM_BKIN_ASSERT_MS
+#define SIM_BKIN_ASSERT_MS			0UL
+#endif
+
+#endif
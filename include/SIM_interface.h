@@ -0,0 +1,109 @@
+/*******************************************************/
+/* Layer     : Host simulation                         */
+/* SWC       : SIM (virtual STM32F103)                 */
+/* Version   : V01                                     */
+/*******************************************************/
+
+/*
+ * Host build of the firmware: every register block of stm32f103C8.h is mapped on
+ * plain memory owned by this module, and behavioural models make it move:
+ * TIM1..TIM4 count and load their preloaded CCRx at the update events (TIM2 CH1
+ * captures the hall edges of the plant, BKIN / BG cut the TIM1 outputs), SysTick runs
+ * from virtual time, USART1 sends its bytes to a file, the I2C buses talk to
+ * pluggable slave models and DMA1 serves the I2C / USART / timer update requests. The DWT cycle
+ * counter follows the virtual time plus a fixed cost per firmware call (-finstrument-functions builds,
+ * see SIM_config.h), so two runs count the same cycles, and the
+ * bit-band alias stores of BIT_BAND.h are mapped back to their register bit.
+ * Virtual time only moves when the scheduler is idle (SCH_IDLE_HOOK), so the
+ * unmodified application runs as fast as the host allows.
+ *
+ * Build (from the repository root):
+ *   gcc -DHOST_SIM -O2 -Iinclude src/[A-Za-z]*.c -lm -o vstm32 && ./vstm32
+ * The exit status is non zero when the world report fails the run (collision, gap below SIM_MIN_GAP_M).
+ *   python3 tools/telemetry_decode.py usart1.bin
+ * Firmware execution cost (CYCCNT, task time, load):
+ *   add -finstrument-functions -finstrument-functions-exclude-file-list=SIM_
+ * Benchmark boot (bench.h): add -DBENCH_ENABLE=1 and the execution cost flags, then
+ *   python3 tools/telemetry_decode.py usart1.bin --json bench.json
+ */
+
+#ifndef _SIM_INTERFACE_H
+#define _SIM_INTERFACE_H
+
+/* Simulated address windows */
+#define SIM_PERIPH_START		0x40000000UL
+#define SIM_PERIPH_SIZE			0x00024000UL
+#define SIM_CORE_START			0xE0000000UL
+#define SIM_CORE_SIZE			0x00010000UL
+
+extern unsigned char SIM_u8PeriphMemory[SIM_PERIPH_SIZE];
+extern unsigned char SIM_u8CoreMemory[SIM_CORE_SIZE];
+
+/* Register block of a peripheral / core address (address constants, usable in static initializers) */
+#define SIM_PERIPH_BASE(ADDRESS)	((void *)&SIM_u8PeriphMemory[(ADDRESS) - SIM_PERIPH_START])
+#define SIM_CORE_BASE(ADDRESS)		((void *)&SIM_u8CoreMemory[(ADDRESS) - SIM_CORE_START])
+
+/* Simulated timers: TIM2..TIM4 and the advanced TIM1 (repetition counter not modelled) */
+#define SIM_TIMER2				0
+#define SIM_TIMER3				1
+#define SIM_TIMER4				2
+#define SIM_TIMER1				3
+#define SIM_TIMERS				4
+
+/* Simulated I2C buses */
+#define SIM_I2C_BUS1			0
+#define SIM_I2C_BUS2			1
+
+/* I2C slave model, called by the bus model at the matching bus events */
+typedef struct
+{
+	unsigned char Address;								/* 7-bit address */
+	void (*pfStart)(unsigned char Copy_u8Read);			/* addressed, Read = 1 for a master read */
+	unsigned char (*pfWrite)(unsigned char Copy_u8Data);	/* byte from the master, returns 1 for ACK */
+	unsigned char (*pfRead)(void);						/* byte to the master */
+	void (*pfStop)(void);								/* stop condition */
+} SIM_I2CSlave_t;
+
+/* Advances the virtual time, the peripheral models run and the enabled interrupt handlers are called */
+void SIM_voidAdvance(unsigned int Copy_u32Us);
+
+/* Idle step used by the scheduler idle hook */
+void SIM_voidIdle(void);
+
+/* WFI: the virtual time advances by idle steps until an interrupt handler has run */
+void SIM_voidWaitForInterrupt(void);
+
+/* Virtual time since reset */
+unsigned long long SIM_u64GetTimeUs(void);
+
+/* Bit-band alias access (BIT_BAND.h): the alias word is mapped back to its register bit,
+ * a register outside the simulated windows (an SRAM variable) is accessed in place */
+void SIM_voidBitBandAliasWrite(unsigned int Copy_u32Alias, unsigned int Copy_u32Value);
+unsigned int SIM_u32BitBandAliasRead(unsigned int Copy_u32Alias);
+void SIM_voidBitBandWrite(volatile void * Copy_pRegister, unsigned int Copy_u32Bit, unsigned int Copy_u32Value);
+unsigned int SIM_u32BitBandRead(volatile void * Copy_pRegister, unsigned int Copy_u32Bit);
+
+/* DWT CYCCNT model, brought up to date and returned (still counting while firmware code runs) */
+unsigned int SIM_u32GetCycleCount(void);
+
+/* Turns the firmware cycles counted so far into virtual time, the peripherals run meanwhile */
+void SIM_voidSettle(void);
+
+/* Duty of a timer output in Q16 (65536 = always active), from the compare value loaded by the
+ * preload logic; 0 while the counter, the output (CCxE or CCxNE) or the TIM1 main output is off */
+unsigned int SIM_u32TimerDutyQ16(unsigned char Copy_u8Timer, unsigned char Copy_u8Channel);
+
+/* TIM1 BKIN pin: asserted (1) cuts the TIM1 outputs when the break is enabled, as long as it is held */
+void SIM_voidSetBreakInput(unsigned char Copy_u8Asserted);
+
+/* Adds a slave model on a simulated bus, returns 0 if the bus is full */
+unsigned char SIM_u8AttachI2CSlave(unsigned char Copy_u8Bus, const SIM_I2CSlave_t * Copy_pSlave);
+
+/* World models (SIM_Lcfg.c): attached at start, stepped with the virtual time, reported at the end.
+ * The report returns the exit status of the host program, non zero when the run failed */
+void SIM_voidWorldInit(void);
+void SIM_voidWorldStep(unsigned int Copy_u32Us);
+unsigned int SIM_u32WorldHallPeriodUs(void);
+unsigned char SIM_u8WorldReport(void);
+
+#endif
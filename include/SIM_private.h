@@ -0,0 +1,164 @@
+/*******************************************************/
+/* Layer     : Host simulation                         */
+/* SWC       : SIM (virtual STM32F103)                 */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SIM_PRIVATE_H
+#define _SIM_PRIVATE_H
+
+/* CPU cycles in one microsecond of virtual time */
+#define SIM_CYCLES_PER_US			(SIM_CPU_CLK_HZ / 1000000UL)
+
+/* Data register value meaning "empty": a software write always fits 9 bits */
+#define SIM_DR_EMPTY				0xFFFF0000UL
+
+/* NVIC positions of the modeled interrupts */
+#define SIM_IRQN_DMA1_CHANNEL1		11
+#define SIM_IRQN_TIM1_UP			25
+#define SIM_IRQN_TIM2				28
+#define SIM_IRQN_TIM3				29
+#define SIM_IRQN_TIM4				30
+#define SIM_IRQN_I2C1_EV			31
+#define SIM_IRQN_I2C1_ER			32
+#define SIM_IRQN_I2C2_EV			33
+#define SIM_IRQN_I2C2_ER			34
+#define SIM_IRQN_USART1				37
+#define SIM_IRQN_COUNT				64
+
+/* SysTick CTRL */
+#define SIM_STK_ENABLE				0
+#define SIM_STK_TICKINT				1
+#define SIM_STK_CLKSOURCE			2
+#define SIM_STK_COUNTFLAG			16
+
+/* CoreDebug DEMCR / DWT CTRL */
+#define SIM_DEMCR_TRCENA			24
+#define SIM_DWT_CYCCNTENA			0
+
+/* General purpose timers */
+#define SIM_TIM_CR1_CEN				0
+#define SIM_TIM_CR1_UDIS			1
+#define SIM_TIM_CR1_URS				2
+#define SIM_TIM_CR1_OPM				3
+#define SIM_TIM_CR1_DIR				4
+#define SIM_TIM_SR_UIF				0
+#define SIM_TIM_SR_CC1IF			1
+#define SIM_TIM_SR_BIF				7
+#define SIM_TIM_SR_CC1OF			9
+#define SIM_TIM_DIER_UDE			8
+#define SIM_TIM_EGR_UG				0
+#define SIM_TIM_EGR_BG				7
+#define SIM_TIM_CCER_CC1E			0
+#define SIM_TIM_CCER_CC2E			4
+#define SIM_TIM_CCER_CC1NE			2			/* +4 per channel, TIM1 */
+#define SIM_TIM_BDTR_BKE			12
+#define SIM_TIM_BDTR_MOE			15
+#define SIM_TIM_CCMR1_CC1S_MASK		0x3
+#define SIM_TIM_CCMR_OCPE			3			/* +8 for channels 2 and 4 */
+#define SIM_TIM_IT_MASK				0x5F		/* UIF, CC1IF..CC4IF, TIF */
+
+/* USART */
+#define SIM_USART_SR_TC				6
+#define SIM_USART_SR_TXE			7
+#define SIM_USART_CR1_TE			3
+#define SIM_USART_CR1_TCIE			6
+#define SIM_USART_CR1_TXEIE			7
+#define SIM_USART_CR1_UE			13
+#define SIM_USART_CR3_DMAT			7
+#define SIM_USART_FRAME_BITS		10			/* start + 8 data + stop */
+
+/* DMA */
+#define SIM_DMA_CHANNELS			7
+#define SIM_DMA_CCR_EN				0
+#define SIM_DMA_CCR_TCIE			1
+#define SIM_DMA_CCR_HTIE			2
+#define SIM_DMA_CCR_TEIE			3
+#define SIM_DMA_CCR_DIR				4
+#define SIM_DMA_CCR_CIRC			5
+#define SIM_DMA_CCR_MINC			7
+#define SIM_DMA_CCR_MSIZE			10			/* 2 bits: 8, 16 or 32-bit memory data */
+#define SIM_DMA_ISR_GIF(CH)			(4 * (CH))
+#define SIM_DMA_ISR_TCIF(CH)		(4 * (CH) + 1)
+#define SIM_DMA_ISR_HTIF(CH)		(4 * (CH) + 2)
+#define SIM_DMA_ISR_TEIF(CH)		(4 * (CH) + 3)
+#define SIM_DMA_USART1_TX			3			/* channel 4 */
+
+/* I2C */
+#define SIM_I2C_BUSES				2
+#define SIM_I2C_CR1_PE				0
+#define SIM_I2C_CR1_START			8
+#define SIM_I2C_CR1_STOP			9
+#define SIM_I2C_CR1_ACK				10
+#define SIM_I2C_CR1_POS				11
+#define SIM_I2C_CR2_ITERREN			8
+#define SIM_I2C_CR2_ITEVTEN			9
+#define SIM_I2C_CR2_ITBUFEN			10
+#define SIM_I2C_CR2_DMAEN			11
+#define SIM_I2C_CR2_LAST			12
+#define SIM_I2C_SR1_SB				0
+#define SIM_I2C_SR1_ADDR			1
+#define SIM_I2C_SR1_BTF				2
+#define SIM_I2C_SR1_RXNE			6
+#define SIM_I2C_SR1_TXE				7
+#define SIM_I2C_SR1_AF				10
+#define SIM_I2C_SR1_ERR_MASK		0x5F00		/* BERR, ARLO, AF, OVR, PECERR, TIMEOUT, SMBALERT */
+#define SIM_I2C_SR2_MSL				0
+#define SIM_I2C_SR2_BUSY			1
+#define SIM_I2C_SR2_TRA				2
+#define SIM_I2C_BYTE_BITS			9			/* 8 data + (N)ACK */
+#define SIM_I2C_MAX_EVENTS			16			/* reactions per byte time, bounds a handler that never clears its event */
+
+/* I2C bus model phases */
+#define SIM_I2C_IDLE				0
+#define SIM_I2C_ADDRESS				1			/* address byte on the wire */
+#define SIM_I2C_ADDRESSED			2			/* ADDR set, clock stretched until it is cleared */
+#define SIM_I2C_TX					3
+#define SIM_I2C_RX					4
+#define SIM_I2C_NACKED				5			/* address or data NACK, waits for STOP */
+
+typedef struct
+{
+	u32 SR;						/* flags owned by the model, the software can only clear them */
+	u32 Prescaler;				/* prescaler loaded at the last update event */
+	u32 Divider;				/* input clock cycles since the last counter tick */
+	u32 Compare[4];				/* active CCR1..CCR4, loaded at the update events when OCxPE is set */
+} SIM_Timer_t;
+
+typedef struct
+{
+	u8 Active;					/* transfer latched from CPAR / CMAR / CNDTR */
+	u32 Remaining;
+	u32 Length;					/* reload value for the circular mode */
+	DMA_Address_t Cmar;			/* CMAR the transfer was latched from */
+	u8 *pu8Memory;
+	u32 ISR;					/* GIF / TCIF / HTIF / TEIF of the channel */
+} SIM_DmaChannel_t;
+
+typedef struct
+{
+	u8 Busy;					/* a frame is being shifted out */
+	u32 Cycles;					/* cycles left for the frame */
+	u8 TCLatch;					/* TC owned by the model, cleared by software writes */
+	u32 Bytes;					/* bytes sent since reset */
+	FILE *pSink;
+} SIM_Usart_t;
+
+typedef struct
+{
+	u8 Phase;
+	u8 Read;					/* direction of the running phase */
+	const SIM_I2CSlave_t *pSlave;
+	u8 OnWire;					/* a byte (address or data) is being clocked */
+	u32 Cycles;					/* cycles left for it */
+	u8 Shift;					/* TX byte being sent / RX byte waiting in the shift register */
+	u8 ShiftFull;
+	u8 RxCount;					/* bytes received in the phase */
+	u8 Nacked;					/* last RX byte was NACKed, the master stops clocking */
+	u8 Started;					/* at least one byte transferred in the phase (BTF) */
+	u32 SR1;					/* error flags owned by the model */
+	u8 SlaveCount;
+	const SIM_I2CSlave_t *apSlaves[SIM_I2C_MAX_SLAVES];
+} SIM_I2CBus_t;
+
+#endif
@@ -5,8 +5,16 @@ typedef unsigned char u8;
 typedef signed char s8;
 typedef unsigned short int u16;
 typedef signed short int s16;
+#ifdef HOST_SIM
+/* host build: long is 64 bits on LP64 hosts, the registers stay 32 bits */
+typedef unsigned int u32;
+typedef signed int s32;
+#else
 typedef unsigned long int u32;
 typedef signed long int s32;
+#endif
+typedef unsigned long long u64;
+typedef signed long long s64;
 typedef float f32;
 typedef double f64;
 typedef long double f128;
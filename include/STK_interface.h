@@ -20,6 +20,8 @@
 	
 #define MSTK_COUNTER_DIS			0		/* Counter disabled */
 #define MSTK_COUNTER_EN				1		/* Counter enabled  */
+
+#define MSTK_PENDSTSET_BIT			26		/* SCB ICSR: SysTick exception pending */
 	
 #define MSTK_TICKS 					0		
 #define MSTK_MILLIS 				1
@@ -56,5 +58,9 @@ u32 MSTK_u32GetElapsedTime       ( u8 Copy_u8ValueType
  
 u32 MSTK_u32GetReminingTime      ( u8 Copy_u8ValueType                                            );
 
+void MSTK_voidRestart            ( u32 Copy_u32LoadVal                                            );
+
+u8 MSTK_u8GetPendingFlag         ( void                                                           );
+
 
 #endif
\ No newline at end of file
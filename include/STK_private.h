@@ -17,7 +17,7 @@ typedef struct{
 }SYSTICK;
 
 
-#define MSTK ((volatile SYSTICK*)0xE000E010)
+#define MSTK ((volatile SYSTICK*)CORE_BASE(STK_u32_BASE_ADDRESS))
 
 
 
@@ -0,0 +1,34 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SWT (software timers)                   */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SWT_CONFIG_H
+#define _SWT_CONFIG_H
+
+/* Time base of the wheel
+ * Available options:-
+ * 						SWT_SOURCE_SCH		scheduler tick (SysTick), one wheel tick per SCH_TICK_MS
+ * 						SWT_SOURCE_GPT		SWT_voidTick as the notification of a continuous GPT channel */
+#define SWT_TICK_SOURCE				SWT_SOURCE_SCH
+
+/* Wheel tick in microseconds, SCH_TICK_MS * 1000 with SWT_SOURCE_SCH */
+#define SWT_TICK_US					1000
+
+/* GPT channel of SWT_SOURCE_GPT. It must be configured in the Gpt_Init list as
+   GPT_MODE_CONTINUOUS with SWT_voidTick as its notification, and not be one of the
+   GPT_RESERVED_CHANNELS (GPT_cfg.h): take TIM4 out of them when the PWM does not use it */
+#define SWT_GPT_CHANNEL				GPT_CHANNEL_TIM4
+
+/* Scheduler task running SWT_voidDispatch (SWT_SOURCE_SCH): deferred to the next expiry
+   after each dispatch so a tickless idle can sleep through the ticks without timers */
+#define SWT_SCH_TASK				SCH_TASK_TIMERS
+
+/* Wheel geometry: SWT_LEVELS levels of 2^SWT_LEVEL_BITS slots. Each level covers
+   2^SWT_LEVEL_BITS times the one below, 6 bits x 3 levels reach 262144 ticks in one pass,
+   longer delays take extra cascades */
+#define SWT_LEVEL_BITS				6
+#define SWT_LEVELS					3
+
+#endif
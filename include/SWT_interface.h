@@ -0,0 +1,50 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SWT (software timers)                   */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SWT_INTERFACE_H
+#define _SWT_INTERFACE_H
+
+/* Time base options of SWT_TICK_SOURCE (SWT_config.h) */
+#define SWT_SOURCE_SCH				0
+#define SWT_SOURCE_GPT				1
+
+/* Wheel ticks of a delay in milliseconds, rounded up (SWT_TICK_US from SWT_config.h) */
+#define SWT_MS_TO_TICKS(MS)			((((u32)(MS) * 1000UL) + SWT_TICK_US - 1) / SWT_TICK_US)
+
+/* One software timer, owned by the user (static storage), linked into the wheel while armed */
+typedef struct SWT_Timer
+{
+	struct SWT_Timer *pNext;						/* Next timer of the same wheel slot */
+	struct SWT_Timer **ppPrev;						/* Link pointing at this timer, NULL while not armed */
+	u32 Expiry;										/* Tick of the expiry */
+	u32 Period;										/* Reload in ticks, 0 for a one-shot timer */
+	void (*pfCallBack)(struct SWT_Timer *pTimer);	/* Runs from SWT_voidDispatch, may restart or stop any timer */
+}SWT_Timer_t;
+
+/* Static initializer of a stopped timer */
+#define SWT_TIMER_INIT(CALLBACK)	{ NULL, NULL, 0, 0, (CALLBACK) }
+
+void SWT_voidInit                       ( void                );
+
+void SWT_voidCreate                     ( SWT_Timer_t * Copy_pTimer, void (*Copy_pfCallBack)(SWT_Timer_t *) );
+
+u8 SWT_u8Start                          ( SWT_Timer_t * Copy_pTimer, u32 Copy_u32DelayTicks, u32 Copy_u32PeriodTicks );
+
+void SWT_voidStop                       ( SWT_Timer_t * Copy_pTimer );
+
+u8 SWT_u8IsRunning                      ( const SWT_Timer_t * Copy_pTimer );
+
+u32 SWT_u32GetRemaining                 ( const SWT_Timer_t * Copy_pTimer );
+
+u32 SWT_u32GetNextEvent                 ( void                );
+
+u32 SWT_u32GetTickCount                 ( void                );
+
+void SWT_voidTick                       ( void                );
+
+void SWT_voidDispatch                   ( void                );
+
+#endif
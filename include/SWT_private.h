@@ -0,0 +1,23 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SWT (software timers)                   */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifndef _SWT_PRIVATE_H
+#define _SWT_PRIVATE_H
+
+#define SWT_SLOTS					(1UL << SWT_LEVEL_BITS)
+#define SWT_SLOT_MASK				(SWT_SLOTS - 1)
+
+/* Ticks reached by the wheel without passing through the top level again */
+#define SWT_RANGE					(1UL << (SWT_LEVEL_BITS * SWT_LEVELS))
+
+/* Delays are compared as signed tick differences */
+#define SWT_MAX_DELAY				0x7FFFFFFFUL
+
+#if (SWT_LEVEL_BITS * SWT_LEVELS) > 30
+	#error "SWT wheel range must stay below 2^30 ticks"
+#endif
+
+#endif
@@ -25,6 +25,18 @@
 
 #define MUSART1_STOP_BITS         ONE_STOP_BIT
 
+/* Transmit path: MUSART1_TX_BLOCKING, MUSART1_TX_INTERRUPT (TXE drains the ring), MUSART1_TX_DMA (DMA1 channel 4 drains the ring) */
+
+#define MUSART1_TX_MODE           MUSART1_TX_DMA
+
+/* TX ring size in bytes, power of two up to 32768 */
+
+#define MUSART1_TX_BUFFER_SIZE    256
+
+/* printf through _write: MUSART1_ENABLE, MUSART1_DISABLE */
+
+#define MUSART1_RETARGET_PRINTF   MUSART1_ENABLE
+
 
 
 
@@ -33,13 +33,28 @@
 #define TWO_STOP_BIT 2
 #define ONE_AND_HALF_STOP_BIT 3
 
+#define MUSART1_TX_BLOCKING 0
+#define MUSART1_TX_INTERRUPT 1
+#define MUSART1_TX_DMA 2
+
+/* NVIC position number of USART1 global interrupt */
+#define USART1_IRQN 37
+
 #define THRESHOLD_VALUE 9000000UL
 #define MUSART1_BAUD_RATE (u32)9600
 
 void MUSART1_voidInit(void);
 
+/* blocking mode: waits for the end of the frame, ring modes: queues the char and returns */
 void MUSART1_voidSendChar(u8 Copy_u8Char);
 
+/* queues up to Copy_u16Length bytes and returns how many were taken, the rest are counted as dropped */
+/* (blocking mode sends all of them before returning) */
+u16 MUSART1_u16Enqueue(const u8 *Copy_pu8Data, u16 Copy_u16Length);
+
+/* bytes lost because the TX ring was full */
+u32 MUSART1_u32GetDropCount(void);
+
 void MUSART1_voidSendString(u8 *Copy_ptrString);
 
 u8 MUSART1_u8ReceiveChar(void);
@@ -7,4 +7,19 @@
 #ifndef _UART_PRIVATE_H
 #define _UART_PRIVATE_H
 
+/* SR bits */
+#define USART_SR_TC      6
+#define USART_SR_TXE     7
+
+/* CR1 bits */
+#define USART_CR1_TXEIE  7
+
+/* CR3 bits */
+#define USART_CR3_DMAT   7
+
+/* DMA1 channel serving USART1_TX */
+#define MUSART1_TX_DMA_CHANNEL  DMA_CHANNEL4
+
+#define MUSART1_TX_BUFFER_MASK  (MUSART1_TX_BUFFER_SIZE - 1)
+
 #endif
@@ -0,0 +1,12 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+//* measures the driver and control hot paths into the PROF_ZONE_BENCH_* zones,
+//* the telemetry task then streams them as profile frames (tools/telemetry_decode.py --json)
+//* runs once every driver is set up, before the scheduler starts: the cycles are the ones of the real
+//* configuration, the marker cost (PROF_ZONE_BENCH_BASELINE) is taken off the other zones. The application
+//* zones are left as they were, the caller re-initialises the modules the benchmarked calls moved
+//* (speed controller, sonar filter, fusion, tracker)
+void BENCH_Run();
+
+#endif
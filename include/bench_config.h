@@ -0,0 +1,12 @@
+#ifndef BENCH_CONFIG
+#define BENCH_CONFIG
+
+//* benchmark boot mode, off unless the build asks for it (-DBENCH_ENABLE=1), needs PROF_ENABLE
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE 0
+#endif
+
+//* measured calls per benchmarked function
+#define BENCH_ITERATIONS 64
+
+#endif
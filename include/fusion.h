@@ -0,0 +1,26 @@
+#ifndef FUSION_H
+#define FUSION_H
+
+#include "STD_TYPES.h"
+
+//* full confidence, both forward sonars fresh and agreeing
+#define FUSION_FULL_CONFIDENCE 255
+
+//* sensors bits of FusionState
+#define FUSION_USED_F1 0x01
+#define FUSION_USED_F2 0x02
+
+typedef struct
+{
+    u16 gapCm;     //* fused forward gap
+    u8 confidence; //* 0 (no usable reading) to FUSION_FULL_CONFIDENCE
+    u8 sensors;    //* FUSION_USED_* of the sensors behind the gap
+    u32 timeMs;    //* time stamp of the newest reading used, 0 before the first one
+} FusionState;
+
+void FUSION_Init();
+//* fuses the filtered F1 / F2 readings (sonar_filter.h) as seen at nowMs
+void FUSION_Update(u32 nowMs);
+void FUSION_GetState(FusionState *ptr_State);
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef FUSION_CONFIG
+#define FUSION_CONFIG
+
+//* noise floor of one forward sonar (5 cm standard deviation), lower bound of its variance
+#define FUSION_MIN_VARIANCE_CM2 25
+//* variance cap, keeps one bad sensor from getting a zero weight
+#define FUSION_MAX_VARIANCE_CM2 10000
+//* variance of each sensor follows its squared residual to the fused gap with a weight of 1 / 2^shift
+#define FUSION_VARIANCE_SHIFT 3
+
+//* readings further apart than this disagree: the nearer one is used and the confidence drops
+#define FUSION_AGREE_CM 50
+
+//* a sensor is fully trusted up to FRESH ms after its last accepted reading, then less and less,
+//* and it is left out of the fusion after STALE ms
+#define FUSION_FRESH_MS 250
+#define FUSION_STALE_MS 750
+
+//* confidence (out of 255) of a gap seen by one sensor only
+#define FUSION_SINGLE_CONFIDENCE 160
+
+#endif
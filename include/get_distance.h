@@ -4,4 +4,10 @@
 #define CountForward 2
 #define CountAll 4
 
+#include "STD_TYPES.h"
+
+//* latest filtered reading of the 2 forward / all 4 sonars in cm (F1, F2, B1, B2), see sonar_filter.h
+void GetDistance_u16GetForwardDistance(u16 *Copy_ptrForwardDistanceData);
+void GetDistance_u16AllDistance(u16 *Copy_ptrAllDistanceData);
+
 #endif
\ No newline at end of file
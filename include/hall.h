@@ -2,12 +2,20 @@
 #define HALL_H
 
 #include "STD_TYPES.h"
+#include "RING_BUFFER.h"
 
 #define wheelRaduis 1
 #define CAR_MOVING 1
 #define CAR_NOT_MOVING 2
 #define CAR_SPEED_EXCEPTION 3
 
+#define HALL_SAMPLE_SPEED(VALUE) ((u8)(VALUE))
+#define HALL_SAMPLE_RPM(VALUE) ((u32)(VALUE) >> 8)
+
+//* speed measurement methods
+#define HALL_METHOD_PERIOD 0
+#define HALL_METHOD_COUNT 1
+
 typedef struct
 {
     u8 statusCode;
@@ -17,5 +25,10 @@ typedef struct
 
 void HALL_GetSpeed(SpeedData *ptr_SpeedData);
 void HALL_Init();
+//* oldest speed sample queued by the TIM2 capture interrupt: Source = statusCode, TimeStamp = capture time (us),
+//* Value = RPM (saturated to 24 bits) << 8 | speedPerKm, unpacked with the macros below
+u8 HALL_u8PopSpeedSample(RING_Sample_t *ptr_Sample);
+//* method used by the last HALL_GetSpeed: HALL_METHOD_PERIOD (edge period) or HALL_METHOD_COUNT (edges per window)
+u8 HALL_u8GetMethod();
 
 #endif
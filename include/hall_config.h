@@ -1,4 +1,25 @@
 #ifndef HALL_CONFIG
 #define HALL_CONFIG
 
-#endif
\ No newline at end of file
+//* wheel radius in mm
+#define HALL_WHEEL_RADIUS_MM (wheelRaduis * 1000)
+//* hall pulses per wheel turn
+#ifndef HALL_PULSES_PER_REV
+#define HALL_PULSES_PER_REV 1
+#endif
+//* no edge for this long means the car stopped
+#define HALL_STOP_TIMEOUT_MS 2000
+//* timing jitter of one hall edge (sensor switching, magnet spacing), sets the period / count method crossover:
+//* the period method is off by up to 2 jitters per edge period T, the count method by one edge (T) per sample
+//* window W, they cross at T = sqrt(2 * jitter * W). With 20 us and the 10 ms sample window that is T = 632 us,
+//* 16 edges per sample, about 36000 km/h on the 1 m wheel with one pulse: the count method needs a toothed wheel
+#ifndef HALL_EDGE_JITTER_US
+#define HALL_EDGE_JITTER_US 20
+#endif
+//* the capture interrupt queues at most one speed sample per this period (also the count method window),
+//* the ACC task pops them every 20 ms so the ring below never fills while the wheel turns
+#define HALL_SAMPLE_PERIOD_MS 10
+//* speed samples queued for the control task, must be a power of two
+#define HALL_RING_SIZE 8
+
+#endif
@@ -1,5 +1,22 @@
-
 #ifndef HALL_PRIVATE
 #define HALL_PRIVATE
 
-#endif
\ No newline at end of file
+//* km/h per RPM in Q16.16, 2 * pi * r[mm] * 60 / 10^6 with pi = 314159 / 100000, folded at compile time
+#define HALL_KMH_PER_RPM_Q16 ((u32)((2ULL * 314159ULL * HALL_WHEEL_RADIUS_MM * 60ULL * 65536ULL) / (100000ULL * 1000000ULL)))
+
+//* speedPerKm saturates here instead of wrapping around the u8
+#define HALL_MAX_SPEED_KMH 255
+//* lowest RPM giving HALL_MAX_SPEED_KMH, above it the product below would not fit 32 bits
+#define HALL_RPM_AT_MAX_SPEED ((((u32)HALL_MAX_SPEED_KMH + 1) << 16) / HALL_KMH_PER_RPM_Q16)
+
+//* RPM = HALL_RPM_TIME_PRODUCT / (capture ticks between two edges)
+#define HALL_RPM_TIME_PRODUCT ((60000000UL / GPT_CAPTURE_TICK_US) / HALL_PULSES_PER_REV)
+#define HALL_STOP_TIMEOUT_TICKS ((HALL_STOP_TIMEOUT_MS * 1000UL) / GPT_CAPTURE_TICK_US)
+#define HALL_SAMPLE_PERIOD_TICKS ((HALL_SAMPLE_PERIOD_MS * 1000UL) / GPT_CAPTURE_TICK_US)
+
+//* squared edge count of a sample window (capture ticks) at the method crossover, W / (2 * jitter)
+#define HALL_CROSSOVER_EDGES_SQ(WINDOW) ((WINDOW) / ((2UL * HALL_EDGE_JITTER_US) / GPT_CAPTURE_TICK_US))
+//* above this many edges per sample the square is not computed, the count method wins anyway
+#define HALL_MAX_SQUARED_EDGES 0xFFFFUL
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef SAFE_DISTANCE_H
+#define SAFE_DISTANCE_H
+
+#include "STD_TYPES.h"
+
+//* dense tables generated by tools/gen_safe_tables.py from safe_distance_config.h
+//* speeds in km/h, distances in m, both saturate at 255
+extern const u8 SAFE_DistanceTable[256]; //* speed -> safe distance, non decreasing
+extern const u8 SAFE_SpeedTable[256];    //* distance -> highest speed whose safe distance fits, non decreasing
+
+//* O(1) lookups, any u8 is a valid index
+#define SAFE_GET_DISTANCE(SPEED_KM) (SAFE_DistanceTable[(u8)(SPEED_KM)])
+#define SAFE_GET_SPEED(DISTANCE_M) (SAFE_SpeedTable[(u8)(DISTANCE_M)])
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef SAFE_DISTANCE_CONFIG
+#define SAFE_DISTANCE_CONFIG
+
+//* braking model of the safe distance tables, read by tools/gen_safe_tables.py
+//* run the generator again after changing any of these (src/safe_distance_tables.c is generated)
+//* safe distance (m) = speed * reaction time + speed^2 / (2 * deceleration) + margin
+
+//* driver / system reaction time before the brake acts
+#define SAFE_REACTION_TIME_MS 500
+//* braking deceleration in cm/s^2
+#define SAFE_DECEL_CM_S2 800
+//* distance kept to the lead car once stopped, in cm
+#define SAFE_MARGIN_CM 200
+
+#endif
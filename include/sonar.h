@@ -3,6 +3,7 @@
 #ifndef SONAR_H
 #define SONAR_H
 #include "STD_TYPES.h"
+#include "RING_BUFFER.h"
 #define SONAR_BASE_ADDRESS (0b1110000)
 #define SONAR_F1_ADDRESS (0b00000001)
 #define SONAR_F2_ADDRESS (0b00000011)
@@ -12,17 +13,38 @@
 #define CHANGE_SEQUENCE_1 (170)
 #define CHANGE_SEQUENCE_2 (165)
 
+/*sonar indices used by the ranging scheduler*/
+#define SONAR_F1 (0)
+#define SONAR_F2 (1)
+#define SONAR_B1 (2)
+#define SONAR_B2 (3)
+
 
 #define NULL ((void *)0)
 
 /************************************Functions' Prototypes************************************/
 
-/*this function is to tell the sonar to save readings*/
-
-/*this function is to save readings and request them of one sonar*/
-u16 HAL_u16SonarReportLastReading(u8 Copy_u8Address);
-
 /*this function is to send commands*/
 void HAL_u16SonarChangeAddress(u8 Copy_u8Address, u8 Copy_u8NewAddress);
 
+/*this function advances the ranging scheduler, it must be called periodically (every 1 ms or so) with the current time*/
+/*all sonars of a group are triggered together then read once their conversion window has ended*/
+void HAL_voidSonarRangingUpdate(u32 Copy_u32TimeMs);
+
+/*this function returns the last distance measured by the scheduler for one sonar (SONAR_F1 ... SONAR_B2)*/
+u16 HAL_u16SonarGetDistance(u8 Copy_u8Index);
+
+/*this function takes the oldest reading queued by the I2C interrupt (Source = sonar index, Value = distance, TimeStamp in ms)*/
+/*returns STD_TYPES_NOK when no reading is waiting*/
+u8 HAL_u8SonarPopSample(RING_Sample_t *Copy_pSample);
+
+/*this function returns the number of complete sweeps done by the scheduler*/
+u32 HAL_u32SonarGetSweepCount(void);
+
+/*this function returns the number of ranging transactions aborted by the I2C watchdog*/
+u32 HAL_u32SonarGetBusResets(void);
+
+/*this function returns the time the ranging scheduler has nothing to do (conversion window), 0 when it must be called again next tick*/
+u32 HAL_u32SonarGetIdleMs(void);
+
 #endif
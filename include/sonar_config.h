@@ -0,0 +1,30 @@
+#ifndef SONAR_CONFIG_H
+#define SONAR_CONFIG_H
+
+/*number of sonars handled by the ranging scheduler (F1, F2, B1, B2)*/
+#define SONAR_COUNT (4)
+
+/*time needed by one sonar to finish ranging after TAKE_RANGE_CMD*/
+#define SONAR_CONVERSION_MS (100)
+
+/*a ranging transaction still running this long after its submission is aborted to free the bus*/
+#define SONAR_I2C_WATCHDOG_MS (20)
+
+/*polls of the engine state before a blocking transfer (address change) gives up and aborts, about 20 ms at 8 MHz*/
+#define SONAR_TRANSFER_TIMEOUT_POLLS (20000UL)
+
+/*number of firing groups, all sonars of a group range at the same time and the groups fire one after the other*/
+/*1: the whole sweep takes one conversion period, 2: front and back pairs are split to avoid acoustic crosstalk*/
+#ifndef SONAR_GROUP_COUNT
+#define SONAR_GROUP_COUNT (1)
+#endif
+
+/*firing group of every sonar (F1, F2, B1, B2), values from 0 to SONAR_GROUP_COUNT - 1*/
+#ifndef SONAR_GROUPS
+#define SONAR_GROUPS {0, 0, 0, 0}
+#endif
+
+/*readings queued between the I2C interrupt and the control task, must be a power of two*/
+#define SONAR_RING_SIZE (16)
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef SONAR_FILTER_H
+#define SONAR_FILTER_H
+
+#include "STD_TYPES.h"
+
+typedef struct
+{
+    u8 valid;       //* a reading was accepted since SONARFILTER_Init
+    u16 distanceCm; //* last accepted (filtered) distance
+    u16 rejected;   //* readings rejected by the gate, free running
+    u32 acceptMs;   //* time stamp of the last accepted reading
+    u32 ageMs;      //* time since the last accepted reading, at the newest reading
+} SonarFilterStats;
+
+void SONARFILTER_Init();
+//* runs one raw reading of a sonar (SONAR_F1 ... SONAR_B2) taken at timeMs through median, gate and hold,
+//* writes the filtered distance and returns STD_TYPES_NOK when the reading was rejected (held value written)
+u8 SONARFILTER_u8Update(u8 sensor, u32 timeMs, u16 rawCm, u16 *ptr_FilteredCm);
+//* leaves ptr_Stats untouched for a sensor out of range
+void SONARFILTER_GetStats(u8 sensor, SonarFilterStats *ptr_Stats);
+
+#endif
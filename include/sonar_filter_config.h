@@ -0,0 +1,23 @@
+#ifndef SONAR_FILTER_CONFIG
+#define SONAR_FILTER_CONFIG
+
+//* per sonar settings, in the order F1, F2, B1, B2
+
+//* running median window: 1 (off), 3 or 5 readings, removes up to 1 or 2 spurious echoes in a row
+//* at the cost of 1 or 2 sweeps of delay
+#define SONAR_FILTER_MEDIAN {3, 3, 3, 3}
+
+//* rate of change gate: largest believable change of the distance in cm/s (0 disables the gate),
+//* a reading further than rate * dt + SONAR_FILTER_GATE_SLACK_CM from the last accepted one is rejected
+#define SONAR_FILTER_MAX_RATE_CM_S {2000, 2000, 1000, 1000}
+#define SONAR_FILTER_GATE_SLACK_CM 20
+
+//* hold last valid: rejected readings keep the last accepted distance for at most this long,
+//* after that the gate reopens and the next reading is taken as it is
+#define SONAR_FILTER_HOLD_MS {300, 300, 500, 500}
+
+//* a sonar reports 0 when no echo came back within its range, filtered as this distance instead (the sensor
+//* range): ACC takes it as a clear road, so it must lie past the safe distance of the user speed
+#define SONAR_FILTER_NO_ECHO_CM 8000
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef SPEED_CONTROL_H
+#define SPEED_CONTROL_H
+
+#include "STD_TYPES.h"
+
+typedef struct
+{
+    u8 targetKm;     //* requested speed
+    u8 referenceKm;  //* rate limited reference followed by the PI
+    s32 integral;    //* integral term in duty counts
+    s32 effort;      //* > 0 motor duty, < 0 brake duty
+} SpeedCtrlState;
+
+void SPEEDCTRL_Init();
+void SPEEDCTRL_SetTarget(u8 targetKm);
+void SPEEDCTRL_Step(u8 measuredKm);
+void SPEEDCTRL_GetState(SpeedCtrlState *ptr_State);
+
+#endif
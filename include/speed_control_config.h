@@ -0,0 +1,38 @@
+#ifndef SPEED_CONTROL_CONFIG
+#define SPEED_CONTROL_CONFIG
+
+//* controller period, must match the period of the task calling SPEEDCTRL_Step
+#define SPEEDCTRL_PERIOD_MS 20
+
+//* actuator drive: 0 = two TIM3 PWM outputs, 1 = TIM1 half bridges (complementary outputs with dead-time,
+//* cut in hardware by the BKIN break input, see PWM_Cfg.h), motor ramps only run on TIM3
+#ifndef SPEEDCTRL_HBRIDGE
+#define SPEEDCTRL_HBRIDGE 0
+#endif
+
+//* PWM channels of the actuators and their period (ARR), duty cycles are in [0, SPEEDCTRL_PWM_PERIOD]
+#if SPEEDCTRL_HBRIDGE
+#define SPEEDCTRL_MOTOR_CHANNEL MPWM_TIM1_CH1
+#define SPEEDCTRL_BRAKE_CHANNEL MPWM_TIM1_CH2
+#else
+#define SPEEDCTRL_MOTOR_CHANNEL MPWM_Channel_1
+#define SPEEDCTRL_BRAKE_CHANNEL MPWM_Channel_2
+#endif
+#define SPEEDCTRL_PWM_PERIOD 1000
+
+//* PI gains in Q8 (duty counts per km/h of error, per km/h of error and controller step)
+#define SPEEDCTRL_KP_Q8 (40 * 256)
+#define SPEEDCTRL_KI_Q8 (2 * 256)
+
+//* reference limits: acceleration and deceleration in km/h per second
+#define SPEEDCTRL_MAX_ACCEL_KMH_S 8
+#define SPEEDCTRL_MAX_DECEL_KMH_S 20
+
+//* jerk limit: maximum change of the actuator duty per controller step
+#define SPEEDCTRL_MAX_DUTY_STEP 50
+
+//* motor duty changes are spread over this many PWM periods (S-curve ramp streamed by DMA, 8 ms periods),
+//* shorter than SPEEDCTRL_PERIOD_MS so that a ramp ends before the next step
+#define SPEEDCTRL_RAMP_PERIODS 2
+
+#endif
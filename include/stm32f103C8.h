@@ -8,6 +8,23 @@
 #define STM32F103C8_H
 
 #include "STD_TYPES.h"
+
+/************************************ Address mapping ****************************************/
+
+/*
+ * Peripheral (0x4000xxxx) and Cortex-M3 core (0xE000xxxx) register blocks.
+ * The host build (HOST_SIM) maps them on the simulated register memory of the SIM module.
+ */
+#ifdef HOST_SIM
+#include "SIM_interface.h"
+#define PERIPH_BASE(ADDRESS)	SIM_PERIPH_BASE(ADDRESS)
+#define CORE_BASE(ADDRESS)		SIM_CORE_BASE(ADDRESS)
+#else
+#define PERIPH_BASE(ADDRESS)	(ADDRESS)
+#define CORE_BASE(ADDRESS)		(ADDRESS)
+#endif
+
+/*********************************************************************************************/
 /************************************ RCC Registers ******************************************/
 
 #define RCC_u32_BASE_ADDRESS 0x40021000
@@ -26,7 +43,7 @@ typedef struct
 	volatile u32 CSR;
 } RCC_RegDef_t;
 
-#define RCC ((RCC_RegDef_t *)0x40021000)
+#define RCC ((RCC_RegDef_t *)PERIPH_BASE(RCC_u32_BASE_ADDRESS))
 
 /*********************************************************************************************/
 
@@ -47,9 +64,9 @@ typedef struct
 	volatile u32 LCKR;
 } GPIO_RegDef_t;
 
-#define GPIOA ((GPIO_RegDef_t *)GPIO_u32_GPIOA_BASE_ADDRESS)
-#define GPIOB ((GPIO_RegDef_t *)GPIO_u32_GPIOB_BASE_ADDRESS)
-#define GPIOC ((GPIO_RegDef_t *)GPIO_u32_GPIOC_BASE_ADDRESS)
+#define GPIOA ((GPIO_RegDef_t *)PERIPH_BASE(GPIO_u32_GPIOA_BASE_ADDRESS))
+#define GPIOB ((GPIO_RegDef_t *)PERIPH_BASE(GPIO_u32_GPIOB_BASE_ADDRESS))
+#define GPIOC ((GPIO_RegDef_t *)PERIPH_BASE(GPIO_u32_GPIOC_BASE_ADDRESS))
 
 /*********************************************************************************************/
 
@@ -72,7 +89,7 @@ typedef struct
 	volatile u8 IPR[240];
 } NVIC_RegDef_t;
 
-#define NVIC ((NVIC_RegDef_t *)NVIC_u32_BASE_ADDRESS)
+#define NVIC ((NVIC_RegDef_t *)CORE_BASE(NVIC_u32_BASE_ADDRESS))
 
 /*********************************************************************************************/
 
@@ -90,7 +107,7 @@ typedef struct
 	volatile u32 PR;
 } EXTI_RegDef_t;
 
-#define EXTI ((EXTI_RegDef_t *)EXTI_u32_BASE_ADDRESS)
+#define EXTI ((EXTI_RegDef_t *)PERIPH_BASE(EXTI_u32_BASE_ADDRESS))
 
 /*********************************************************************************************/
 
@@ -106,7 +123,7 @@ typedef struct
 	volatile u32 MAPR2;
 } AF_RegDef_t;
 
-#define AF ((AF_RegDef_t *)AF_u32_BASE_ADDRESS)
+#define AF ((AF_RegDef_t *)PERIPH_BASE(AF_u32_BASE_ADDRESS))
 
 /*********************************************************************************************/
 
@@ -122,7 +139,59 @@ typedef struct
 	volatile u32 CALIB;
 } STK_RegDef_t;
 
-#define STK ((STK_RegDef_t *)STK_u32_BASE_ADDRESS)
+#define STK ((STK_RegDef_t *)CORE_BASE(STK_u32_BASE_ADDRESS))
+
+/*********************************************************************************************/
+
+/************************************* SCB Registers *****************************************/
+
+#define SCB_u32_BASE_ADDRESS 0xE000ED00
+
+typedef struct
+{
+	volatile u32 CPUID;
+	volatile u32 ICSR;
+	volatile u32 VTOR;
+	volatile u32 AIRCR;
+	volatile u32 SCR;
+	volatile u32 CCR;
+	volatile u32 SHPR[3];
+	volatile u32 SHCSR;
+} SCB_RegDef_t;
+
+#define SCB ((SCB_RegDef_t *)CORE_BASE(SCB_u32_BASE_ADDRESS))
+
+/*********************************************************************************************/
+
+/****************************** CoreDebug / DWT Registers ***********************************/
+
+#define COREDEBUG_u32_BASE_ADDRESS 0xE000EDF0
+
+typedef struct
+{
+	volatile u32 DHCSR;
+	volatile u32 DCRSR;
+	volatile u32 DCRDR;
+	volatile u32 DEMCR;
+} COREDEBUG_RegDef_t;
+
+#define COREDEBUG ((COREDEBUG_RegDef_t *)CORE_BASE(COREDEBUG_u32_BASE_ADDRESS))
+
+#define DWT_u32_BASE_ADDRESS 0xE0001000
+
+typedef struct
+{
+	volatile u32 CTRL;
+	volatile u32 CYCCNT;
+	volatile u32 CPICNT;
+	volatile u32 EXCCNT;
+	volatile u32 SLEEPCNT;
+	volatile u32 LSUCNT;
+	volatile u32 FOLDCNT;
+	volatile u32 PCSR;
+} DWT_RegDef_t;
+
+#define DWT ((DWT_RegDef_t *)CORE_BASE(DWT_u32_BASE_ADDRESS))
 
 /*********************************************************************************************/
 
@@ -143,22 +212,53 @@ typedef struct
 	u32 I2SPR;
 } SPI1_RegDef_t;
 
-#define SPI1 ((SPI1_RegDef_t *)SPI1_u32_BASE_ADDRESS)
+#define SPI1 ((SPI1_RegDef_t *)PERIPH_BASE(SPI1_u32_BASE_ADDRESS))
+
+/************************************ DMA Registers ******************************************/
+
+#define DMA1_u32_BASE_ADDRESS 0x40020000
+
+/* Peripheral / memory address programmed in CPAR / CMAR (a host pointer does not fit 32 bits) */
+#ifdef HOST_SIM
+typedef unsigned long DMA_Address_t;
+#else
+typedef u32 DMA_Address_t;
+#endif
+
+typedef struct
+{
+	volatile u32 CCR;
+	volatile u32 CNDTR;
+	volatile DMA_Address_t CPAR;
+	volatile DMA_Address_t CMAR;
+	volatile u32 Reserved;
+} DMA_Channel_RegDef_t;
+
+typedef struct
+{
+	volatile u32 ISR;
+	volatile u32 IFCR;
+	DMA_Channel_RegDef_t Channel[7];
+} DMA_RegDef_t;
+
+#define DMA1 ((DMA_RegDef_t *)PERIPH_BASE(DMA1_u32_BASE_ADDRESS))
+
+/*********************************************************************************************/
 
 /*
  * I2C peripheral register definition structure
  */
 typedef struct
 {
-	u32 CR1;
-	u32 CR2;
-	u32 OAR1;
-	u32 OAR2;
-	u32 DR;
-	u32 SR1;
-	u32 SR2;
-	u32 CCR;
-	u32 TRISE;
+	volatile u32 CR1;
+	volatile u32 CR2;
+	volatile u32 OAR1;
+	volatile u32 OAR2;
+	volatile u32 DR;
+	volatile u32 SR1;
+	volatile u32 SR2;
+	volatile u32 CCR;
+	volatile u32 TRISE;
 } I2C_RegDef_t;
 
 /*
@@ -170,8 +270,8 @@ typedef struct
 /*
  * I2Cx peripheral definition macros
  */
-#define I2C1_BASE ((I2C_RegDef_t *)I2C1_BASE_ADDRESS)
-#define I2C2_BASE ((I2C_RegDef_t *)I2C2_BASE_ADDRESS)
+#define I2C1_BASE ((I2C_RegDef_t *)PERIPH_BASE(I2C1_BASE_ADDRESS))
+#define I2C2_BASE ((I2C_RegDef_t *)PERIPH_BASE(I2C2_BASE_ADDRESS))
 
 typedef struct
 {
@@ -184,7 +284,9 @@ typedef struct
 	volatile u32 GTPR;
 } UART_Register;
 
-#define MUSART1 ((volatile UART_Register *)0x40013800)
+#define USART1_u32_BASE_ADDRESS 0x40013800
+
+#define MUSART1 ((volatile UART_Register *)PERIPH_BASE(USART1_u32_BASE_ADDRESS))
 /*********************************************************************************************/
 /*
  * TIMERx peripheral register definition structure
@@ -203,12 +305,12 @@ typedef struct{
 	volatile u32 CNT;
 	volatile u32 PSC;
 	volatile u32 ARR;
-	volatile u32 RESERVED;
+	volatile u32 RCR;			/* TIM1 only */
     volatile u32 CCR1;
 	volatile u32 CCR2;
 	volatile u32 CCR3;
 	volatile u32 CCR4;
-	volatile u32 RESERVED2;
+	volatile u32 BDTR;			/* TIM1 only */
 	volatile u32 DCR;
 	volatile u32 DMAR;
 }TIMER_RegDef_t;
@@ -216,16 +318,19 @@ typedef struct{
 /*
  * TIMERx peripheral definition macros
  */
+#define TIMER1_BASE_ADDRESS 0x40012C00
 #define TIMER2_BASE_ADDRESS 0x40000000
 #define TIMER3_BASE_ADDRESS 0x40000400
 #define TIMER4_BASE_ADDRESS 0x40000800
 #define TIMER5_BASE_ADDRESS 0x40000C00
 
-#define TIMER2  ((volatile TIMER_RegDef_t*)TIMER2_BASE_ADDRESS)
+#define TIMER1  ((volatile TIMER_RegDef_t*)PERIPH_BASE(TIMER1_BASE_ADDRESS))
+
+#define TIMER2  ((volatile TIMER_RegDef_t*)PERIPH_BASE(TIMER2_BASE_ADDRESS))
 
-#define TIMER3  ((volatile TIMER_RegDef_t*)TIMER3_BASE_ADDRESS)
+#define TIMER3  ((volatile TIMER_RegDef_t*)PERIPH_BASE(TIMER3_BASE_ADDRESS))
 
-#define TIMER4  ((volatile TIMER_RegDef_t*)TIMER4_BASE_ADDRESS)
+#define TIMER4  ((volatile TIMER_RegDef_t*)PERIPH_BASE(TIMER4_BASE_ADDRESS))
 
-#define TIMER5  ((volatile TIMER_RegDef_t*)TIMER5_BASE_ADDRESS)
+#define TIMER5  ((volatile TIMER_RegDef_t*)PERIPH_BASE(TIMER5_BASE_ADDRESS))
 #endif
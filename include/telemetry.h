@@ -0,0 +1,47 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "STD_TYPES.h"
+#include "hall.h"
+#include "speed_control.h"
+#include "PROF_interface.h"
+#include "SCH_interface.h"
+
+//* frame types, first byte of every decoded frame
+#define TELEMETRY_FRAME_STATUS 1
+#define TELEMETRY_FRAME_PROFILE 2
+#define TELEMETRY_FRAME_LOAD 3
+
+//* flags byte of the status frame
+#define TELEMETRY_FLAG_MOTOR 0x01
+#define TELEMETRY_FLAG_BRAKE 0x02
+//* a break (BKIN or MPWM_GenerateBreak) latched the TIM1 half bridges off, SPEEDCTRL_HBRIDGE drive only
+#define TELEMETRY_FLAG_BREAK 0x04
+
+//* wire format, all fields little endian, COBS encoded and ended by a 0x00 byte:
+//* type u8 | sequence u16 | time ms u32 | payload | CRC16-CCITT (0xFFFF) u16 over everything before it
+//* status payload: 4 x distance u16 | speedPerKm u8 | statusCode u8 | RPM u16 | targetKm u8 | referenceKm u8 |
+//*                 motor duty u16 | brake duty u16 | flags u8 | USART drops u16 | 4 x rejected readings u16 |
+//*                 4 x filtered distance u16
+//* profile payload: zone u8 | count u32 | min u32 | max u32 | mean u32 (cycles, see PROF_interface.h)
+//* load payload: idle us u32 | active us u32, since the previous load frame (see SCH_voidGetLoad)
+typedef struct
+{
+    u32 timeMs;
+    u16 distance[4]; //* raw sonar readings
+    SpeedData speed;
+    SpeedCtrlState control;
+    u8 flags;
+    u16 rejected[4]; //* sonar readings rejected by the filter (sonar_filter.h), free running
+    u16 filtered[4]; //* distances after the filter, what fusion and ACC work with
+} TelemetryStatus;
+
+void TELEMETRY_Init();
+//* builds, frames and queues one status frame on USART1
+void TELEMETRY_SendStatus(const TelemetryStatus *ptr_Status);
+//* builds, frames and queues the statistics of one profiling zone
+void TELEMETRY_SendProfile(u32 timeMs, u8 zone, const PROF_Stats_t *ptr_Stats);
+//* builds, frames and queues the idle / active time of the scheduler
+void TELEMETRY_SendLoad(u32 timeMs, const SCH_Load_t *ptr_Load);
+
+#endif
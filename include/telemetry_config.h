@@ -0,0 +1,7 @@
+#ifndef TELEMETRY_CONFIG
+#define TELEMETRY_CONFIG
+
+//* status frame rate, period of the telemetry task (a frame is 40 bytes on the wire)
+#define TELEMETRY_PERIOD_MS 100
+
+#endif
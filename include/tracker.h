@@ -0,0 +1,23 @@
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include "STD_TYPES.h"
+
+//* time to collision while the gap is not closing (or is more than 65 s away)
+#define TRACKER_TTC_NONE 0xFFFF
+
+typedef struct
+{
+    u8 valid;          //* 1 once a track is running
+    u16 gapCm;         //* filtered gap to the lead car
+    s16 relSpeedCmS;   //* lead speed - own speed, < 0 while closing
+    u16 ttcMs;         //* gap / closing speed, TRACKER_TTC_NONE when not closing
+} TrackerState;
+
+void TRACKER_Init();
+//* one forward gap reading taken at timeMs (sonar sample time stamp),
+//* returns STD_TYPES_NOK for a reading already seen (same time stamp)
+u8 TRACKER_u8Update(u32 timeMs, u16 gapCm);
+void TRACKER_GetState(TrackerState *ptr_State);
+
+#endif
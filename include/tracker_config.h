@@ -0,0 +1,15 @@
+#ifndef TRACKER_CONFIG
+#define TRACKER_CONFIG
+
+//* alpha-beta gains in Q8, tuned for one forward reading per sonar sweep (SONAR_CONVERSION_MS)
+//* alpha: share of the gap residual taken at once, beta: share turned into relative speed
+#define TRACKER_ALPHA_Q8 128
+#define TRACKER_BETA_Q8 32
+
+//* a gap older than this is dropped and the next reading restarts the track (at most 1000 ms)
+#define TRACKER_MAX_DT_MS 500
+
+//* relative speed limit in cm/s (50 m/s = 180 km/h), keeps the fixed point math in range
+#define TRACKER_MAX_SPEED_CM_S 5000
+
+#endif
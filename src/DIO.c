@@ -6,16 +6,13 @@
  */
 
 #include "BIT_MATH.h"
-#include "Dio.h"
+#include "DIO.h"
 #include "stm32f103C8.h"
 
-extern u16 PortA_DIO_OutputPins;
-extern u16 PortB_DIO_OutputPins;
-extern u16 PortC_DIO_OutputPins;
+extern u16 Port_DioOutputPins[DIO_PORT_COUNT];
+extern u16 Port_DioInputPins[DIO_PORT_COUNT];
 
-extern u16 PortA_DIO_InputPins;
-extern u16 PortB_DIO_InputPins;
-extern u16 PortC_DIO_InputPins;
+/* Register block and usable pins (PC13..PC15 only on port C) of every port */
 
 /*
  * Service name: Dio_ReadChannel
@@ -26,27 +23,17 @@ extern u16 PortC_DIO_InputPins;
  */
 Dio_LevelType Dio_ReadChannel( Dio_ChannelType ChannelId )
 {
-	switch(ChannelId/16)
+	Dio_PortType Port = DIO_CHANNEL_PORT(ChannelId);
+	u16 PinMask;
+
+	if(Port >= DIO_PORT_COUNT)
 	{
-	case DIO_PORTA:
-		return GET_BIT(((GPIOA->IDR) & (PortA_DIO_InputPins | PortA_DIO_OutputPins) ),(ChannelId%16));
-		break;
-	case DIO_PORTB:
-		return GET_BIT((GPIOB->IDR & (PortB_DIO_InputPins | PortB_DIO_OutputPins) ),(ChannelId%16));
-		break;
-	case DIO_PORTC:
-		if((ChannelId%16)>12){
-			return GET_BIT((GPIOC->IDR & (PortC_DIO_InputPins | PortC_DIO_OutputPins) ),(ChannelId%16));
-		}
-		else{
-			/* call DET with error code DIO_E_PARAM_INVALID_CHANNEL_ID */
-			return 0;
-		}
-		break;
-	default: /* call DET with error code DIO_E_PARAM_INVALID_CHANNEL_ID */
-		return 0;
-		break;
+		/* call DET with error code DIO_E_PARAM_INVALID_CHANNEL_ID */
+		return STD_LOW;
 	}
+	PinMask = Port_DioInputPins[Port] | Port_DioOutputPins[Port];
+
+	return GET_BIT((DIO_PORT_GPIO(Port)->IDR & PinMask), DIO_CHANNEL_PIN(ChannelId));
 }
 
 /*
@@ -55,40 +42,22 @@ Dio_LevelType Dio_ReadChannel( Dio_ChannelType ChannelId )
  * 					Level 		-> Value to be written
  * Return value: None
  * Description: Service to set a level of a channel.
+ * 				One BSRR store: the pin bit goes to the set half (STD_HIGH) or the reset half (STD_LOW),
+ * 				pins not configured as outputs give an empty (ignored) write.
  */
 void Dio_WriteChannel( Dio_ChannelType ChannelId, Dio_LevelType Level )
 {
-	switch(ChannelId/16)
+	Dio_PortType Port = DIO_CHANNEL_PORT(ChannelId);
+	u32 PinBit;
+
+	if(Port >= DIO_PORT_COUNT)
 	{
-		case DIO_PORTA:
-			switch(Level)
-			{
-			case STD_LOW: GPIOA->BRR = ((1<<(ChannelId%16)) & (PortA_DIO_OutputPins) );	break;
-			default: GPIOA->BSRR = ((1<<(ChannelId%16)) & (PortA_DIO_OutputPins) ); break;
-			}
-			break;
-		case DIO_PORTB:
-			switch(Level)
-			{
-			case STD_LOW: GPIOB->BRR = ((1<<(ChannelId%16)) & (PortB_DIO_OutputPins) );	break;
-			default: GPIOB->BSRR = ((1<<(ChannelId%16)) & (PortB_DIO_OutputPins) ); break;
-			}
-			break;
-		case DIO_PORTC:
-			if((ChannelId%16)>12){
-				switch(Level)
-				{
-				case STD_LOW: GPIOC->BRR = ((1<<(ChannelId%16)) & (PortC_DIO_OutputPins) );	break;
-				default: GPIOC->BSRR = ((1<<(ChannelId%16)) & (PortC_DIO_OutputPins) ); break;
-				}
-			}
-			else{
-				/* call DET with error code DIO_E_PARAM_INVALID_CHANNEL_ID */
-			}
-			break;
-		default: /* call DET with error code DIO_E_PARAM_INVALID_CHANNEL_ID */
-			break;
+		/* call DET with error code DIO_E_PARAM_INVALID_CHANNEL_ID */
+		return;
 	}
+	PinBit = (u32)((1 << DIO_CHANNEL_PIN(ChannelId)) & Port_DioOutputPins[Port]);
+
+	DIO_PORT_GPIO(Port)->BSRR = DIO_BSRR_VALUE(PinBit, Level);
 }
 
 /*
@@ -102,13 +71,13 @@ Dio_PortLevelType Dio_ReadPort( Dio_PortType PortId )
 	switch(PortId)
 	{
 	case DIO_PORTA:
-		return (0xFFFF & ((GPIOA->IDR) & (PortA_DIO_InputPins | PortA_DIO_OutputPins) ));
+		return (0xFFFF & ((GPIOA->IDR) & (Port_DioInputPins[DIO_PORTA] | Port_DioOutputPins[DIO_PORTA]) ));
 		break;
 	case DIO_PORTB:
-		return (0xFFFF & ((GPIOB->IDR) & (PortB_DIO_InputPins | PortB_DIO_OutputPins) ));
+		return (0xFFFF & ((GPIOB->IDR) & (Port_DioInputPins[DIO_PORTB] | Port_DioOutputPins[DIO_PORTB]) ));
 		break;
 	case DIO_PORTC:
-		return (0xE000 & ((GPIOC->IDR) & (PortC_DIO_InputPins | PortC_DIO_OutputPins) ));
+		return (0xE000 & ((GPIOC->IDR) & (Port_DioInputPins[DIO_PORTC] | Port_DioOutputPins[DIO_PORTC]) ));
 		break;
 	default: /* call DET with error code DIO_E_PARAM_INVALID_PORT_ID */
 		return 0;
@@ -127,16 +96,16 @@ void Dio_WritePort( Dio_PortType PortId, Dio_PortLevelType Level )
 	switch(PortId)
 	{
 	case DIO_PORTA:
-		GPIOA->BRR = (PortA_DIO_OutputPins);
-		GPIOA->BSRR = (Level & (PortA_DIO_OutputPins) );
+		GPIOA->BRR = (Port_DioOutputPins[DIO_PORTA]);
+		GPIOA->BSRR = (Level & (Port_DioOutputPins[DIO_PORTA]) );
 		break;
 	case DIO_PORTB:
-		GPIOB->BRR = (PortB_DIO_OutputPins);
-		GPIOB->BSRR = (Level & (PortB_DIO_OutputPins) );
+		GPIOB->BRR = (Port_DioOutputPins[DIO_PORTB]);
+		GPIOB->BSRR = (Level & (Port_DioOutputPins[DIO_PORTB]) );
 		break;
 	case DIO_PORTC:
-		GPIOC->BRR = (PortC_DIO_OutputPins);
-		GPIOC->BSRR = (Level & (PortC_DIO_OutputPins & 0xE000) );
+		GPIOC->BRR = (Port_DioOutputPins[DIO_PORTC]);
+		GPIOC->BSRR = (Level & (Port_DioOutputPins[DIO_PORTC] & 0xE000) );
 		break;
 	default: /* call DET with error code DIO_E_PARAM_INVALID_PORT_ID */
 		break;
@@ -155,14 +124,14 @@ Dio_PortLevelType Dio_ReadChannelGroup( const Dio_ChannelGroupType* ChannelGroup
 	switch(ChannelGroupIdPtr->port)
 	{
 	case DIO_PORTA:
-		TempPortVal = ChannelGroupIdPtr->mask & ((GPIOA->IDR) & (PortA_DIO_InputPins | PortA_DIO_OutputPins));
+		TempPortVal = ChannelGroupIdPtr->mask & ((GPIOA->IDR) & (Port_DioInputPins[DIO_PORTA] | Port_DioOutputPins[DIO_PORTA]));
 		break;
 	case DIO_PORTB:
-		TempPortVal = ChannelGroupIdPtr->mask & ((GPIOB->IDR) & (PortB_DIO_InputPins | PortB_DIO_OutputPins));
+		TempPortVal = ChannelGroupIdPtr->mask & ((GPIOB->IDR) & (Port_DioInputPins[DIO_PORTB] | Port_DioOutputPins[DIO_PORTB]));
 		break;
 	case DIO_PORTC:
 		if(ChannelGroupIdPtr->mask >= 0xE000){
-			TempPortVal = ChannelGroupIdPtr->mask & ((GPIOC->IDR) & (PortC_DIO_InputPins | PortC_DIO_OutputPins));
+			TempPortVal = ChannelGroupIdPtr->mask & ((GPIOC->IDR) & (Port_DioInputPins[DIO_PORTC] | Port_DioOutputPins[DIO_PORTC]));
 		}
 		else
 		{
@@ -191,15 +160,15 @@ void Dio_WriteChannelGroup( const Dio_ChannelGroupType* ChannelGroupIdPtr, Dio_P
 	{
 	case DIO_PORTA:
 		GPIOA->BRR = ChannelGroupIdPtr->mask;
-		GPIOA->BSRR = ( Level & (PortA_DIO_OutputPins) );
+		GPIOA->BSRR = ( Level & (Port_DioOutputPins[DIO_PORTA]) );
 		break;
 	case DIO_PORTB:
 		GPIOB->BRR = ChannelGroupIdPtr->mask;
-		GPIOB->BSRR = ( Level & (PortB_DIO_OutputPins) );
+		GPIOB->BSRR = ( Level & (Port_DioOutputPins[DIO_PORTB]) );
 		break;
 	case DIO_PORTC:
 			GPIOC->BRR = ((ChannelGroupIdPtr->mask) & 0xE000);
-			GPIOC->BSRR = (( Level & (PortC_DIO_OutputPins) ) & 0xE000);
+			GPIOC->BSRR = (( Level & (Port_DioOutputPins[DIO_PORTC]) ) & 0xE000);
 
 		break;
 	default: /* call DET with error code DIO_E_PARAM_INVALID_GROUP */
@@ -250,16 +219,16 @@ void Dio_MaskedWritePort( Dio_PortType PortId, Dio_PortLevelType Level, Dio_Port
 	switch(PortId)
 	{
 	case DIO_PORTA:
-		GPIOA->BRR = ( Mask & (PortB_DIO_OutputPins) );
-		GPIOA->BSRR = ( Level & (PortA_DIO_OutputPins) );
+		GPIOA->BRR = ( Mask & (Port_DioOutputPins[DIO_PORTA]) );
+		GPIOA->BSRR = ( Level & (Port_DioOutputPins[DIO_PORTA]) );
 		break;
 	case DIO_PORTB:
-		GPIOB->BRR = ( Mask & (PortB_DIO_OutputPins) );
-		GPIOB->BSRR = ( Level & (PortB_DIO_OutputPins) );
+		GPIOB->BRR = ( Mask & (Port_DioOutputPins[DIO_PORTB]) );
+		GPIOB->BSRR = ( Level & (Port_DioOutputPins[DIO_PORTB]) );
 		break;
 	case DIO_PORTC:
-		GPIOC->BRR = (( Mask & (PortB_DIO_OutputPins) ) & 0xE000);
-		GPIOC->BSRR = (( Level & (PortC_DIO_OutputPins) ) & 0xE000);
+		GPIOC->BRR = (( Mask & (Port_DioOutputPins[DIO_PORTC]) ) & 0xE000);
+		GPIOC->BSRR = (( Level & (Port_DioOutputPins[DIO_PORTC]) ) & 0xE000);
 		break;
 	default: /* call DET with error code DIO_E_PARAM_INVALID_GROUP */
 		break;
@@ -0,0 +1,155 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : DMA1                                    */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#include <BIT_MATH.h>
+#include <stm32f103C8.h>
+#include <STD_TYPES.h>
+#include <BIT_BAND.h>
+#include "DMA_interface.h"
+#include "DMA_private.h"
+#include "DMA_config.h"
+
+static void (*DMA_APF[DMA_NUMBER_OF_CHANNELS])(u8) = {NULL};
+
+u8 DMA_u8ChannelInit(u8 Copy_u8Channel, const DMA_ChannelConfig_t *Copy_pstrConfig)
+{
+	u8 Local_u8ErrorState = STD_TYPES_OK;
+	if ((Copy_u8Channel < DMA_NUMBER_OF_CHANNELS) && (Copy_pstrConfig != NULL))
+	{
+		/* Channel must be disabled while it is configured */
+		BITBAND_CLR(DMA1->Channel[Copy_u8Channel].CCR, DMA_CCR_EN);
+
+		DMA1->Channel[Copy_u8Channel].CCR = (Copy_pstrConfig->Priority << DMA_CCR_PL) |
+											(Copy_pstrConfig->MemSize << DMA_CCR_MSIZE) |
+											(Copy_pstrConfig->PeriphSize << DMA_CCR_PSIZE) |
+											(Copy_pstrConfig->MemIncrement << DMA_CCR_MINC) |
+											(Copy_pstrConfig->Circular << DMA_CCR_CIRC) |
+											(Copy_pstrConfig->Direction << DMA_CCR_DIR);
+	}
+	else
+	{
+		Local_u8ErrorState = STD_TYPES_NOK;
+	}
+	return Local_u8ErrorState;
+}
+
+u8 DMA_u8StartTransfer(u8 Copy_u8Channel, DMA_Address_t Copy_PeriphAdd, DMA_Address_t Copy_MemAdd, u16 Copy_u16Count)
+{
+	u8 Local_u8ErrorState = STD_TYPES_OK;
+	if ((Copy_u8Channel < DMA_NUMBER_OF_CHANNELS) && (Copy_u16Count != 0))
+	{
+		BITBAND_CLR(DMA1->Channel[Copy_u8Channel].CCR, DMA_CCR_EN);
+
+		/* Clear the old flags of the channel */
+		DMA1->IFCR = (0b1111 << DMA_ISR_GIF(Copy_u8Channel));
+
+		DMA1->Channel[Copy_u8Channel].CPAR = Copy_PeriphAdd;
+		DMA1->Channel[Copy_u8Channel].CMAR = Copy_MemAdd;
+		DMA1->Channel[Copy_u8Channel].CNDTR = Copy_u16Count;
+
+		/* Transfer complete and error interrupts, then enable the channel */
+		DMA1->Channel[Copy_u8Channel].CCR |= (1 << DMA_CCR_TCIE) | (1 << DMA_CCR_TEIE) |
+											 (DMA_HALF_TRANSFER_INT << DMA_CCR_HTIE) | (1 << DMA_CCR_EN);
+	}
+	else
+	{
+		Local_u8ErrorState = STD_TYPES_NOK;
+	}
+	return Local_u8ErrorState;
+}
+
+void DMA_voidStopTransfer(u8 Copy_u8Channel)
+{
+	if (Copy_u8Channel < DMA_NUMBER_OF_CHANNELS)
+	{
+		DMA1->Channel[Copy_u8Channel].CCR &= ~((1 << DMA_CCR_EN) | (1 << DMA_CCR_TCIE) | (1 << DMA_CCR_HTIE) | (1 << DMA_CCR_TEIE));
+		DMA1->IFCR = (0b1111 << DMA_ISR_GIF(Copy_u8Channel));
+	}
+}
+
+u16 DMA_u16GetRemaining(u8 Copy_u8Channel)
+{
+	u16 Local_u16Remaining = 0;
+	if (Copy_u8Channel < DMA_NUMBER_OF_CHANNELS)
+	{
+		Local_u16Remaining = (u16)DMA1->Channel[Copy_u8Channel].CNDTR;
+	}
+	return Local_u16Remaining;
+}
+
+u8 DMA_u8SetCallBack(u8 Copy_u8Channel, void (*Copy_pfCallBack)(u8 Copy_u8Event))
+{
+	u8 Local_u8ErrorState = STD_TYPES_OK;
+	if (Copy_u8Channel < DMA_NUMBER_OF_CHANNELS)
+	{
+		DMA_APF[Copy_u8Channel] = Copy_pfCallBack;
+	}
+	else
+	{
+		Local_u8ErrorState = STD_TYPES_NOK;
+	}
+	return Local_u8ErrorState;
+}
+
+/* Common channel ISR: clears the flags first so the callback may restart the channel */
+static void DMA_voidIRQHandler(u8 Copy_u8Channel)
+{
+	u32 Local_u32Status = DMA1->ISR;
+
+	DMA1->IFCR = (0b1111 << DMA_ISR_GIF(Copy_u8Channel));
+
+	if (DMA_APF[Copy_u8Channel] != NULL)
+	{
+		if (GET_BIT(Local_u32Status, DMA_ISR_TEIF(Copy_u8Channel)))
+		{
+			DMA_APF[Copy_u8Channel](DMA_EV_TRANSFER_ERROR);
+		}
+		else if (GET_BIT(Local_u32Status, DMA_ISR_TCIF(Copy_u8Channel)))
+		{
+			DMA_APF[Copy_u8Channel](DMA_EV_TRANSFER_CMPLT);
+		}
+		else if (GET_BIT(Local_u32Status, DMA_ISR_HTIF(Copy_u8Channel)))
+		{
+			DMA_APF[Copy_u8Channel](DMA_EV_HALF_TRANSFER);
+		}
+	}
+}
+
+/* ISR Imp */
+void DMA1_Channel1_IRQHandler(void)
+{
+	DMA_voidIRQHandler(DMA_CHANNEL1);
+}
+
+void DMA1_Channel2_IRQHandler(void)
+{
+	DMA_voidIRQHandler(DMA_CHANNEL2);
+}
+
+void DMA1_Channel3_IRQHandler(void)
+{
+	DMA_voidIRQHandler(DMA_CHANNEL3);
+}
+
+void DMA1_Channel4_IRQHandler(void)
+{
+	DMA_voidIRQHandler(DMA_CHANNEL4);
+}
+
+void DMA1_Channel5_IRQHandler(void)
+{
+	DMA_voidIRQHandler(DMA_CHANNEL5);
+}
+
+void DMA1_Channel6_IRQHandler(void)
+{
+	DMA_voidIRQHandler(DMA_CHANNEL6);
+}
+
+void DMA1_Channel7_IRQHandler(void)
+{
+	DMA_voidIRQHandler(DMA_CHANNEL7);
+}
@@ -5,6 +5,6 @@
  *      Author: Omar Gamal
  */
 
-#include "Dio.h"
+#include "DIO.h"
 
 
@@ -1,6 +1,7 @@
 #include <BIT_MATH.h>
 #include <stm32f103C8.h>
 #include <STD_TYPES.h>
+#include <BIT_BAND.h>
 #include "EXTI_interface.h"
 #include "EXTI_private.h"
 #include "EXTI_config.h"
@@ -25,16 +26,16 @@ u8 EXTI_u8PinInit(const EXTI_PinConfig_t *Copy_pstrPinInit)
 		switch (Copy_pstrPinInit->TriggerLevel)
 		{
 		case EXTI_u8_FALLING_EDGE:
-			CLR_BIT(EXTI->RTSR, Copy_pstrPinInit->PinNb);
-			SET_BIT(EXTI->FTSR, Copy_pstrPinInit->PinNb);
+			BITBAND_CLR(EXTI->RTSR, Copy_pstrPinInit->PinNb);
+			BITBAND_SET(EXTI->FTSR, Copy_pstrPinInit->PinNb);
 			break;
 		case EXTI_u8_RAISING_EDGE:
-			CLR_BIT(EXTI->FTSR, Copy_pstrPinInit->PinNb);
-			SET_BIT(EXTI->RTSR, Copy_pstrPinInit->PinNb);
+			BITBAND_CLR(EXTI->FTSR, Copy_pstrPinInit->PinNb);
+			BITBAND_SET(EXTI->RTSR, Copy_pstrPinInit->PinNb);
 			break;
 		case EXTI_u8_ANY_LOGICAL_CHANGE:
-			SET_BIT(EXTI->RTSR, Copy_pstrPinInit->PinNb);
-			SET_BIT(EXTI->FTSR, Copy_pstrPinInit->PinNb);
+			BITBAND_SET(EXTI->RTSR, Copy_pstrPinInit->PinNb);
+			BITBAND_SET(EXTI->FTSR, Copy_pstrPinInit->PinNb);
 			break;
 		default:
 			Local_u8ErrorState = STD_TYPES_NOK;
@@ -56,7 +57,7 @@ u8 EXTI_u8IntEnable(const EXTI_PinConfig_t *Copy_pstrPinInit)
 	if (Copy_pstrPinInit != NULL)
 	{
 		/* Enable the wanted EXTI */
-		SET_BIT(EXTI->IMR, Copy_pstrPinInit->PinNb);
+		BITBAND_SET(EXTI->IMR, Copy_pstrPinInit->PinNb);
 	}
 	else
 	{
@@ -71,7 +72,7 @@ u8 EXTI_u8IntDisable(const EXTI_PinConfig_t *Copy_pstrPinInit)
 	if (Copy_pstrPinInit != NULL)
 	{
 		/* Enable the wanted EXTI */
-		CLR_BIT(EXTI->IMR, Copy_pstrPinInit->PinNb);
+		BITBAND_CLR(EXTI->IMR, Copy_pstrPinInit->PinNb);
 	}
 	else
 	{
@@ -87,8 +88,8 @@ void EXTI0_IRQHandler(void)
 	{
 		EXTI_APF[0]();
 	}
-	/* Clear Pending Flag */
-	SET_BIT(EXTI->PR, 0);
+	/* Clear Pending Flag: PR is rc_w1, a read-modify-write would clear the other pending lines */
+	EXTI->PR = (1 << 0);
 }
 
 void EXTI1_IRQHandler(void)
@@ -97,6 +98,6 @@ void EXTI1_IRQHandler(void)
 	{
 		EXTI_APF[1]();
 	}
-	/* Clear Pending Flag */
-	SET_BIT(EXTI->PR, 1);
+	/* Clear Pending Flag: PR is rc_w1, a read-modify-write would clear the other pending lines */
+	EXTI->PR = (1 << 1);
 }
@@ -4,15 +4,13 @@
 #include "GPT_register.h"
 
 #include "GPT.h"
-#include "stm32f10x.h"
 
 
-TIM_TypeDef * const TimAddr[] =
+volatile TIMER_RegDef_t * const TimAddr[GPT_CHANNEL_CNT] =
 {
-		((TIM_TypeDef *)TIM2_BASE),
-		((TIM_TypeDef *)TIM3_BASE),
-		((TIM_TypeDef *)TIM4_BASE),
-		((TIM_TypeDef *)TIM5_BASE),
+		TIM2,
+		TIM3,
+		TIM4,
 };
 
 typedef struct
@@ -33,12 +31,14 @@ typedef enum
 {
 	GPT_STATE_STOPPED = 0,
 	GPT_STATE_STARTED,
+	GPT_STATE_EXPIRED,
 } Gpt_StateType;
 
 
 typedef struct
 {
 	Gpt_StateType state;
+	u8 notification;
 } Gpt_UnitType;
 
 Gpt_UnitType Gpt_Unit[GPT_CHANNEL_CNT];
@@ -46,17 +46,34 @@ Gpt_UnitType Gpt_Unit[GPT_CHANNEL_CNT];
 // Global config
 Gpt_GlobalType Gpt_Global;
 
+// Input capture (TIM2 CH1): 32-bit timestamps = software overflow count : CCR1
+static volatile u8 Gpt_CaptureActive = 0;
+static volatile u32 Gpt_CaptureOverflows = 0;
+static volatile u32 Gpt_LastCapture = 0;
+static volatile u32 Gpt_CapturePeriod = 0;
+static volatile u32 Gpt_CaptureEdges = 0;
+/* called from the TIM2 interrupt after every capture, the capture getters already hold the new edge */
+static void (*Gpt_CaptureNotification)(void) = NULL;
 
 
+#define GPT_IS_CONFIGURED(channel)	(((channel) < GPT_CHANNEL_CNT) && (Gpt_Global.configured & (1 << (channel))))
+
+// Timer driven by another driver: a reserved channel, or TIM2 while the hall input capture runs on it
+#define GPT_IS_FOREIGN(channel)		((GPT_RESERVED_CHANNELS & (1UL << (channel))) || \
+									 (((channel) == GPT_CHANNEL_TIM2) && Gpt_CaptureActive))
+
+#define GPT_CHANNEL_CONFIG(channel)	(&Gpt_Global.config[Gpt_Global.channelMap[channel]])
+
 
 void Gpt_Init(const Gpt_ConfigType *config)
 {
-	u32 GPT_CHANNEL_ILL;
 	u32 i=0;
 	const Gpt_ConfigType *cfg;
+	volatile TIMER_RegDef_t *tim;
 
 	Gpt_ChannelType ch;
 
+	Gpt_Global.configured = 0;
 	for (i=0; i<GPT_CHANNEL_CNT; i++)
 	{
 		Gpt_Global.channelMap[i] = GPT_CHANNEL_ILL;
@@ -68,9 +85,27 @@ void Gpt_Init(const Gpt_ConfigType *config)
 	{
 		ch = cfg->GptChannelId;
 
-		// Assign the configuration channel used later..
-		Gpt_Global.channelMap[cfg->GptChannelId] = i;
-		Gpt_Global.configured |= (1<<ch);
+		if ((ch < GPT_CHANNEL_CNT) && !GPT_IS_FOREIGN(ch))
+		{
+			// Assign the configuration channel used later..
+			Gpt_Global.channelMap[ch] = i;
+			Gpt_Global.configured |= (1<<ch);
+
+			// Up-counting time base, only overflows raise UIF so the UG of Gpt_StartTimer stays silent
+			tim = TimAddr[ch];
+			tim->CR1 = TIM_CR1_URS;
+			if (cfg->GptChannelMode == GPT_MODE_ONESHOT)
+			{
+				tim->CR1 |= TIM_CR1_OPM;
+			}
+			tim->DIER = 0;
+			tim->PSC = cfg->GptChannelPrescale;
+			tim->EGR = TIM_EGR_UG;
+			tim->SR = 0;
+
+			Gpt_Unit[ch].state = GPT_STATE_STOPPED;
+			Gpt_Unit[ch].notification = 0;
+		}
 
 		cfg++;
 		i++;
@@ -81,19 +116,60 @@ void Gpt_Init(const Gpt_ConfigType *config)
 }
 
 
+void Gpt_DeInit( void )
+{
+	Gpt_ChannelType ch;
+
+	for (ch = 0; ch < GPT_CHANNEL_CNT; ch++)
+	{
+		if (GPT_IS_CONFIGURED(ch) && !GPT_IS_FOREIGN(ch))
+		{
+			TimAddr[ch]->CR1 = 0;
+			TimAddr[ch]->DIER = 0;
+			TimAddr[ch]->SR = 0;
+			Gpt_Unit[ch].state = GPT_STATE_STOPPED;
+			Gpt_Unit[ch].notification = 0;
+		}
+	}
+
+	Gpt_Global.configured = 0;
+	Gpt_Global.config = NULL;
+}
+
+
+// The counter of a one-shot channel stops by itself at the update event
+static Gpt_StateType Gpt_GetState(Gpt_ChannelType channel)
+{
+	if ((Gpt_Unit[channel].state == GPT_STATE_STARTED) &&
+		(GPT_CHANNEL_CONFIG(channel)->GptChannelMode == GPT_MODE_ONESHOT) &&
+		!(TimAddr[channel]->CR1 & TIM_CR1_CEN))
+	{
+		Gpt_Unit[channel].state = GPT_STATE_EXPIRED;
+	}
+
+	return Gpt_Unit[channel].state;
+}
+
 
 
 Gpt_ValueType Gpt_GetTimeElapsed(Gpt_ChannelType channel)
 {
-	u32	timer;
-	if (channel <= GPT_CHANNEL_CNT)
+	Gpt_ValueType elapsed = 0;
+
+	if (GPT_IS_CONFIGURED(channel))
 	{
-		u32 *tlval = (u32 *)&(TimAddr[channel]->ARR);
-		u32 *tval = (u32 *)&(TimAddr[channel]->CNT);
-		timer = *tlval - *tval;
+		if (Gpt_GetState(channel) == GPT_STATE_EXPIRED)
+		{
+			elapsed = TimAddr[channel]->ARR + 1;
+		}
+		else
+		{
+			// counts up from 0, frozen at the value reached when the channel was stopped
+			elapsed = TimAddr[channel]->CNT;
+		}
 	}
 
-	return (timer);
+	return (elapsed);
 }
 
 
@@ -102,13 +178,11 @@ Gpt_ValueType Gpt_GetTimeElapsed(Gpt_ChannelType channel)
 
 Gpt_ValueType Gpt_GetTimeRemaining( Gpt_ChannelType channel ){
 
-	Gpt_ValueType remaining;
+	Gpt_ValueType remaining = 0;
 
-	if (channel <= GPT_CHANNEL_CNT)
+	if (GPT_IS_CONFIGURED(channel) && (Gpt_GetState(channel) == GPT_STATE_STARTED))
 	{
-		u32 *tval = (u32 *)&(TimAddr[channel]->CNT);
-		// Time remaining is the time until it hits 0, so just return the current timer value
-		remaining = *tval;
+		remaining = (TimAddr[channel]->ARR + 1) - TimAddr[channel]->CNT;
 	}
 
 	return remaining;
@@ -119,46 +193,51 @@ Gpt_ValueType Gpt_GetTimeRemaining( Gpt_ChannelType channel ){
 
 
 
-void Gpt_StartTimer(Gpt_ChannelType channel, Gpt_ValueType value)
+/* value: ticks until the expiry, GPT_VALUE_MIN to GPT_VALUE_MAX. A running channel is restarted.
+   STD_TYPES_NOK for a channel not configured, owned by another driver (GPT_RESERVED_CHANNELS,
+   TIM2 while the input capture runs) or a value out of range: the timer is left as it was */
+u8 Gpt_StartTimer(Gpt_ChannelType channel, Gpt_ValueType value)
 {
-	int confCh;
-
-	confCh = Gpt_Global.channelMap[channel];
+	volatile TIMER_RegDef_t *tim;
+	u8 status = STD_TYPES_NOK;
 
-	if (channel <= GPT_CHANNEL_CNT)
+	// TIM2 is the hall time base while the input capture runs
+	if (GPT_IS_CONFIGURED(channel) && (value >= GPT_VALUE_MIN) && (value <= GPT_VALUE_MAX) &&
+		!GPT_IS_FOREIGN(channel))
 	{
-		u32 *tlval = (u32 *)&(TimAddr[channel]->ARR);
-		u32 *tval = (u32 *)&(TimAddr[channel]->CNT);
+		tim = TimAddr[channel];
 
-		*tlval = value;
-		*tval = value;
+		tim->CR1 &= ~TIM_CR1_CEN;
+		tim->ARR = value - 1;
 
-		// always select interrupt
-		//TimAddr[channel]->DIER |= TIM_DIER_UIE;
+		// Reload the prescaler and restart the count from 0 (URS: no update interrupt)
+		tim->EGR = TIM_EGR_UG;
 
 		// Make sure that no interrupt is pending.
-		TimAddr[channel]->SR &= ~TIM_SR_UIF;
+		tim->SR = ~TIM_SR_UIF;
 
-		// Set prescaler.
-		TimAddr[channel]->PSC = Gpt_Global.config[confCh].GptChannelPrescale;
+		Gpt_Unit[channel].state = GPT_STATE_STARTED;
 
 		// Enable timer
-		TimAddr[channel]->CR1 |= (TIM_CR1_CEN | TIM_CR1_URS | TIM_CR1_DIR);
-		TimAddr[channel]->CR1 &= ~TIM_CR1_UDIS;
+		tim->CR1 |= TIM_CR1_CEN;
+		status = STD_TYPES_OK;
 	}
 
-
-
+	return status;
 }
 
 
 void Gpt_StopTimer(Gpt_ChannelType channel)
 {
 
-	if (channel <= GPT_CHANNEL_CNT)
+	if (GPT_IS_CONFIGURED(channel) && !GPT_IS_FOREIGN(channel))
 	{
 		// Disable timer
 		TimAddr[channel]->CR1 &= ~TIM_CR1_CEN;
+		if (Gpt_GetState(channel) == GPT_STATE_STARTED)
+		{
+			Gpt_Unit[channel].state = GPT_STATE_STOPPED;
+		}
 	}
 
 
@@ -169,8 +248,10 @@ void Gpt_EnableNotification( Gpt_ChannelType channel)
 {
 
 
-	if (channel <= GPT_CHANNEL_CNT)
+	if (GPT_IS_CONFIGURED(channel) && !GPT_IS_FOREIGN(channel) &&
+		(GPT_CHANNEL_CONFIG(channel)->GptNotification != NULL))
 	{
+		Gpt_Unit[channel].notification = 1;
 		// enable interrupts
 		TimAddr[channel]->DIER |= TIM_DIER_UIE;
 	}
@@ -181,8 +262,9 @@ void Gpt_EnableNotification( Gpt_ChannelType channel)
 void Gpt_DisableNotification( Gpt_ChannelType channel)
 {
 
-	if (channel <= GPT_CHANNEL_CNT)
+	if (GPT_IS_CONFIGURED(channel) && !GPT_IS_FOREIGN(channel))
 	{
+		Gpt_Unit[channel].notification = 0;
 		TimAddr[channel]->DIER &= ~TIM_DIER_UIE;
 	}
 
@@ -190,6 +272,57 @@ void Gpt_DisableNotification( Gpt_ChannelType channel)
 }
 
 
+/* Timer ticks of a channel, rounded up so that a timeout never expires early */
+Gpt_ValueType Gpt_u32UsToTicks(Gpt_ChannelType channel, u32 us)
+{
+	u32 divider;
+
+	if (!GPT_IS_CONFIGURED(channel))
+	{
+		return 0;
+	}
+	divider = GPT_CHANNEL_CONFIG(channel)->GptChannelPrescale + 1;
+
+	return (Gpt_ValueType)((((u64)us * GPT_TIMER_CLK_MHZ) + divider - 1) / divider);
+}
+
+Gpt_ValueType Gpt_u32MsToTicks(Gpt_ChannelType channel, u32 ms)
+{
+	return Gpt_u32UsToTicks(channel, ms * 1000);
+}
+
+u32 Gpt_u32TicksToUs(Gpt_ChannelType channel, Gpt_ValueType ticks)
+{
+	if (!GPT_IS_CONFIGURED(channel))
+	{
+		return 0;
+	}
+
+	return (u32)(((u64)ticks * (GPT_CHANNEL_CONFIG(channel)->GptChannelPrescale + 1)) / GPT_TIMER_CLK_MHZ);
+}
+
+
+/* Update event of a channel: one-shot channels expire, the notification runs in the TIMx interrupt */
+static void Gpt_Dispatch(Gpt_ChannelType channel)
+{
+	volatile TIMER_RegDef_t *tim = TimAddr[channel];
+
+	if (tim->SR & TIM_SR_UIF)
+	{
+		tim->SR = ~TIM_SR_UIF;
+
+		if (GPT_IS_CONFIGURED(channel))
+		{
+			Gpt_GetState(channel);
+			if (Gpt_Unit[channel].notification)
+			{
+				GPT_CHANNEL_CONFIG(channel)->GptNotification();
+			}
+		}
+	}
+}
+
+
 
 
 
@@ -204,10 +337,19 @@ void Gpt_SetMode( Gpt_ModeType mode )
 	{
 	case GPT_MODE_NORMAL :  ;break;
 
-	case GPT_MODE_SLEEP :for (i= 0; i <= GPT_CHANNEL_CNT; i++)
+	/* The PWM outputs are set up by Gpt_SetPWMMode and the PWM driver, nothing to switch here */
+	case GPT_MODE_PWM :  ;break;
+
+	case GPT_MODE_SLEEP :for (i= 0; i < GPT_CHANNEL_CNT; i++)
 	{
 		Gpt_StopTimer(i);
-	}; break;
+	}
+	if (Gpt_CaptureActive)
+	{
+		TIM2->CR1 &= ~TIM_CR1_CEN;
+		Gpt_CaptureActive = 0;
+	}
+	break;
 
 
 	case External_Clock_MODE : 	TIM2->SMCR = 0x4056 ;    /* 1- No Filter
@@ -227,6 +369,29 @@ void Gpt_SetMode( Gpt_ModeType mode )
 
 	TIM2->CCER =0 ;
 	TIM2->CNT = 0 ;
+	Gpt_CaptureActive = 0 ;
+	break;
+
+	case Input_Capture_MODE :
+	TIM2->CR1 = 0 ;
+	TIM2->SMCR = 0 ;                       /* internal clock */
+	TIM2->PSC = GPT_CAPTURE_PRESCALE ;     /* one count every GPT_CAPTURE_TICK_US */
+	TIM2->ARR = 0xFFFF ;
+	TIM2->CCMR1 = 0x0031 ;                 /* 1- CC1 is an input mapped on TI1
+	                                          2- no input prescaler
+	                                          3- filter fSAMPLING = fCK_INT, N = 8 against contact bounce
+	 */
+	TIM2->CCER = TIM_CCER_CC1E ;           /* capture on rising edge */
+	TIM2->EGR = TIM_EGR_UG ;               /* load the prescaler */
+
+	Gpt_CaptureActive = 1 ;
+	Gpt_CaptureOverflows = 0 ;
+	Gpt_CaptureEdges = 0 ;
+	Gpt_CapturePeriod = 0 ;
+
+	TIM2->SR = 0 ;
+	TIM2->DIER = TIM_DIER_CC1IE | TIM_DIER_UIE ;
+	TIM2->CR1 = TIM_CR1_CEN ;
 	break;
 	}
 
@@ -240,42 +405,127 @@ u16 Gpt_u16GetCounter(){
 
 void Gpt_SetPWMMode( u8 select ){
 
-	u8 i;
+	TIM4->CCMR2 =0x6800;
+	TIM4->EGR =0x0001;
+	switch(select)
+	{
+	case PWM_edge_aligned_mode_UP :TIM4->CR1 =0x0080; break;
 
-	for (i= 0; i <= GPT_CHANNEL_CNT; i++){
+	case PWM_edge_aligned_mode_DOWN : TIM4->CR1 =0x0090; break;
 
-		TIM4->CCMR2 =0x6800;
-		TIM4->EGR =0x0001;
-		switch(select)
-		{
-		case PWM_edge_aligned_mode_UP :TIM4->CR1 =0x0080; break;
+	case PWM_center_aligned_mode1 :SET_BIT(TIM4->CR1,7);
+	SET_BIT(TIM4->CR1,5); break;
 
-		case PWM_edge_aligned_mode_DOWN : TIM4->CR1 =0x0090; break;
+	case PWM_center_aligned_mode2: SET_BIT(TIM4->CR1,7);
+	SET_BIT(TIM4->CR1,6); break;
 
-		case PWM_center_aligned_mode1 :SET_BIT(TIM4->CR1,7);
-		SET_BIT(TIM4->CR1,5); break;
+	case PWM_center_aligned_mode3 :	SET_BIT(TIM4->CR1,7);
+	SET_BIT(TIM4->CR1,6);
+	SET_BIT(TIM4->CR1,5);
+	break;
+
+
+	}
 
-		case PWM_center_aligned_mode2: SET_BIT(TIM4->CR1,7);
-		SET_BIT(TIM4->CR1,6); break;
+}
 
-		case PWM_center_aligned_mode3 :	SET_BIT(TIM4->CR1,7);
-		SET_BIT(TIM4->CR1,6);
-		SET_BIT(TIM4->CR1,5);
-		break;
+/* Callback of every input capture edge, runs in the TIM2 interrupt, NULL disables it */
+void Gpt_SetCaptureNotification(void (*notification)(void))
+{
+	Gpt_CaptureNotification = notification;
+}
 
+/* Time base of the input capture in GPT_CAPTURE_TICK_US, extended to 32 bits */
+u32 Gpt_u32GetCaptureTime(void)
+{
+	u32 overflows;
+	u32 counter;
 
+	do
+	{
+		overflows = Gpt_CaptureOverflows;
+		counter = TIM2->CNT;
+		/* wrap not yet seen by the ISR */
+		if ((TIM2->SR & TIM_SR_UIF) && (counter < 0x8000))
+		{
+			overflows++;
 		}
+	} while (overflows < Gpt_CaptureOverflows);
 
-	}
+	return (overflows << 16) | counter;
+}
 
+/* Time between the last two captured edges, 0 until two edges were seen */
+u32 Gpt_u32GetCapturePeriod(void)
+{
+	return Gpt_CapturePeriod;
 }
 
+/* Timestamp of the last captured edge */
+u32 Gpt_u32GetLastCaptureTime(void)
+{
+	return Gpt_LastCapture;
+}
 
+/* Number of captured edges since the capture mode was set */
+u32 Gpt_u32GetCaptureEdgeCount(void)
+{
+	return Gpt_CaptureEdges;
+}
 
+void TIM2_IRQHandler(void)
+{
+	u32 sr = TIM2->SR;
+	u32 overflows = Gpt_CaptureOverflows;
+	u32 capture;
 
+	if (!Gpt_CaptureActive)
+	{
+		Gpt_Dispatch(GPT_CHANNEL_TIM2);
+		return;
+	}
 
+	if (sr & TIM_SR_CC1IF)
+	{
+		/* reading CCR1 clears CC1IF */
+		capture = TIM2->CCR1;
 
+		/* capture taken right after a wrap whose update is still pending belongs to the new period */
+		if ((sr & TIM_SR_UIF) && (capture < 0x8000))
+		{
+			capture |= (overflows + 1) << 16;
+		}
+		else
+		{
+			capture |= overflows << 16;
+		}
 
+		if (Gpt_CaptureEdges != 0)
+		{
+			Gpt_CapturePeriod = capture - Gpt_LastCapture;
+		}
+		Gpt_LastCapture = capture;
+		Gpt_CaptureEdges++;
 
+		if (Gpt_CaptureNotification != NULL)
+		{
+			Gpt_CaptureNotification();
+		}
+	}
 
+	if (sr & TIM_SR_UIF)
+	{
+		TIM2->SR = ~TIM_SR_UIF;
+		Gpt_CaptureOverflows = overflows + 1;
+	}
+}
+
+void TIM3_IRQHandler(void)
+{
+	Gpt_Dispatch(GPT_CHANNEL_TIM3);
+}
 
+void TIM4_IRQHandler(void)
+{
+	Gpt_Dispatch(GPT_CHANNEL_TIM4);
+}
@@ -8,10 +8,37 @@
 #include "BIT_MATH.h"
 #include "STD_TYPES.h"
 #include "stm32f103C8.h"
-#include "I2C_private.h"
+#include "BIT_BAND.h"
 
-#include "I2C_config.h"
+#include "DMA_interface.h"
+#include "PROF_interface.h"
 #include "I2C_interface.h"
+#include "I2C_private.h"
+#include "I2C_config.h"
+
+/* Transaction engine handles for I2C1 and I2C2 */
+static I2C_Handle_t I2C_Handle[I2C_NUMBER_OF_PERIPHERALS] =
+{
+	{ .TxDmaChannel = I2C1_TX_DMA_CHANNEL, .RxDmaChannel = I2C1_RX_DMA_CHANNEL },
+	{ .TxDmaChannel = I2C2_TX_DMA_CHANNEL, .RxDmaChannel = I2C2_RX_DMA_CHANNEL },
+};
+
+/* Byte transfers between the I2C data register and memory */
+static const DMA_ChannelConfig_t I2C_DmaTxConfig =
+{
+	.Direction = DMA_MEM_TO_PERIPH, .PeriphSize = DMA_SIZE_8BIT, .MemSize = DMA_SIZE_8BIT,
+	.MemIncrement = DMA_ENABLE, .Circular = DMA_DISABLE, .Priority = DMA_PRIORITY_HIGH
+};
+static const DMA_ChannelConfig_t I2C_DmaRxConfig =
+{
+	.Direction = DMA_PERIPH_TO_MEM, .PeriphSize = DMA_SIZE_8BIT, .MemSize = DMA_SIZE_8BIT,
+	.MemIncrement = DMA_ENABLE, .Circular = DMA_DISABLE, .Priority = DMA_PRIORITY_HIGH
+};
+
+static void I2C1_voidDmaTxCallBack(u8 Event);
+static void I2C1_voidDmaRxCallBack(u8 Event);
+static void I2C2_voidDmaTxCallBack(u8 Event);
+static void I2C2_voidDmaRxCallBack(u8 Event);
 
 /*
  * I2C_voidExcuteSendAddress: Sends the 7-bit slave address after adding the LSB representing whether the master wants to transmit or receive data from the slave
@@ -89,6 +116,21 @@ void I2C_voidInit(u8 I2Cx)
 
 	/* Setting Own Address */
 	pI2Cx->OAR1 = (1<<14) | (I2C1_DeviceAddress << 1);
+
+	/* Hooking the DMA channels of the peripheral to the transaction engine */
+	switch(I2Cx)
+	{
+	case I2C1:
+		DMA_u8SetCallBack(I2C1_TX_DMA_CHANNEL, I2C1_voidDmaTxCallBack);
+		DMA_u8SetCallBack(I2C1_RX_DMA_CHANNEL, I2C1_voidDmaRxCallBack);
+		break;
+	case I2C2:
+		DMA_u8SetCallBack(I2C2_TX_DMA_CHANNEL, I2C2_voidDmaTxCallBack);
+		DMA_u8SetCallBack(I2C2_RX_DMA_CHANNEL, I2C2_voidDmaRxCallBack);
+		break;
+	default:
+		break;
+	}
 }
 
 /*
@@ -196,6 +238,25 @@ void I2C_voidMasterReceiveData(u8 I2Cx, u8 * pTxBuffer, u8 Len, u8 SlaveAdd)
 		/* Read Data from DR register */
 		pTxBuffer[0] = pI2Cx->DR;
 		break;
+	case 2:
+		/* NACK has to be programmed for the second byte (POS) before ADDR is cleared */
+		I2C_VOID_DISABLE_ACK(pI2Cx);
+		BITBAND_SET(pI2Cx->CR1, I2C_CR1_POS);
+
+		/* Reset ADDR by reading SR2 register (SR1 was already read in the previous step)*/
+		(void)GET_BIT(pI2Cx->SR2, I2C_SR2_MSL);
+
+		/* Wait until both bytes are received (data 1 in DR, data 2 in the shift register) */
+		while(! GET_BIT(pI2Cx->SR1, I2C_SR1_BTF));
+
+		I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+
+		/* Read Data from DR register */
+		pTxBuffer[0] = pI2Cx->DR;
+		pTxBuffer[1] = pI2Cx->DR;
+
+		BITBAND_CLR(pI2Cx->CR1, I2C_CR1_POS);
+		break;
 	default:
 		I2C_VOID_ENABLE_ACK(pI2Cx);
 		/* Reset ADDR by reading SR2 register (SR1 was already read in the previous step)*/
@@ -222,6 +283,12 @@ void I2C_voidMasterReceiveData(u8 I2Cx, u8 * pTxBuffer, u8 Len, u8 SlaveAdd)
 		break;
 	}
 
+	/* Back to the configured ACK, the next reception must not NACK its first byte */
+	if(I2C1_ACKControl == I2C_ACK_ENABLE)
+	{
+		I2C_VOID_ENABLE_ACK(pI2Cx);
+	}
+
 	__asm("NOP");
 }
 
@@ -238,11 +305,394 @@ void I2C_voidPeripheralControl(u8 I2Cx, u8 EnOrDi)
 	{
 	case I2C_ENABLE:
 		/* Enabling the peripheral */
-		SET_BIT(pI2Cx->CR1, I2C_CR1_PE);
+		BITBAND_SET(pI2Cx->CR1, I2C_CR1_PE);
 		break;
 	case I2C_DISABLE:
 		/* Disabling the peripheral */
-		CLR_BIT(pI2Cx->CR1, I2C_CR1_PE);
+		BITBAND_CLR(pI2Cx->CR1, I2C_CR1_PE);
 		break;
 	}
 }
+
+/*
+ * I2C_voidCloseTransaction: Disables the engine interrupts, releases the handle and notifies the application.
+ * parameters:	pI2Cx:  (pointer to I2C_RegDef_t type) The base address of the I2C peripheral.
+ * 				I2Cx: (u8) The I2C name macro Values: I2C1, I2C2.
+ * 				AppEv: (u8) Event passed to the transaction callback.
+ */
+static void I2C_voidCloseTransaction(I2C_RegDef_t *pI2Cx, u8 I2Cx, u8 AppEv)
+{
+	I2C_Handle_t * pHandle = &I2C_Handle[I2C_HANDLE_INDEX(I2Cx)];
+
+	pI2Cx->CR2 &= ~(I2C_CR2_IT_MASK | I2C_CR2_DMA_MASK);
+
+	/* The one and two byte receptions NACK through ACK / POS, back to the configured ACK for the next transaction */
+	BITBAND_CLR(pI2Cx->CR1, I2C_CR1_POS);
+	if(I2C1_ACKControl == I2C_ACK_ENABLE)
+	{
+		I2C_VOID_ENABLE_ACK(pI2Cx);
+	}
+	if(pHandle->Transaction.TransferMode == I2C_MODE_DMA)
+	{
+		DMA_voidStopTransfer(pHandle->TxDmaChannel);
+		DMA_voidStopTransfer(pHandle->RxDmaChannel);
+	}
+	pHandle->State = I2C_STATE_READY;
+	PROF_END(PROF_ZONE_I2C1_TRANSACTION + I2C_HANDLE_INDEX(I2Cx));
+
+	if(pHandle->Transaction.pfCallBack != NULL)
+	{
+		pHandle->Transaction.pfCallBack(I2Cx, AppEv);
+	}
+}
+
+/*
+ * I2C_u8SubmitTransaction: Starts a non-blocking master transaction driven by the event/error interrupts.
+ * Parameters:  I2Cx: (u8) The I2C name macro Values: I2C1, I2C2.
+ * 				pTransaction: (pointer to I2C_Transaction_t) The transaction to execute, it is copied by the driver.
+ * Return type: u8 STD_TYPES_OK if the transaction was started, STD_TYPES_NOK if the engine is busy or the parameters are invalid.
+ */
+u8 I2C_u8SubmitTransaction(u8 I2Cx, const I2C_Transaction_t * pTransaction)
+{
+	I2C_RegDef_t * pI2Cx = I2C_GetBaseAdd(I2Cx);
+	I2C_Handle_t * pHandle;
+
+	if((pI2Cx == NULL) || (pTransaction == NULL) || ((pTransaction->TxLen == 0) && (pTransaction->RxLen == 0)))
+	{
+		return STD_TYPES_NOK;
+	}
+
+	pHandle = &I2C_Handle[I2C_HANDLE_INDEX(I2Cx)];
+	if((pHandle->State != I2C_STATE_READY) || GET_BIT(pI2Cx->SR2, I2C_SR2_BUSY))
+	{
+		return STD_TYPES_NOK;
+	}
+
+	PROF_BEGIN(PROF_ZONE_I2C1_TRANSACTION + I2C_HANDLE_INDEX(I2Cx));
+	pHandle->Transaction = *pTransaction;
+	pHandle->TxCount = 0;
+	pHandle->RxCount = 0;
+	pHandle->State = (pTransaction->TxLen != 0) ? I2C_STATE_BUSY_TX : I2C_STATE_BUSY_RX;
+
+	if(I2C_DMA_PHASE(pHandle) && (pHandle->State == I2C_STATE_BUSY_TX))
+	{
+		/* The write phase is armed now, DMA requests only start once the address is acknowledged */
+		DMA_u8ChannelInit(pHandle->TxDmaChannel, &I2C_DmaTxConfig);
+		DMA_u8StartTransfer(pHandle->TxDmaChannel, (DMA_Address_t)&pI2Cx->DR, (DMA_Address_t)pTransaction->pTxBuffer, pTransaction->TxLen);
+		BITBAND_SET(pI2Cx->CR2, I2C_CR2_DMAEN);
+
+		/* Event and error interrupts only, the buffer interrupt would steal the DMA requests */
+		pI2Cx->CR2 |= (1 << I2C_CR2_ITEVTEN) | (1 << I2C_CR2_ITERREN);
+	}
+	else
+	{
+		/* Enable event, buffer and error interrupts, the rest is done by the ISRs */
+		pI2Cx->CR2 |= I2C_CR2_IT_MASK;
+	}
+	I2C_VOID_SEND_START_CONDITION(pI2Cx);
+
+	return STD_TYPES_OK;
+}
+
+/*
+ * I2C_u8GetState: Returns the state of the transaction engine.
+ * Parameters:  I2Cx: (u8) The I2C name macro Values: I2C1, I2C2.
+ * Return type: u8 I2C_STATE_READY, I2C_STATE_BUSY_TX or I2C_STATE_BUSY_RX.
+ */
+u8 I2C_u8GetState(u8 I2Cx)
+{
+	if(I2C_GetBaseAdd(I2Cx) == NULL)
+	{
+		return I2C_STATE_READY;
+	}
+	return I2C_Handle[I2C_HANDLE_INDEX(I2Cx)].State;
+}
+
+/*
+ * I2C_voidAbortTransaction: Stops the running transaction, releases the bus and calls its callback with I2C_EV_ABORTED.
+ * Parameters:  I2Cx: (u8) The I2C name macro Values: I2C1, I2C2.
+ * Return type: void.
+ */
+void I2C_voidAbortTransaction(u8 I2Cx)
+{
+	I2C_RegDef_t * pI2Cx = I2C_GetBaseAdd(I2Cx);
+
+	if((pI2Cx != NULL) && (I2C_Handle[I2C_HANDLE_INDEX(I2Cx)].State != I2C_STATE_READY))
+	{
+		pI2Cx->CR2 &= ~I2C_CR2_IT_MASK;
+		I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+		/* A pending ADDR stretches SCL, the stop only goes out once it is cleared */
+		I2C_VOID_CLEAR_ADDR(pI2Cx);
+		I2C_voidCloseTransaction(pI2Cx, I2Cx, I2C_EV_ABORTED);
+	}
+}
+
+/*
+ * I2C_voidHandleAddr: ADDR event, prepares ACK/POS/STOP according to the number of bytes to receive (RM0008 26.3.3).
+ */
+static void I2C_voidHandleAddr(I2C_RegDef_t *pI2Cx, I2C_Handle_t *pHandle)
+{
+	u8 RxLen = pHandle->Transaction.RxLen;
+
+	if(pHandle->State == I2C_STATE_BUSY_TX)
+	{
+		I2C_VOID_CLEAR_ADDR(pI2Cx);
+	}
+	else if(I2C_DMA_PHASE(pHandle))
+	{
+		/* DMA reception: LAST makes the hardware NACK the byte after the DMA end of transfer */
+		DMA_u8ChannelInit(pHandle->RxDmaChannel, &I2C_DmaRxConfig);
+		DMA_u8StartTransfer(pHandle->RxDmaChannel, (DMA_Address_t)&pI2Cx->DR, (DMA_Address_t)pHandle->Transaction.pRxBuffer, RxLen);
+		pI2Cx->CR2 |= I2C_CR2_DMA_MASK;
+		BITBAND_CLR(pI2Cx->CR2, I2C_CR2_ITBUFEN);
+		if(RxLen == 2)
+		{
+			/* F103 two byte case: NACK goes with the second byte through POS, EOT comes after the first */
+			I2C_VOID_DISABLE_ACK(pI2Cx);
+			BITBAND_SET(pI2Cx->CR1, I2C_CR1_POS);
+		}
+		else
+		{
+			I2C_VOID_ENABLE_ACK(pI2Cx);
+		}
+		I2C_VOID_CLEAR_ADDR(pI2Cx);
+	}
+	else if(RxLen == 1)
+	{
+		/* Single byte: NACK it and program the stop before ADDR is cleared */
+		I2C_VOID_DISABLE_ACK(pI2Cx);
+		I2C_VOID_CLEAR_ADDR(pI2Cx);
+		I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+		BITBAND_SET(pI2Cx->CR2, I2C_CR2_ITBUFEN);
+	}
+	else if(RxLen == 2)
+	{
+		/* Two bytes: POS makes the NACK apply to the second byte, both are read on BTF */
+		I2C_VOID_DISABLE_ACK(pI2Cx);
+		BITBAND_SET(pI2Cx->CR1, I2C_CR1_POS);
+		I2C_VOID_CLEAR_ADDR(pI2Cx);
+		BITBAND_CLR(pI2Cx->CR2, I2C_CR2_ITBUFEN);
+	}
+	else
+	{
+		/* Three bytes or more: RXNE until three are left, then BTF based end of reception */
+		I2C_VOID_ENABLE_ACK(pI2Cx);
+		I2C_VOID_CLEAR_ADDR(pI2Cx);
+		if(RxLen == 3)
+		{
+			BITBAND_CLR(pI2Cx->CR2, I2C_CR2_ITBUFEN);
+		}
+		else
+		{
+			BITBAND_SET(pI2Cx->CR2, I2C_CR2_ITBUFEN);
+		}
+	}
+}
+
+/*
+ * I2C_voidEventHandler: Advances the transaction of I2Cx on every event interrupt.
+ */
+static void I2C_voidEventHandler(u8 I2Cx)
+{
+	I2C_RegDef_t * pI2Cx = I2C_GetBaseAdd(I2Cx);
+	I2C_Handle_t * pHandle = &I2C_Handle[I2C_HANDLE_INDEX(I2Cx)];
+	I2C_Transaction_t * pTrans = &pHandle->Transaction;
+	u32 SR1 = pI2Cx->SR1;
+	u8 Remaining;
+
+	if(pHandle->State == I2C_STATE_READY)
+	{
+		/* Spurious event, nothing is running */
+		pI2Cx->CR2 &= ~I2C_CR2_IT_MASK;
+	}
+	else if(GET_BIT(SR1, I2C_SR1_SB))
+	{
+		/* Start or repeated start generated, send the address with the direction of the current phase */
+		I2C_voidExicuteSendAddress(pI2Cx, pTrans->SlaveAdd, (pHandle->State == I2C_STATE_BUSY_RX) ? I2C_RECEIVE : I2C_TRANSMIT);
+	}
+	else if(GET_BIT(SR1, I2C_SR1_ADDR))
+	{
+		I2C_voidHandleAddr(pI2Cx, pHandle);
+	}
+	else if(pHandle->State == I2C_STATE_BUSY_TX)
+	{
+		if(pHandle->TxCount < pTrans->TxLen)
+		{
+			/* In DMA mode the data bytes are written by the DMA, TxCount is completed by its callback */
+			if(GET_BIT(SR1, I2C_SR1_TXE) && (pTrans->TransferMode == I2C_MODE_INTERRUPT))
+			{
+				pI2Cx->DR = pTrans->pTxBuffer[pHandle->TxCount++];
+				if(pHandle->TxCount == pTrans->TxLen)
+				{
+					/* Last byte written, wait for BTF only */
+					BITBAND_CLR(pI2Cx->CR2, I2C_CR2_ITBUFEN);
+				}
+			}
+		}
+		else if(GET_BIT(SR1, I2C_SR1_BTF))
+		{
+			if(pTrans->RxLen != 0)
+			{
+				/* Write phase done, switch direction with a repeated start */
+				pHandle->State = I2C_STATE_BUSY_RX;
+				I2C_VOID_SEND_START_CONDITION(pI2Cx);
+			}
+			else
+			{
+				if(pTrans->RepeatedState == I2C_NO_REPEAT_S)
+				{
+					I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+				}
+				I2C_voidCloseTransaction(pI2Cx, I2Cx, I2C_EV_CMPLT);
+			}
+		}
+	}
+	else if(! I2C_DMA_PHASE(pHandle))
+	{
+		Remaining = pTrans->RxLen - pHandle->RxCount;
+		if(GET_BIT(SR1, I2C_SR1_BTF) && (Remaining == 3))
+		{
+			/* N-2 in DR, N-1 in shift register: NACK the last byte */
+			I2C_VOID_DISABLE_ACK(pI2Cx);
+			pTrans->pRxBuffer[pHandle->RxCount++] = pI2Cx->DR;
+		}
+		else if(GET_BIT(SR1, I2C_SR1_BTF) && (Remaining == 2))
+		{
+			I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+			pTrans->pRxBuffer[pHandle->RxCount++] = pI2Cx->DR;
+			pTrans->pRxBuffer[pHandle->RxCount++] = pI2Cx->DR;
+			I2C_voidCloseTransaction(pI2Cx, I2Cx, I2C_EV_CMPLT);
+		}
+		else if(GET_BIT(SR1, I2C_SR1_RXNE) || GET_BIT(SR1, I2C_SR1_BTF))
+		{
+			/* A late handler also finds BTF set further from the end, DR is read the same way or BTF never clears */
+			pTrans->pRxBuffer[pHandle->RxCount++] = pI2Cx->DR;
+			if(Remaining == 1)
+			{
+				I2C_voidCloseTransaction(pI2Cx, I2Cx, I2C_EV_CMPLT);
+			}
+			else if(Remaining == 4)
+			{
+				/* Three bytes left, finish on BTF */
+				BITBAND_CLR(pI2Cx->CR2, I2C_CR2_ITBUFEN);
+			}
+		}
+	}
+}
+
+/*
+ * I2C_voidErrorHandler: Clears the error flags of I2Cx and ends the running transaction with the matching error event.
+ */
+static void I2C_voidErrorHandler(u8 I2Cx)
+{
+	I2C_RegDef_t * pI2Cx = I2C_GetBaseAdd(I2Cx);
+	u32 SR1 = pI2Cx->SR1;
+	u8 AppEv = I2C_ERROR_BERR;
+
+	if(GET_BIT(SR1, I2C_SR1_BERR))
+	{
+		BITBAND_CLR(pI2Cx->SR1, I2C_SR1_BERR);
+		AppEv = I2C_ERROR_BERR;
+	}
+	if(GET_BIT(SR1, I2C_SR1_ARLO))
+	{
+		/* Arbitration lost: the hardware already released the bus */
+		BITBAND_CLR(pI2Cx->SR1, I2C_SR1_ARLO);
+		AppEv = I2C_ERROR_ARLO;
+	}
+	if(GET_BIT(SR1, I2C_SR1_AF))
+	{
+		/* NACK from the slave: the master has to release the bus */
+		BITBAND_CLR(pI2Cx->SR1, I2C_SR1_AF);
+		I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+		AppEv = I2C_ERROR_AF;
+	}
+	if(GET_BIT(SR1, I2C_SR1_OVR))
+	{
+		BITBAND_CLR(pI2Cx->SR1, I2C_SR1_OVR);
+		AppEv = I2C_ERROR_OVR;
+	}
+	if(GET_BIT(SR1, I2C_SR1_TIMEOUT))
+	{
+		BITBAND_CLR(pI2Cx->SR1, I2C_SR1_TIMEOUT);
+		AppEv = I2C_ERROR_TIMEOUT;
+	}
+
+	if(I2C_Handle[I2C_HANDLE_INDEX(I2Cx)].State != I2C_STATE_READY)
+	{
+		I2C_voidCloseTransaction(pI2Cx, I2Cx, AppEv);
+	}
+}
+
+/*
+ * I2C_voidDmaHandler: End of a DMA phase of I2Cx. The write phase still finishes on BTF (event ISR),
+ * 		the read phase ends here since the last byte was NACKed by the hardware (LAST / POS).
+ */
+static void I2C_voidDmaHandler(u8 I2Cx, u8 Event)
+{
+	I2C_RegDef_t * pI2Cx = I2C_GetBaseAdd(I2Cx);
+	I2C_Handle_t * pHandle = &I2C_Handle[I2C_HANDLE_INDEX(I2Cx)];
+
+	if(pHandle->State == I2C_STATE_READY)
+	{
+		return;
+	}
+
+	pI2Cx->CR2 &= ~I2C_CR2_DMA_MASK;
+	if(Event == DMA_EV_TRANSFER_ERROR)
+	{
+		I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+		I2C_voidCloseTransaction(pI2Cx, I2Cx, I2C_ERROR_DMA);
+	}
+	else if(pHandle->State == I2C_STATE_BUSY_TX)
+	{
+		pHandle->TxCount = pHandle->Transaction.TxLen;
+	}
+	else
+	{
+		I2C_VOID_SEND_STOP_CONDITION(pI2Cx);
+		pHandle->RxCount = pHandle->Transaction.RxLen;
+		I2C_voidCloseTransaction(pI2Cx, I2Cx, I2C_EV_CMPLT);
+	}
+}
+
+static void I2C1_voidDmaTxCallBack(u8 Event)
+{
+	I2C_voidDmaHandler(I2C1, Event);
+}
+
+static void I2C1_voidDmaRxCallBack(u8 Event)
+{
+	I2C_voidDmaHandler(I2C1, Event);
+}
+
+static void I2C2_voidDmaTxCallBack(u8 Event)
+{
+	I2C_voidDmaHandler(I2C2, Event);
+}
+
+static void I2C2_voidDmaRxCallBack(u8 Event)
+{
+	I2C_voidDmaHandler(I2C2, Event);
+}
+
+/* ISR Imp */
+void I2C1_EV_IRQHandler(void)
+{
+	I2C_voidEventHandler(I2C1);
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+	I2C_voidErrorHandler(I2C1);
+}
+
+void I2C2_EV_IRQHandler(void)
+{
+	I2C_voidEventHandler(I2C2);
+}
+
+void I2C2_ER_IRQHandler(void)
+{
+	I2C_voidErrorHandler(I2C2);
+}
@@ -7,7 +7,7 @@
 #include "NVIC_private.h"
 #include "NVIC_config.h"
 
-#define SCB_u32_AIRCR_REG *((volatile u32 *)(0xE000ED00 + 0x0C))
+#define SCB_u32_AIRCR_REG (SCB->AIRCR)
 
 u8 NVIC_u8EnableInterrupt(u8 Copy_u8IRQN)
 {
@@ -19,7 +19,7 @@ u8 NVIC_u8EnableInterrupt(u8 Copy_u8IRQN)
 		Local_u8BitNb = Copy_u8IRQN % 32;
 
 		/* Enable Peripheral Interrupt */
-		NVIC->ISER[Local_u8RegIndex] = (1 << Local_u8BitNb);
+		NVIC_WRITE_ONE_TO_SET(NVIC->ISER[Local_u8RegIndex], (1 << Local_u8BitNb));
 	}
 	else
 	{
@@ -37,7 +37,7 @@ u8 NVIC_u8DisableInterrupt(u8 Copy_u8IRQN)
 		Local_u8BitNb = Copy_u8IRQN % 32;
 
 		/* Enable Peripheral Interrupt */
-		NVIC->ICER[Local_u8RegIndex] = (1 << Local_u8BitNb);
+		NVIC_WRITE_ONE_TO_SET(NVIC->ICER[Local_u8RegIndex], (1 << Local_u8BitNb));
 	}
 	else
 	{
@@ -56,7 +56,7 @@ u8 NVIC_u8SetPendingFlag(u8 Copy_u8IRQN)
 		Local_u8BitNb = Copy_u8IRQN % 32;
 
 		/* Enable Peripheral Interrupt */
-		NVIC->ISPR[Local_u8RegIndex] = (1 << Local_u8BitNb);
+		NVIC_WRITE_ONE_TO_SET(NVIC->ISPR[Local_u8RegIndex], (1 << Local_u8BitNb));
 	}
 	else
 	{
@@ -74,7 +74,7 @@ u8 NVIC_u8ClearPendingFlag(u8 Copy_u8IRQN)
 		Local_u8BitNb = Copy_u8IRQN % 32;
 
 		/* Enable Peripheral Interrupt */
-		NVIC->ICPR[Local_u8RegIndex] = (1 << Local_u8BitNb);
+		NVIC_WRITE_ONE_TO_SET(NVIC->ICPR[Local_u8RegIndex], (1 << Local_u8BitNb));
 	}
 	else
 	{
@@ -0,0 +1,112 @@
+/*******************************************************/
+/* Layer     : MCAL                                    */
+/* SWC       : PROF (DWT cycle counter profiling)      */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+#include "stm32f103C8.h"
+
+#include "PROF_interface.h"
+#include "PROF_private.h"
+#include "PROF_config.h"
+
+PROF_Zone_t PROF_Zones[PROF_ZONE_COUNT];
+
+void PROF_voidInit(void)
+{
+	/* The DWT is only clocked once trace is enabled in the debug monitor register */
+	SET_BIT(COREDEBUG->DEMCR, PROF_DEMCR_TRCENA_BIT);
+	DWT->CYCCNT = 0;
+	SET_BIT(DWT->CTRL, PROF_DWT_CYCCNTENA_BIT);
+
+	PROF_voidReset();
+}
+
+void PROF_voidReset(void)
+{
+	u8 LOC_u8Zone;
+
+	for (LOC_u8Zone = 0; LOC_u8Zone < PROF_ZONE_COUNT; LOC_u8Zone++)
+	{
+		PROF_Zones[LOC_u8Zone].Start = 0;
+		PROF_Zones[LOC_u8Zone].Count = 0;
+		PROF_Zones[LOC_u8Zone].Min = 0xFFFFFFFF;
+		PROF_Zones[LOC_u8Zone].Max = 0;
+		PROF_Zones[LOC_u8Zone].Total = 0;
+	}
+}
+
+void PROF_voidBegin(u8 Copy_u8Zone)
+{
+	if (Copy_u8Zone < PROF_ZONE_COUNT)
+	{
+		PROF_Zones[Copy_u8Zone].Start = PROF_CYCLES();
+	}
+}
+
+void PROF_voidEnd(u8 Copy_u8Zone)
+{
+	u32 LOC_u32Cycles = PROF_CYCLES();
+	PROF_Zone_t * LOC_pZone;
+
+	if (Copy_u8Zone >= PROF_ZONE_COUNT)
+	{
+		return;
+	}
+	LOC_pZone = &PROF_Zones[Copy_u8Zone];
+
+	/* Unsigned difference, correct across one wrap of the 32-bit counter */
+	LOC_u32Cycles -= LOC_pZone->Start;
+	LOC_pZone->Count++;
+	LOC_pZone->Total += LOC_u32Cycles;
+	if (LOC_u32Cycles < LOC_pZone->Min)
+	{
+		LOC_pZone->Min = LOC_u32Cycles;
+	}
+	if (LOC_u32Cycles > LOC_pZone->Max)
+	{
+		LOC_pZone->Max = LOC_u32Cycles;
+	}
+}
+
+void PROF_voidSubtract(u8 Copy_u8Zone, u32 Copy_u32Cycles)
+{
+	PROF_Zone_t * LOC_pZone;
+
+	if ((Copy_u8Zone >= PROF_ZONE_COUNT) || (PROF_Zones[Copy_u8Zone].Count == 0))
+	{
+		return;
+	}
+	LOC_pZone = &PROF_Zones[Copy_u8Zone];
+
+	LOC_pZone->Min = (LOC_pZone->Min > Copy_u32Cycles) ? (LOC_pZone->Min - Copy_u32Cycles) : 0;
+	LOC_pZone->Max = (LOC_pZone->Max > Copy_u32Cycles) ? (LOC_pZone->Max - Copy_u32Cycles) : 0;
+	if (LOC_pZone->Total > ((u64)Copy_u32Cycles * LOC_pZone->Count))
+	{
+		LOC_pZone->Total -= (u64)Copy_u32Cycles * LOC_pZone->Count;
+	}
+	else
+	{
+		LOC_pZone->Total = 0;
+	}
+}
+
+u8 PROF_u8GetStats(u8 Copy_u8Zone, PROF_Stats_t * Copy_pStats)
+{
+	const PROF_Zone_t * LOC_pZone;
+
+	if ((Copy_u8Zone >= PROF_ZONE_COUNT) || (Copy_pStats == NULL) || (PROF_Zones[Copy_u8Zone].Count == 0))
+	{
+		return STD_TYPES_NOK;
+	}
+	LOC_pZone = &PROF_Zones[Copy_u8Zone];
+
+	Copy_pStats->Count = LOC_pZone->Count;
+	Copy_pStats->Min = LOC_pZone->Min;
+	Copy_pStats->Max = LOC_pZone->Max;
+	Copy_pStats->Mean = (u32)(LOC_pZone->Total / LOC_pZone->Count);
+
+	return STD_TYPES_OK;
+}
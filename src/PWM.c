@@ -7,411 +7,426 @@
 
 #include "STD_TYPES.h"
 #include "BIT_MATH.h"
+#include "BIT_BAND.h"
 
 
+#include "DMA_interface.h"
 #include "PWM.h"
 
 
-void MPWM_Init(const MPWM_ConfigType* ConfigPtr)
+/* Timer register bits used by the driver */
+#define MPWM_CR1_CEN           0
+#define MPWM_CR1_UDIS          1
+#define MPWM_CR1_URS           2
+#define MPWM_CR1_DIR           4
+#define MPWM_CR1_CMS           5
+#define MPWM_CR1_ARPE          7
+#define MPWM_CR1_CKD           8
+#define MPWM_DIER_UDE          8
+#define MPWM_EGR_UG            0
+#define MPWM_CCMR_OCFE         2
+#define MPWM_CCMR_OCPE         3
+#define MPWM_CCMR_OCM          4
+#define MPWM_CCMR_CHANNEL_MASK 0xFF
+#define MPWM_CCER_CCE          0
+#define MPWM_CCER_CCP          1
+#define MPWM_CCER_CCNE         2
+#define MPWM_CCER_CCNP         3
+#define MPWM_SR_BIF            7
+#define MPWM_EGR_BG            7
+#define MPWM_BDTR_OSSI         10
+#define MPWM_BDTR_OSSR         11
+#define MPWM_BDTR_BKE          12
+#define MPWM_BDTR_BKP          13
+#define MPWM_BDTR_MOE          15
+
+/* OCxM value of the PWM modes */
+#define MPWM_OCM_PWM_MODE_1    6
+#define MPWM_OCM_PWM_MODE_2    7
+
+/* Hardware description of a PWM channel */
+typedef struct ChannelDescType
+{
+	volatile TIMER_RegDef_t* Timer;
+	volatile u32*            Ccmr;        /* CCMR1 for channels 1/2, CCMR2 for channels 3/4 */
+	volatile u32*            Ccr;
+	u8                       CcmrShift;   /* 0 for channels 1/3, 8 for channels 2/4 */
+	u8                       CcerShift;   /* CCxE, CCxP is the next bit */
+}MPWM_ChannelDescType;
+
+#define MPWM_CHANNEL_DESC(TIMER, CCMR, CCR, CCMR_SHIFT, CCER_SHIFT) \
+	{TIMER, &(TIMER)->CCMR, &(TIMER)->CCR, CCMR_SHIFT, CCER_SHIFT}
+
+#define MPWM_TIMER_CHANNELS_DESC(TIMER)              \
+	MPWM_CHANNEL_DESC(TIMER, CCMR1, CCR1, 0, 0),     \
+	MPWM_CHANNEL_DESC(TIMER, CCMR1, CCR2, 8, 4),     \
+	MPWM_CHANNEL_DESC(TIMER, CCMR2, CCR3, 0, 8),     \
+	MPWM_CHANNEL_DESC(TIMER, CCMR2, CCR4, 8, 12)
+
+/* Indexed by MPWM_ChannelType, MPWM_CHANNELS_PER_TIMER channels per timer */
+static const MPWM_ChannelDescType MPWM_Channels[MPWM_CHANNEL_COUNT] =
+{
+	MPWM_TIMER_CHANNELS_DESC(TIMER2),
+	MPWM_TIMER_CHANNELS_DESC(TIMER3),
+	MPWM_TIMER_CHANNELS_DESC(TIMER4),
+	MPWM_TIMER_CHANNELS_DESC(TIMER1)
+};
+
+/* Counter configuration of PWM_Cfg.h */
+#if MPWM_Aligned_Mode == Edge_aligned_mode
+	#define MPWM_CR1_DIRECTION   ((u32)MPWM_Counter_Direction << MPWM_CR1_DIR)
+#else
+	#define MPWM_CR1_DIRECTION   0
+#endif
+
+#define MPWM_CR1_CONFIG        (((u32)MPWM_Clock << MPWM_CR1_CKD) | (1UL << MPWM_CR1_ARPE) | \
+                                ((u32)MPWM_Aligned_Mode << MPWM_CR1_CMS) | MPWM_CR1_DIRECTION | (1UL << MPWM_CR1_URS))
+
+#define MPWM_CR1_CONFIG_MASK   ((3UL << MPWM_CR1_CKD) | (1UL << MPWM_CR1_ARPE) | (3UL << MPWM_CR1_CMS) | \
+                                (1UL << MPWM_CR1_DIR) | (1UL << MPWM_CR1_URS) | (1UL << MPWM_CR1_UDIS))
+
+#if   MPWM_Mode == Mode1
+	#define MPWM_OCM           MPWM_OCM_PWM_MODE_1
+#elif MPWM_Mode == Mode2
+	#define MPWM_OCM           MPWM_OCM_PWM_MODE_2
+#endif
+
+
+/* TIM1 dead-time in DTS clock periods (CK_INT divided by CKD), rounded up */
+#define MPWM_DTS_HZ            ((u32)Sys_Clock >> MPWM_Clock)
+#define MPWM_DEAD_TIME_TICKS   ((u32)((((u64)MPWM_Tim1_Dead_Time_Ns * MPWM_DTS_HZ) + 999999999ULL) / 1000000000ULL))
+
+/* TIM1 break: the off-state outputs are driven to their idle level (OISx = OISxN = 0, low) instead
+   of floating, AOE is left clear so a break stays latched until MPWM_ClearBreak */
+#if   MPWM_Tim1_Break == MPWM_BREAK_ACTIVE_LOW
+	#define MPWM_BDTR_BREAK    (1UL << MPWM_BDTR_BKE)
+#elif MPWM_Tim1_Break == MPWM_BREAK_ACTIVE_HIGH
+	#define MPWM_BDTR_BREAK    ((1UL << MPWM_BDTR_BKE) | (1UL << MPWM_BDTR_BKP))
+#else
+	#define MPWM_BDTR_BREAK    0
+#endif
+
+#define MPWM_BDTR_CONFIG       ((1UL << MPWM_BDTR_OSSI) | (1UL << MPWM_BDTR_OSSR) | MPWM_BDTR_BREAK)
+
+/* DTG[7:0] of the shortest dead-time not below Ticks, saturated at 1008 ticks */
+static u8 MPWM_u8DeadTimeGenerator(u32 Ticks)
 {
+	u8 LOC_u8Dtg;
 
-	/* Clock Input */
-	#if   MPWM_Clock == CLK_INT
-		CLR_BIT(TIMER3->CR1 , 8);
-		CLR_BIT(TIMER3->CR1 , 9);
-	#elif MPWM_Clock == CLK_INT_*_2
-		SET_BIT(TIMER3->CR1 , 8);
-		CLR_BIT(TIMER3->CR1 , 9);
-	#elif MPWM_Clock == CLK_INT_*_4
-		CLR_BIT(TIMER3->CR1 , 8);
-		SET_BIT(TIMER3->CR1 , 9);
-	#endif
-
-	/* Auto-reload preload enable */
-	SET_BIT(TIMER3->CR1 , 7);
-
-	/* Center-aligned mode selection */
-	#if   MPWM_Aligned_Mode == Edge_aligned_mode
-		CLR_BIT(TIMER3->CR1 , 5);
-		CLR_BIT(TIMER3->CR1 , 6);
-	#elif MPWM_Aligned_Mode == Center_aligned_mode_1
-		SET_BIT(TIMER3->CR1 , 5);
-		CLR_BIT(TIMER3->CR1 , 6);
-	#elif MPWM_Aligned_Mode == Center_aligned_mode_2
-		CLR_BIT(TIMER3->CR1 , 5);
-		SET_BIT(TIMER3->CR1 , 6);
-	#elif MPWM_Aligned_Mode == Center_aligned_mode_3
-		SET_BIT(TIMER3->CR1 , 5);
-		SET_BET(TIMER3->CR1 , 6);
-	#endif
-
-	/* Direction */
-	#if MPWM_Aligned_Mode == Edge_aligned_mode
-		#if   PWM_Counter_Direction == upcounter
-			CLR_BIT(TIMER3->CR1 , 4);
-		#elif MPWM_Counter_Direction == downcounter
-			SET_BIT(TIMER3->CR1 , 4);
-		#endif
-	#endif
+	if(Ticks <= 127)
+	{
+		LOC_u8Dtg = (u8)Ticks;                                     /* DTG x tDTS */
+	}
+	else if(Ticks <= 254)
+	{
+		LOC_u8Dtg = (u8)(0x80 | (((Ticks + 1) / 2) - 64));        /* (64 + DTG[5:0]) x 2 x tDTS */
+	}
+	else if(Ticks <= 504)
+	{
+		LOC_u8Dtg = (u8)(0xC0 | (((Ticks + 7) / 8) - 32));        /* (32 + DTG[4:0]) x 8 x tDTS */
+	}
+	else if(Ticks <= 1008)
+	{
+		LOC_u8Dtg = (u8)(0xE0 | (((Ticks + 15) / 16) - 32));      /* (32 + DTG[4:0]) x 16 x tDTS */
+	}
+	else
+	{
+		LOC_u8Dtg = 0xFF;
+	}
+	return LOC_u8Dtg;
+}
 
+/* Ramp engine: one ramp at a time on a TIMER3 channel */
+#define MPWM_RAMP_TIMER        TIMER3
+#define MPWM_RAMP_NONE         MPWM_CHANNEL_COUNT
+#define MPWM_RAMP_Q            15
 
-			/* Preload Value */
+static const DMA_ChannelConfig_t MPWM_RampDmaConfig =
+{
+	DMA_MEM_TO_PERIPH, DMA_SIZE_16BIT, DMA_SIZE_16BIT, DMA_ENABLE, DMA_DISABLE, DMA_PRIORITY_HIGH
+};
 
-	TIMER3->ARR = ConfigPtr->Period;
+static u16 MPWM_RampBuffer[MPWM_Ramp_Max_Periods];
+static volatile MPWM_ChannelType MPWM_RampChannel = MPWM_RAMP_NONE;
+static MPWM_RampNotificationType MPWM_RampNotification = NULL;
 
+/* Stops the update requests and the DMA, the ramp is over */
+static void MPWM_voidRampHalt(void)
+{
+	BITBAND_CLR(MPWM_RAMP_TIMER->DIER, MPWM_DIER_UDE);
+	DMA_voidStopTransfer(MPWM_Ramp_Dma_Channel);
+	MPWM_RampChannel = MPWM_RAMP_NONE;
+}
 
-	if(ConfigPtr->Channel == MPWM_Channel_1)
+/* A duty written by the other services wins over a running ramp on the same channel */
+static void MPWM_voidRampCancel(MPWM_ChannelType ChannelNumber)
+{
+	if(MPWM_RampChannel == ChannelNumber)
 	{
-		/* PWM Mode Selection */
-		#if   MPWM_Mode == Mode1
-			CLR_BIT(TIMER3->CCMR1 , 4);
-			SET_BIT(TIMER3->CCMR1 , 5);
-			SET_BIT(TIMER3->CCMR1 , 6);
-		#elif MPWM_Mode == Mode2
-			SET_BIT(TIMER3->CCMR1 , 4);
-			SET_BIT(TIMER3->CCMR1 , 5);
-			SET_BIT(TIMER3->CCMR1 , 6);
-		#endif
-
-		/* Output Compare 1 Preload Enable */
-			SET_BIT(TIMER3->CCMR1 , 3);
-
-		/* Output compare 1 fast enable */
-			SET_BIT(TIMER3->CCMR1 , 2);
-
-		/* Channel Configuration As OutPut */
-			CLR_BIT(TIMER3->CCMR1, 0);
-			CLR_BIT(TIMER3->CCMR1, 1);
+		MPWM_voidRampHalt();
+	}
+}
 
-		/* Capture/compare 1 generation */
-			SET_BIT(TIMER3->EGR , 1);
+static void MPWM_voidRampDmaCallBack(u8 Copy_u8Event)
+{
+	MPWM_ChannelType LOC_Channel = MPWM_RampChannel;
 
-		/*  Capture/Compare 1 output enable */
-			 SET_BIT(TIMER3->CCER , 0);
+	MPWM_voidRampHalt();
+	if((Copy_u8Event == DMA_EV_TRANSFER_CMPLT) && (LOC_Channel != MPWM_RAMP_NONE) && (MPWM_RampNotification != NULL))
+	{
+		MPWM_RampNotification(LOC_Channel);
+	}
+}
 
-		if(ConfigPtr->Idle_State == PWM_HIGH)
-		{
-			CLR_BIT(TIMER3->CCER , 1);
-		}
-		else if(ConfigPtr->Idle_State == PWM_LOW)
-		{
-			SET_BIT(TIMER3->CCER , 1);
-		}
+void MPWM_Init(const MPWM_ConfigType* ConfigPtr)
+{
+	const MPWM_ChannelDescType* LOC_Desc;
+	volatile TIMER_RegDef_t* LOC_Timer;
 
-		/* Duty Cycle */
-		TIMER3->CCR1 = ConfigPtr->Duty_Cycle;
-	}
-	else if(ConfigPtr->Channel == MPWM_Channel_2)
+	if(ConfigPtr->Channel >= MPWM_CHANNEL_COUNT)
 	{
-		/* PWM Mode Selection */
-		#if   MPWM_Mode == Mode1
-			CLR_BIT(TIMER3->CCMR1 , 12);
-			SET_BIT(TIMER3->CCMR1 , 13);
-			SET_BIT(TIMER3->CCMR1 , 14);
-		#elif MPWM_Mode == Mode2
-			SET_BIT(TIMER3->CCMR1 , 12);
-			SET_BIT(TIMER3->CCMR1 , 13);
-			SET_BIT(TIMER3->CCMR1 , 14);
-		#endif
-
-		/* Output Compare 2 Preload Enable */
-			SET_BIT(TIMER3->CCMR1 , 11);
+		return;
+	}
+	LOC_Desc  = &MPWM_Channels[ConfigPtr->Channel];
+	LOC_Timer = LOC_Desc->Timer;
 
-		/* Output compare 2 fast enable */
-			SET_BIT(TIMER3->CCMR1 , 10);
+	/* Clock division, auto-reload preload, alignment and direction, update events enabled:
+	   UG and overflows load the preloaded registers, only overflows set UIF */
+	LOC_Timer->CR1 = (LOC_Timer->CR1 & ~MPWM_CR1_CONFIG_MASK) | MPWM_CR1_CONFIG;
 
-		/* Channel Configuration As OutPut */
-			CLR_BIT(TIMER3->CCMR1, 8);
-			CLR_BIT(TIMER3->CCMR1, 9);
+	/* Preload Value */
+	LOC_Timer->ARR = ConfigPtr->Period;
 
-		/* Capture/compare 2 generation */
-			SET_BIT(TIMER3->EGR , 2);
+	/* Output, PWM mode, compare preload and fast enable */
+	*LOC_Desc->Ccmr = (*LOC_Desc->Ccmr & ~((u32)MPWM_CCMR_CHANNEL_MASK << LOC_Desc->CcmrShift)) |
+	                  ((((u32)MPWM_OCM << MPWM_CCMR_OCM) | (1UL << MPWM_CCMR_OCPE) | (1UL << MPWM_CCMR_OCFE)) << LOC_Desc->CcmrShift);
 
-		/*  Capture/Compare 2 output enable */
-			SET_BIT(TIMER3->CCER , 4);
+	/* Output enable, polarity from the idle state */
+	if(ConfigPtr->Idle_State == PWM_HIGH)
+	{
+		CLR_BIT(LOC_Timer->CCER, (LOC_Desc->CcerShift + MPWM_CCER_CCP));
+	}
+	else
+	{
+		SET_BIT(LOC_Timer->CCER, (LOC_Desc->CcerShift + MPWM_CCER_CCP));
+	}
+	SET_BIT(LOC_Timer->CCER, (LOC_Desc->CcerShift + MPWM_CCER_CCE));
 
-		if(ConfigPtr->Idle_State == PWM_HIGH)
-		{
-			CLR_BIT(TIMER3->CCER , 5);
-		}
-		else if(ConfigPtr->Idle_State == PWM_LOW)
+	/* TIM1: complementary output with the same polarity (CH4 has none), dead-time and break */
+	if(LOC_Timer == TIMER1)
+	{
+		if(LOC_Desc->CcerShift < 12)
 		{
-			SET_BIT(TIMER3->CCER , 5);
+			LOC_Timer->CCER = (LOC_Timer->CCER & ~(1UL << (LOC_Desc->CcerShift + MPWM_CCER_CCNP))) |
+			                  (GET_BIT(LOC_Timer->CCER, (LOC_Desc->CcerShift + MPWM_CCER_CCP)) << (LOC_Desc->CcerShift + MPWM_CCER_CCNP)) |
+			                  (1UL << (LOC_Desc->CcerShift + MPWM_CCER_CCNE));
 		}
-
-		/* Duty Cycle */
-		TIMER3->CCR2 = ConfigPtr->Duty_Cycle;
+		LOC_Timer->RCR = 0;
+		LOC_Timer->BDTR = MPWM_BDTR_CONFIG | MPWM_u8DeadTimeGenerator(MPWM_DEAD_TIME_TICKS) | (1UL << MPWM_BDTR_MOE);
 	}
-	else if (ConfigPtr->Channel == MPWM_Channel_3)
-	{
-		/* PWM Mode Selection */
-		#if   MPWM_Mode == Mode1
-			CLR_BIT(TIMER3->CCMR2 , 4);
-			SET_BIT(TIMER3->CCMR2 , 5);
-			SET_BIT(TIMER3->CCMR2 , 6);
-		#elif MPWM_Mode == Mode2
-			SET_BIT(TIMER3->CCMR2 , 4);
-			SET_BIT(TIMER3->CCMR2 , 5);
-			SET_BIT(TIMER3->CCMR2 , 6);
-		#endif
 
-		/* Output Compare 3 Preload Enable */
-			SET_BIT(TIMER3->CCMR2 , 3);
+	/* Duty Cycle */
+	*LOC_Desc->Ccr = ConfigPtr->Duty_Cycle;
 
-		/* Output compare 3 fast enable */
-			SET_BIT(TIMER3->CCMR2 , 2);
+	/* Prescaler Value */
+	LOC_Timer->PSC = Prescaler_Value;
 
-		/* Channel Configuration As OutPut */
-			CLR_BIT(TIMER3->CCMR2, 0);
-			CLR_BIT(TIMER3->CCMR2, 1);
+	/* PSC, ARR and CCRx are preloaded: UG loads them before the counter starts */
+	LOC_Timer->EGR = (1UL << MPWM_EGR_UG);
 
-		/* Capture/compare 3 generation */
-			SET_BIT(TIMER3->EGR , 3);
+	/* Counter Enable */
+	SET_BIT(LOC_Timer->CR1, MPWM_CR1_CEN);
+}
 
-		/*  Capture/Compare 3 output enable */
-			SET_BIT(TIMER3->CCER , 8);
+void MPWM_SetDutyCycle(MPWM_ChannelType ChannelNumber,MPWM_DutyCycleType DutyCycle)
+{
+	/* Preloaded: applied at the next update event, never in the middle of a period */
+	if(ChannelNumber < MPWM_CHANNEL_COUNT)
+	{
+		MPWM_voidRampCancel(ChannelNumber);
+		*MPWM_Channels[ChannelNumber].Ccr = DutyCycle;
+	}
+}
 
+void MPWM_SetDutyCycles(const MPWM_DutyUpdateType* Updates, u8 Count)
+{
+	u8 LOC_u8Timers = 0;
+	u8 LOC_u8Index;
 
-		if(ConfigPtr->Idle_State == PWM_HIGH)
+	for(LOC_u8Index = 0; LOC_u8Index < Count; LOC_u8Index++)
+	{
+		if(Updates[LOC_u8Index].Channel < MPWM_CHANNEL_COUNT)
 		{
-			CLR_BIT(TIMER3->CCER , 9);
+			MPWM_voidRampCancel(Updates[LOC_u8Index].Channel);
+			LOC_u8Timers |= (1 << (Updates[LOC_u8Index].Channel / MPWM_CHANNELS_PER_TIMER));
 		}
-		else if(ConfigPtr->Idle_State == PWM_LOW)
+	}
+
+	/* No update event while the set is half written: the shadow registers keep the previous set */
+	for(LOC_u8Index = 0; LOC_u8Index < MPWM_TIMER_COUNT; LOC_u8Index++)
+	{
+		if(GET_BIT(LOC_u8Timers, LOC_u8Index))
 		{
-			SET_BIT(TIMER3->CCER , 9);
+			BITBAND_SET(MPWM_Channels[LOC_u8Index * MPWM_CHANNELS_PER_TIMER].Timer->CR1, MPWM_CR1_UDIS);
 		}
-
-		/* Duty Cycle */
-		TIMER3->CCR3 = ConfigPtr->Duty_Cycle;
 	}
-	else if(ConfigPtr->Channel == MPWM_Channel_4)
-	{
-		/* PWM Mode Selection */
-		#if   MPWM_Mode == Mode1
-			CLR_BIT(TIMER3->CCMR2 , 12);
-			SET_BIT(TIMER3->CCMR2 , 13);
-			SET_BIT(TIMER3->CCMR2 , 14);
-		#elif MPWM_Mode == Mode2
-			SET_BIT(TIMER3->CCMR2 , 12);
-			SET_BIT(TIMER3->CCMR2 , 13);
-			SET_BIT(TIMER3->CCMR2 , 14);
-		#endif
 
-		/* Output Compare 4 Preload Enable */
-			SET_BIT(TIMER3->CCMR2 , 11);
+	for(LOC_u8Index = 0; LOC_u8Index < Count; LOC_u8Index++)
+	{
+		if(Updates[LOC_u8Index].Channel < MPWM_CHANNEL_COUNT)
+		{
+			*MPWM_Channels[Updates[LOC_u8Index].Channel].Ccr = Updates[LOC_u8Index].DutyCycle;
+		}
+	}
 
-		/* Output compare 4 fast enable */
-			SET_BIT(TIMER3->CCMR2 , 10);
+	/* One update event commits the whole set */
+	for(LOC_u8Index = 0; LOC_u8Index < MPWM_TIMER_COUNT; LOC_u8Index++)
+	{
+		if(GET_BIT(LOC_u8Timers, LOC_u8Index))
+		{
+			volatile TIMER_RegDef_t* LOC_Timer = MPWM_Channels[LOC_u8Index * MPWM_CHANNELS_PER_TIMER].Timer;
 
-		/* Channel Configuration As OutPut */
-			CLR_BIT(TIMER3->CCMR2, 8);
-			CLR_BIT(TIMER3->CCMR2, 9);
+			BITBAND_CLR(LOC_Timer->CR1, MPWM_CR1_UDIS);
+		#if MPWM_Sync_Update == MPWM_SYNC_IMMEDIATE
+			LOC_Timer->EGR = (1UL << MPWM_EGR_UG);
+		#endif
+		}
+	}
+}
 
-		/* Capture/compare 4 generation */
-			SET_BIT(TIMER3->EGR , 4);
+u8 MPWM_u8StartRamp(MPWM_ChannelType ChannelNumber,MPWM_DutyCycleType DutyCycle,u16 Periods,u8 Profile,MPWM_RampNotificationType Notification)
+{
+	volatile u32* LOC_Ccr;
+	s32 LOC_s32Start;
+	s32 LOC_s32Delta;
+	u32 LOC_u32X;
+	u32 LOC_u32Shape;
+	u16 LOC_u16Index;
+
+	if((ChannelNumber < MPWM_TIM3_CH1) || (ChannelNumber > MPWM_TIM3_CH4) ||
+	   (Periods == 0) || (Periods > MPWM_Ramp_Max_Periods) || (Profile > MPWM_RAMP_S_CURVE))
+	{
+		return STD_TYPES_NOK;
+	}
 
-		/*  Capture/Compare 4 output enable */
-			SET_BIT(TIMER3->CCER , 12);
+	/* A running ramp stops where it is, the new one starts from there */
+	MPWM_voidRampHalt();
+	LOC_Ccr = MPWM_Channels[ChannelNumber].Ccr;
+	LOC_s32Start = (s32)(*LOC_Ccr & 0xFFFF);
+	LOC_s32Delta = (s32)DutyCycle - LOC_s32Start;
 
-		if(ConfigPtr->Idle_State == PWM_HIGH )
+	/* Duty of the end of every period, the shape goes from 0 to 1 in Q15 */
+	for(LOC_u16Index = 0; LOC_u16Index < Periods; LOC_u16Index++)
+	{
+		LOC_u32X = ((u32)(LOC_u16Index + 1) << MPWM_RAMP_Q) / Periods;
+		if(Profile == MPWM_RAMP_S_CURVE)
 		{
-			CLR_BIT(TIMER3->CCER , 13);
+			LOC_u32Shape = (((LOC_u32X * LOC_u32X) >> MPWM_RAMP_Q) * ((3UL << MPWM_RAMP_Q) - (2 * LOC_u32X))) >> MPWM_RAMP_Q;
 		}
-		else if(ConfigPtr->Idle_State == PWM_LOW )
+		else
 		{
-			SET_BIT(TIMER3->CCER , 13);
+			LOC_u32Shape = LOC_u32X;
 		}
-
-		/* Duty Cycle */
-		TIMER3->CCR4 = ConfigPtr->Duty_Cycle;
+		MPWM_RampBuffer[LOC_u16Index] = (u16)(LOC_s32Start + (s32)(((s64)LOC_s32Delta * LOC_u32Shape) >> MPWM_RAMP_Q));
 	}
 
-	/* Update disable */
-	SET_BIT(TIMER3->CR1 , 1);
+	MPWM_RampChannel = ChannelNumber;
+	MPWM_RampNotification = Notification;
 
-	/* Prescaler Value */
-	TIMER3->PSC = Prescaler_Value;
+	/* One CCRx write per update event: each duty becomes active one period after it is written */
+	DMA_u8ChannelInit(MPWM_Ramp_Dma_Channel, &MPWM_RampDmaConfig);
+	DMA_u8SetCallBack(MPWM_Ramp_Dma_Channel, MPWM_voidRampDmaCallBack);
+	DMA_u8StartTransfer(MPWM_Ramp_Dma_Channel, (DMA_Address_t)LOC_Ccr, (DMA_Address_t)MPWM_RampBuffer, Periods);
+	BITBAND_SET(MPWM_RAMP_TIMER->DIER, MPWM_DIER_UDE);
 
-	/* Counter Enable */
-	SET_BIT(TIMER3->CR1 , 0);
+	return STD_TYPES_OK;
 }
 
-void MPWM_SetDutyCycle(MPWM_ChannelType ChannelNumber,MPWM_DutyCycleType DutyCycle)
+void MPWM_StopRamp(void)
 {
-	/* Check Channel Number */
-	switch(ChannelNumber)
-	{
-	case MPWM_Channel_1:
-		/* Duty Cycle */
-		TIMER3->CCR1 = DutyCycle;
-	break;
-
-	case MPWM_Channel_2:
-		/* Duty Cycle */
-		TIMER3->CCR2 = DutyCycle;
-	break;
+	MPWM_voidRampHalt();
+}
 
-	case MPWM_Channel_3:
-		/* Duty Cycle */
-		TIMER3->CCR3 = DutyCycle;
-	break;
+void MPWM_SetPeriodAndDuty(MPWM_ChannelType ChannelNumber, MPWM_PeriodType Period,u16 DutyCycle)
+{
+	if(ChannelNumber < MPWM_CHANNEL_COUNT)
+	{
+		MPWM_voidRampCancel(ChannelNumber);
+		MPWM_Channels[ChannelNumber].Timer->ARR = Period;
 
-	case MPWM_Channel_4:
 		/* Duty Cycle */
-		TIMER3->CCR4 = DutyCycle;
-	break;
-
-	default:   break;
+		*MPWM_Channels[ChannelNumber].Ccr = DutyCycle;
 	}
 }
 
-void MPWM_SetPeriodAndDuty(MPWM_ChannelType ChannelNumber, MPWM_PeriodType Period,u16 DutyCycle)
+void MPWM_SetOutputToIdle(MPWM_ChannelType ChannelNumber)
 {
+	const MPWM_ChannelDescType* LOC_Desc;
 
-	TIMER3->ARR = Period;
-
-	/* Check Channel Number */
-	switch(ChannelNumber)
+	if(ChannelNumber >= MPWM_CHANNEL_COUNT)
 	{
-	case MPWM_Channel_1:
-		/* Duty Cycle */
-		TIMER3->CCR1 = DutyCycle;
-	break;
+		return;
+	}
+	LOC_Desc = &MPWM_Channels[ChannelNumber];
 
-	case MPWM_Channel_2:
-		/* Duty Cycle */
-		TIMER3->CCR2 = DutyCycle;
-	break;
+	/* No ramp writes the duty behind our back */
+	MPWM_voidRampCancel(ChannelNumber);
 
-	case MPWM_Channel_3:
-		/* Duty Cycle */
-		TIMER3->CCR3 = DutyCycle;
-	break;
-
-	case MPWM_Channel_4:
-		/* Duty Cycle */
-		TIMER3->CCR4 = DutyCycle;
-	break;
+	/* Counter Disable */
+	BITBAND_CLR(LOC_Desc->Timer->CR1, MPWM_CR1_CEN);
 
-	default:   break;
+	/* Capture/Compare output disable, the configured polarity is kept for MPWM_Init */
+	BITBAND_CLR(LOC_Desc->Timer->CCER, LOC_Desc->CcerShift + MPWM_CCER_CCE);
+	/* TIM1: the complementary output too (CH4 has none) */
+	if((LOC_Desc->Timer == TIMER1) && (LOC_Desc->CcerShift < 12))
+	{
+		BITBAND_CLR(LOC_Desc->Timer->CCER, LOC_Desc->CcerShift + MPWM_CCER_CCNE);
 	}
 }
 
-void MPWM_SetOutputToIdle(MPWM_ChannelType ChannelNumber)
+void MPWM_GenerateBreak(void)
 {
-	/* Counter Disable */
-	CLR_BIT(TIMER3->CR1 , 0);
+	/* BG: same path as BKIN, MOE is cleared in hardware */
+	TIMER1->EGR = (1UL << MPWM_EGR_BG);
+}
 
-	switch(ChannelNumber)
-		{
-		case MPWM_Channel_1:
-			/*  Capture/Compare 1 output Disable */
-				SET_BIT(TIMER3->CCER , 0);
-			/* Capture/Compare 1 output polarity LOW */
-				SET_BIT(TIMER3->CCER , 1);
-		break;
-
-		case MPWM_Channel_2:
-			/*  Capture/Compare 2 output Disable */
-				SET_BIT(TIMER3->CCER , 4);
-			/* Capture/Compare 2 output polarity LOW */
-				SET_BIT(TIMER3->CCER , 5);
-		break;
-
-		case MPWM_Channel_3:
-			/*  Capture/Compare 3 output Disable */
-				SET_BIT(TIMER3->CCER , 8);
-			/* Capture/Compare 3 output polarity LOW */
-				SET_BIT(TIMER3->CCER , 9);
-		break;
-
-		case MPWM_Channel_4:
-			/*  Capture/Compare 4 output Disable */
-				SET_BIT(TIMER3->CCER , 12);
-			/* Capture/Compare 4 output polarity LOW */
-				SET_BIT(TIMER3->CCER , 13);
-		break;
-
-		default:   break;
-		}
+u8 MPWM_u8GetBreakState(void)
+{
+	return GET_BIT(TIMER1->BDTR, MPWM_BDTR_MOE) ? MPWM_BREAK_CLEARED : MPWM_BREAK_ACTIVE;
 }
 
-MPWM_OutputStateType MPWM_GetOutputState(MPWM_ChannelType ChannelNumber)
+void MPWM_ClearBreak(void)
 {
-	MPWM_OutputStateType LOC_State;
-	u16 LOC_u16Counter=0;
-	u16 LOC_u16DutyCycle=0;
+	/* SR is rc_w0 */
+	TIMER1->SR = (u32)~(1UL << MPWM_SR_BIF);
+	BITBAND_SET(TIMER1->BDTR, MPWM_BDTR_MOE);
+}
 
-	/* Counter Value */
-	LOC_u16Counter = TIMER3->CNT;
+MPWM_OutputStateType MPWM_GetOutputState(MPWM_ChannelType ChannelNumber)
+{
+	MPWM_OutputStateType LOC_State = PWM_LOW;
 
-	switch(ChannelNumber)
+	if(ChannelNumber < MPWM_CHANNEL_COUNT)
+	{
+		/* Counter against the Duty Cycle */
+		if((u16)MPWM_Channels[ChannelNumber].Timer->CNT < (u16)*MPWM_Channels[ChannelNumber].Ccr)
 		{
-		case MPWM_Channel_1:
-			/* Duty Cycle Value */
-				LOC_u16DutyCycle = TIMER3->CCR1;
-		break;
-
-		case MPWM_Channel_2:
-			/* Duty Cycle Value */
-				LOC_u16DutyCycle = TIMER3->CCR2;
-		break;
-
-		case MPWM_Channel_3:
-			/* Duty Cycle Value */
-				LOC_u16DutyCycle = TIMER3->CCR3;
-		break;
-
-		case MPWM_Channel_4:
-			/* Duty Cycle Value */
-				LOC_u16DutyCycle = TIMER3->CCR4;
-		break;
-
-		default:   break;
+			LOC_State = PWM_HIGH;
 		}
-
-	if(LOC_u16Counter < LOC_u16DutyCycle)
-	{
-		LOC_State = PWM_HIGH;
-	}
-	else
-	{
-		LOC_State = PWM_LOW;
 	}
 
-
 	return LOC_State;
 }
 
 MPWM_DutyCycleType MPWM_GetDutyCycle(MPWM_ChannelType ChannelNumber)
 {
-	MPWM_DutyCycleType LOC_DutyCycle;
-
-	switch(ChannelNumber)
-			{
-			case MPWM_Channel_1:
-				/* Duty Cycle Value */
-					LOC_DutyCycle = TIMER3->CCR1;
-			break;
-
-			case MPWM_Channel_2:
-				/* Duty Cycle Value */
-					LOC_DutyCycle = TIMER3->CCR2;
-			break;
-
-			case MPWM_Channel_3:
-				/* Duty Cycle Value */
-					LOC_DutyCycle = TIMER3->CCR3;
-			break;
+	MPWM_DutyCycleType LOC_DutyCycle = 0;
 
-			case MPWM_Channel_4:
-				/* Duty Cycle Value */
-					LOC_DutyCycle = TIMER3->CCR4;
-			break;
-
-			default:   break;
-			}
+	if(ChannelNumber < MPWM_CHANNEL_COUNT)
+	{
+		/* Duty Cycle Value */
+		LOC_DutyCycle = (MPWM_DutyCycleType)*MPWM_Channels[ChannelNumber].Ccr;
+	}
 
 	return LOC_DutyCycle;
 }
-
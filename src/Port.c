@@ -8,19 +8,19 @@
 #include "BIT_MATH.h"
 #include "Port.h"
 #include "stm32f103C8.h"
+#include "PROF_interface.h"
 
 //	ready to be used in DIO MODE
 
-u16 PortA_DIO_OutputPins = 0;
-u16 PortB_DIO_OutputPins = 0;
-u16 PortC_DIO_OutputPins = 0;
-u16 PortA_DIO_InputPins = 0;
-u16 PortB_DIO_InputPins = 0;
-u16 PortC_DIO_InputPins = 0;
+/* Pins of every port (DIO_PORTA..DIO_PORTC) configured as DIO outputs / inputs, only pins of the package */
+u16 Port_DioOutputPins[DIO_PORT_COUNT] = {0, 0, 0};
+u16 Port_DioInputPins[DIO_PORT_COUNT] = {0, 0, 0};
 
 #define PORT_PIN_IN_PORTA(PIN_ID) ((PIN_ID / 16) == 0)
 #define PORT_PIN_IN_PORTB(PIN_ID) ((PIN_ID / 16) == 1)
 #define PORT_PIN_IN_PORTC(PIN_ID) ((PIN_ID / 16) == 2)
+/* Port C only has PC13..PC15 on the package */
+#define PORT_PIN_ON_PACKAGE(PIN_ID) (((PIN_ID / 16) < DIO_PORT_COUNT) && (!PORT_PIN_IN_PORTC(PIN_ID) || ((PIN_ID % 16) >= 13)))
 void LOC_voidDeclareOutputPins(u8 PinCounter);
 void LOC_voidOpenDrainInit(u8 PinCounter);
 void LOC_voidSlewRateInit(u8 PinCounter, u8 Copy_u8MHZ);
@@ -31,6 +31,7 @@ void LOC_voidEnablingInternalPullUpResistor(u8 PinCounter);
 
 void Port_Init(const Port_ConfigType *ConfigPtr)
 {
+	PROF_BEGIN(PROF_ZONE_PORT_INIT);
 	/* Resetting GPIO register values */
 	GPIOA->CRH = 0;
 	GPIOA->CRL = 0;
@@ -114,20 +115,13 @@ void Port_Init(const Port_ConfigType *ConfigPtr)
 			break; /* End of case PORT_PIN_MODE_DIO */
 		}
 	}
+	PROF_END(PROF_ZONE_PORT_INIT);
 }
 void LOC_voidDeclareOutputPins(u8 PinCounter)
 {
-	if (PORT_PIN_IN_PORTA(PinCounter))
+	if (PORT_PIN_ON_PACKAGE(PinCounter))
 	{
-		SET_BIT(PortA_DIO_OutputPins, PinCounter);
-	}
-	else if (PORT_PIN_IN_PORTB(PinCounter))
-	{
-		SET_BIT(PortB_DIO_OutputPins, PinCounter);
-	}
-	else if (PORT_PIN_IN_PORTC(PinCounter))
-	{
-		SET_BIT(PortC_DIO_OutputPins, PinCounter);
+		SET_BIT(Port_DioOutputPins[PinCounter / 16], PinCounter % 16);
 	}
 }
 void LOC_voidOpenDrainInit(u8 PinCounter)
@@ -211,17 +205,9 @@ void LOC_voidSetInialValueHigh(u8 PinCounter)
 
 void LOC_voidDeclareInputPins(u8 PinCounter)
 {
-	if (PORT_PIN_IN_PORTA(PinCounter))
-	{
-		SET_BIT(PortA_DIO_InputPins, PinCounter);
-	}
-	else if (PORT_PIN_IN_PORTB(PinCounter))
-	{
-		SET_BIT(PortB_DIO_InputPins, PinCounter);
-	}
-	else if (PORT_PIN_IN_PORTC(PinCounter))
+	if (PORT_PIN_ON_PACKAGE(PinCounter))
 	{
-		SET_BIT(PortC_DIO_InputPins, PinCounter);
+		SET_BIT(Port_DioInputPins[PinCounter / 16], PinCounter % 16);
 	}
 }
 void LOC_voidPullUpDownInit(u8 PinCounter, u8 Copy_u8PullUpDawnState)
@@ -8,6 +8,7 @@
 #include <BIT_MATH.h>
 #include <stm32f103C8.h>
 #include <STD_TYPES.h>
+#include <BIT_BAND.h>
 #include "RCC_config.h"
 #include "RCC_interface.h"
 #include "RCC_private.h"
@@ -19,13 +20,13 @@ RCC_ErrorStatus RCC_voidEnableClock(u8 Copy_u8BusId, u8 Copy_u8PerId)
         switch (Copy_u8BusId)
         {
         case RCC_AHB:
-            SET_BIT(RCC->AHBENR, Copy_u8PerId);
+            BITBAND_SET(RCC->AHBENR, Copy_u8PerId);
             break; // Enables the clock of the required peripheral on AHB
         case RCC_APB1:
-            SET_BIT(RCC->APB1ENR, Copy_u8PerId);
+            BITBAND_SET(RCC->APB1ENR, Copy_u8PerId);
             break; // Enables the clock of the required peripheral on APB1
         case RCC_APB2:
-            SET_BIT(RCC->APB2ENR, Copy_u8PerId);
+            BITBAND_SET(RCC->APB2ENR, Copy_u8PerId);
             break; // Enables the clock of the required peripheral on APB2
         default:
             return RCC_NOK;
@@ -46,13 +47,13 @@ RCC_ErrorStatus RCC_voidDisableClock(u8 Copy_u8BusId, u8 Copy_u8PerId)
         switch (Copy_u8BusId)
         {
         case RCC_AHB:
-            CLR_BIT(RCC->AHBENR, Copy_u8PerId);
+            BITBAND_CLR(RCC->AHBENR, Copy_u8PerId);
             break;
         case RCC_APB1:
-            CLR_BIT(RCC->APB1ENR, Copy_u8PerId);
+            BITBAND_CLR(RCC->APB1ENR, Copy_u8PerId);
             break;
         case RCC_APB2:
-            CLR_BIT(RCC->APB2ENR, Copy_u8PerId);
+            BITBAND_CLR(RCC->APB2ENR, Copy_u8PerId);
             return RCC_OK;
         }
     }
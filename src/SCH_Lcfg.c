@@ -0,0 +1,29 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SCH (time-triggered scheduler)          */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#include "STD_TYPES.h"
+
+#include "SCH_interface.h"
+#include "SCH_config.h"
+#include "SCH_private.h"
+#include "telemetry_config.h"
+#include "SWT_interface.h"
+
+/* Application tasks (main.c) */
+extern void sonarTask(void);
+extern void speedTask(void);
+extern void accTask(void);
+extern void telemetryTask(void);
+
+/* Periods and offsets in ticks of SCH_TICK_MS */
+const SCH_Task_t SCH_Tasks[SCH_NUMBER_OF_TASKS] =
+{
+	[SCH_TASK_TIMERS]    = { .pfTask = SWT_voidDispatch, .Period = 1,   .Offset = 0 },
+	[SCH_TASK_SONAR]     = { .pfTask = sonarTask,     .Period = 1,   .Offset = 0 },
+	[SCH_TASK_SPEED]     = { .pfTask = speedTask,     .Period = 10,  .Offset = 1 },
+	[SCH_TASK_ACC]       = { .pfTask = accTask,       .Period = 20,  .Offset = 2 },
+	[SCH_TASK_TELEMETRY] = { .pfTask = telemetryTask, .Period = TELEMETRY_PERIOD_MS / SCH_TICK_MS, .Offset = 7 },
+};
@@ -0,0 +1,327 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SCH (time-triggered scheduler)          */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+
+#include "STK_interface.h"
+#include "STK_config.h"
+
+#include "SCH_interface.h"
+#include "SCH_config.h"
+#include "SCH_private.h"
+
+#if (SCH_IDLE_MODE == SCH_IDLE_TICKLESS) && (SCH_TICKLESS_MIN_TICKS < 2)
+	#error "SCH_TICKLESS_MIN_TICKS must be at least 2"
+#endif
+
+static volatile u32 SCH_u32Ticks = 0;
+
+/* Ticks counted by the next SysTick interrupt, the tick boundaries left in a tickless period */
+static volatile u32 SCH_u32TickStep = 1;
+
+/* The SysTick period in progress is not SCH_COUNTS_PER_TICK, its interrupt restores the periodic tick */
+static volatile u8 SCH_u8StkReprogrammed = 0;
+
+static SCH_TaskStats_t SCH_Stats[SCH_NUMBER_OF_TASKS];
+
+#if SCH_IDLE_MEASURE
+/* Measurement window of SCH_voidGetLoad */
+static u32 SCH_u32IdleUs = 0;
+static u32 SCH_u32LoadStartUs = 0;
+#endif
+
+void SCH_voidInit(void)
+{
+	u8 i;
+
+	SCH_u32Ticks = 0;
+	SCH_u32TickStep = 1;
+	SCH_u8StkReprogrammed = 0;
+	for (i = 0; i < SCH_NUMBER_OF_TASKS; i++)
+	{
+		SCH_Stats[i] = (SCH_TaskStats_t){ .NextRelease = SCH_Tasks[i].Offset };
+	}
+
+	/* SysTick is the scheduler time base, nothing else may reprogram it */
+	MSTK_voidInit();
+	MSTK_voidSetIntervalPeriodic(SCH_TICK_MS, MSTK_MILLIS, SCH_voidTick);
+
+#if SCH_IDLE_MEASURE
+	SCH_u32IdleUs = 0;
+	SCH_u32LoadStartUs = SCH_u32GetTimeUs();
+#endif
+}
+
+/* SysTick callback, a host build can call it directly as a fake tick */
+void SCH_voidTick(void)
+{
+	SCH_u32Ticks += SCH_u32TickStep;
+	SCH_u32TickStep = 1;
+	if (SCH_u8StkReprogrammed)
+	{
+		/* Back to the periodic tick, the interrupt latency (a few counts) is lost once per tickless period */
+		MSTK_voidRestart(SCH_COUNTS_PER_TICK - 1);
+		SCH_u8StkReprogrammed = 0;
+	}
+}
+
+/* A tickless period has a tick boundary every SCH_COUNTS_PER_TICK counts before its end: the ones
+   already passed are counted ahead of its interrupt (Copy_u32Value is SysTick VAL, interrupts masked) */
+static void SCH_voidCatchUp(u32 Copy_u32Value)
+{
+	u32 Local_u32Left;
+
+	/* 0 right after a restart or at the end of the period, the interrupt counts the ticks */
+	if ((SCH_u32TickStep > 1) && (Copy_u32Value != 0))
+	{
+		Local_u32Left = (Copy_u32Value + SCH_COUNTS_PER_TICK - 1) / SCH_COUNTS_PER_TICK;
+		if (Local_u32Left < SCH_u32TickStep)
+		{
+			SCH_u32Ticks += SCH_u32TickStep - Local_u32Left;
+			SCH_u32TickStep = Local_u32Left;
+		}
+	}
+}
+
+u32 SCH_u32GetTickCount(void)
+{
+	if (SCH_u32TickStep > 1)
+	{
+		SCH_IRQ_DISABLE();
+		SCH_voidCatchUp(MSTK_u32CurrentVal());
+		SCH_IRQ_ENABLE();
+	}
+	return SCH_u32Ticks;
+}
+
+u32 SCH_u32GetTimeUs(void)
+{
+	u32 Local_u32Ticks;
+	u32 Local_u32Value;
+	u32 Local_u32Counts;
+
+	/* Re-read if the tick moved while SysTick was sampled */
+	do
+	{
+		SCH_IRQ_DISABLE();
+		Local_u32Value = MSTK_u32CurrentVal();
+		SCH_voidCatchUp(Local_u32Value);
+		Local_u32Ticks = SCH_u32Ticks;
+		SCH_IRQ_ENABLE();
+	} while (Local_u32Ticks != SCH_u32Ticks);
+
+	/* Counts since the last tick boundary, the same for the periodic tick and a tickless period */
+	Local_u32Counts = (SCH_COUNTS_PER_TICK - 1) - ((Local_u32Value + SCH_COUNTS_PER_TICK - 1) % SCH_COUNTS_PER_TICK);
+
+	return (Local_u32Ticks * SCH_TICK_MS * 1000) + ((Local_u32Counts * SCH_TICK_MS * 1000) / SCH_COUNTS_PER_TICK);
+}
+
+#if (SCH_IDLE_MODE != SCH_IDLE_BUSY)
+/* Earliest release of all the tasks */
+static u32 SCH_u32GetNextRelease(void)
+{
+	u8 i;
+	u32 Local_u32Next = SCH_Stats[0].NextRelease;
+
+	for (i = 1; i < SCH_NUMBER_OF_TASKS; i++)
+	{
+		if ((s32)(SCH_Stats[i].NextRelease - Local_u32Next) < 0)
+		{
+			Local_u32Next = SCH_Stats[i].NextRelease;
+		}
+	}
+	return Local_u32Next;
+}
+#endif
+
+#if (SCH_IDLE_MODE == SCH_IDLE_TICKLESS)
+/* One SysTick period ending on the tick boundary of the next release replaces the periodic tick.
+   It keeps running through the interrupts that wake the core earlier, SCH_u32GetTickCount counts
+   the boundaries already passed, so the core wakes once per release instead of once per tick.
+   Called with the interrupts masked, a few counts are lost each time the period is reprogrammed */
+static void SCH_voidSleepTicks(u32 Copy_u32Now, u32 Copy_u32Ticks)
+{
+	u32 Local_u32Value;
+	u32 Local_u32ToBoundary;
+	u32 Local_u32Load;
+
+	MSTK_voidCounterEnDis(MSTK_COUNTER_DIS);
+	Local_u32Value = MSTK_u32CurrentVal();
+	if ((Local_u32Value == 0) && (SCH_u32TickStep == 1) && !MSTK_u8GetPendingFlag())
+	{
+		/* The tick interrupt was just taken, the next count reloads a whole periodic tick */
+		Local_u32Value = SCH_COUNTS_PER_TICK;
+	}
+	SCH_voidCatchUp(Local_u32Value);
+
+	/* A tick went by: back to the dispatcher. The period ends now: its interrupt wakes the core */
+	if ((SCH_u32Ticks != Copy_u32Now) || (Local_u32Value == 0) || MSTK_u8GetPendingFlag() || (SCH_u32TickStep == Copy_u32Ticks))
+	{
+		MSTK_voidCounterEnDis(MSTK_COUNTER_EN);
+		if (SCH_u32Ticks == Copy_u32Now)
+		{
+			SCH_WFI();
+		}
+		return;
+	}
+
+	Local_u32ToBoundary = ((Local_u32Value - 1) % SCH_COUNTS_PER_TICK) + 1;
+	if (Copy_u32Ticks > (((SCH_STK_MAX_LOAD - Local_u32ToBoundary) / SCH_COUNTS_PER_TICK) + 1))
+	{
+		Copy_u32Ticks = ((SCH_STK_MAX_LOAD - Local_u32ToBoundary) / SCH_COUNTS_PER_TICK) + 1;
+	}
+	Local_u32Load = Local_u32ToBoundary + ((Copy_u32Ticks - 1) * SCH_COUNTS_PER_TICK) - 1;
+	if (Local_u32Load == 0)
+	{
+		/* The boundary is one count away and a reload of 0 stops SysTick: the release waits one more tick */
+		Local_u32Load = SCH_COUNTS_PER_TICK;
+		Copy_u32Ticks = 2;
+	}
+	SCH_u32TickStep = Copy_u32Ticks;
+	SCH_u8StkReprogrammed = 1;
+	MSTK_voidRestart(Local_u32Load);
+	MSTK_voidCounterEnDis(MSTK_COUNTER_EN);
+
+	SCH_WFI();
+}
+#endif
+
+/* Nothing released in the last pass: wait for the next release as configured by SCH_IDLE_MODE.
+   The interrupt that ends the wait runs once the interrupts are unmasked again */
+static void SCH_voidIdle(void)
+{
+#if (SCH_IDLE_MODE == SCH_IDLE_BUSY)
+	SCH_IDLE_HOOK();
+#else
+	u32 Local_u32Now = SCH_u32GetTickCount();
+	u32 Local_u32Ticks = SCH_u32GetNextRelease() - Local_u32Now;
+
+	if ((s32)Local_u32Ticks <= 0)
+	{
+		return;
+	}
+
+	SCH_IRQ_DISABLE();
+#if (SCH_IDLE_MODE == SCH_IDLE_TICKLESS)
+	/* A tickless period in progress may end after the next release, it is reprogrammed as well */
+	if ((Local_u32Ticks >= SCH_TICKLESS_MIN_TICKS) || SCH_u8StkReprogrammed)
+	{
+		SCH_voidSleepTicks(Local_u32Now, Local_u32Ticks);
+	}
+	else
+#endif
+	if (SCH_u32Ticks == Local_u32Now)
+	{
+		SCH_WFI();
+	}
+	SCH_IRQ_ENABLE();
+#endif
+}
+
+void SCH_voidDispatch(void)
+{
+	u8 i;
+	u32 Local_u32Now;
+	u32 Local_u32Start;
+	u32 Local_u32Missed;
+	u8 Local_u8Released = 0;
+	SCH_TaskStats_t *Local_pStats;
+
+	for (i = 0; i < SCH_NUMBER_OF_TASKS; i++)
+	{
+		Local_pStats = &SCH_Stats[i];
+		Local_u32Now = SCH_u32GetTickCount();
+
+		if ((s32)(Local_u32Now - Local_pStats->NextRelease) >= 0)
+		{
+			/* Release jitter */
+			if ((Local_u32Now - Local_pStats->NextRelease) > Local_pStats->MaxLateness)
+			{
+				Local_pStats->MaxLateness = Local_u32Now - Local_pStats->NextRelease;
+			}
+
+			/* Released before the task runs, so the task can defer its own next release */
+			Local_pStats->NextRelease += SCH_Tasks[i].Period;
+
+			Local_u32Start = SCH_u32GetTimeUs();
+			SCH_Tasks[i].pfTask();
+			SCH_TASK_DONE_HOOK();
+			Local_pStats->LastExecTimeUs = SCH_u32GetTimeUs() - Local_u32Start;
+
+			Local_u8Released = 1;
+			Local_pStats->RunCount++;
+			if (Local_pStats->LastExecTimeUs > Local_pStats->WcetUs)
+			{
+				Local_pStats->WcetUs = Local_pStats->LastExecTimeUs;
+			}
+
+			/* Overrun: the next release already passed when the task ended */
+			Local_u32Now = SCH_u32GetTickCount();
+			if ((s32)(Local_u32Now - Local_pStats->NextRelease) > 0)
+			{
+				Local_pStats->OverrunCount++;
+
+				/* Whole periods lost are skipped instead of being run back to back */
+				Local_u32Missed = (Local_u32Now - Local_pStats->NextRelease) / SCH_Tasks[i].Period;
+				Local_pStats->OverrunCount += Local_u32Missed;
+				Local_pStats->NextRelease += Local_u32Missed * SCH_Tasks[i].Period;
+			}
+		}
+	}
+
+	if (!Local_u8Released)
+	{
+#if SCH_IDLE_MEASURE
+		/* The interrupt handlers that end the idle period are counted as idle */
+		Local_u32Start = SCH_u32GetTimeUs();
+		SCH_voidIdle();
+		SCH_u32IdleUs += SCH_u32GetTimeUs() - Local_u32Start;
+#else
+		SCH_voidIdle();
+#endif
+	}
+}
+
+const SCH_TaskStats_t * SCH_pGetTaskStats(u8 Copy_u8TaskId)
+{
+	return (Copy_u8TaskId < SCH_NUMBER_OF_TASKS) ? &SCH_Stats[Copy_u8TaskId] : NULL;
+}
+
+/* Called by a task on itself: its next release moves to Copy_u32Tick when that is later */
+void SCH_voidDeferTask(u8 Copy_u8TaskId, u32 Copy_u32Tick)
+{
+	if ((Copy_u8TaskId < SCH_NUMBER_OF_TASKS) && ((s32)(Copy_u32Tick - SCH_Stats[Copy_u8TaskId].NextRelease) > 0))
+	{
+		SCH_Stats[Copy_u8TaskId].NextRelease = Copy_u32Tick;
+	}
+}
+
+/* Brings the next release of a deferred task back to Copy_u32Tick when that is earlier (main loop context) */
+void SCH_voidAdvanceTask(u8 Copy_u8TaskId, u32 Copy_u32Tick)
+{
+	if ((Copy_u8TaskId < SCH_NUMBER_OF_TASKS) && ((s32)(Copy_u32Tick - SCH_Stats[Copy_u8TaskId].NextRelease) < 0))
+	{
+		SCH_Stats[Copy_u8TaskId].NextRelease = Copy_u32Tick;
+	}
+}
+
+/* Idle and active time since the previous call (or SCH_voidInit), starts a new window */
+void SCH_voidGetLoad(SCH_Load_t * Copy_pLoad)
+{
+#if SCH_IDLE_MEASURE
+	u32 Local_u32Now = SCH_u32GetTimeUs();
+	u32 Local_u32Total = Local_u32Now - SCH_u32LoadStartUs;
+
+	Copy_pLoad->IdleUs = (SCH_u32IdleUs > Local_u32Total) ? Local_u32Total : SCH_u32IdleUs;
+	Copy_pLoad->ActiveUs = Local_u32Total - Copy_pLoad->IdleUs;
+	SCH_u32IdleUs = 0;
+	SCH_u32LoadStartUs = Local_u32Now;
+#else
+	Copy_pLoad->IdleUs = 0;
+	Copy_pLoad->ActiveUs = 0;
+#endif
+}
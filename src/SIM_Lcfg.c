@@ -0,0 +1,201 @@
+/*******************************************************/
+/* Layer     : Host simulation                         */
+/* SWC       : SIM (virtual STM32F103)                 */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifdef HOST_SIM
+
+#include <stdio.h>
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+#include "stm32f103C8.h"
+
+#include "SIM_interface.h"
+#include "SIM_config.h"
+#include "sonar.h"
+#include "sonar_config.h"
+#include "hall.h"
+#include "hall_config.h"
+#include "PWM.h"
+#include "speed_control_config.h"
+
+/* Sonar ranging commands: result in inches, centimeters or microseconds */
+#define SIM_SONAR_CMD_INCH			80
+#define SIM_SONAR_CMD_CM			81
+#define SIM_SONAR_CMD_US			82
+
+#define SIM_PI						3.14159265358979
+
+/* Actuator outputs: PWM channel ids are timer major in the order of the SIM timers (TIM2, TIM3, TIM4, TIM1) */
+#define SIM_MOTOR_TIMER				(SPEEDCTRL_MOTOR_CHANNEL / MPWM_CHANNELS_PER_TIMER)
+#define SIM_MOTOR_CHANNEL			(SPEEDCTRL_MOTOR_CHANNEL % MPWM_CHANNELS_PER_TIMER)
+#define SIM_BRAKE_TIMER				(SPEEDCTRL_BRAKE_CHANNEL / MPWM_CHANNELS_PER_TIMER)
+#define SIM_BRAKE_CHANNEL			(SPEEDCTRL_BRAKE_CHANNEL % MPWM_CHANNELS_PER_TIMER)
+
+/* Plant state */
+static double SIM_f64EgoSpeed = 0;			/* m/s */
+static double SIM_f64LeadSpeed = SIM_LEAD_SPEED_KMH / 3.6;
+static double SIM_f64Gap = SIM_INITIAL_GAP_M;
+static double SIM_f64MinGap = SIM_INITIAL_GAP_M;
+static double SIM_f64MaxSpeed = 0;
+static double SIM_f64TimeS = 0;
+static double SIM_f64CollisionS = -1;
+
+/* Sonar models: range latched at the ranging command, read as high then low byte */
+typedef struct
+{
+	u16 Range;
+	u8 ReadIndex;
+	u8 Rear;
+} SIM_Sonar_t;
+
+static SIM_Sonar_t SIM_Sonars[SONAR_COUNT] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 1}, {0, 0, 1}};
+
+static void SIM_voidSonarStart(u8 Copy_u8Index, u8 Copy_u8Read)
+{
+	(void)Copy_u8Read;
+	SIM_Sonars[Copy_u8Index].ReadIndex = 0;
+}
+
+static u8 SIM_u8SonarWrite(u8 Copy_u8Index, u8 Copy_u8Data)
+{
+	SIM_Sonar_t *pSonar = &SIM_Sonars[Copy_u8Index];
+	u32 LOC_u32Cm = pSonar->Rear ? SIM_REAR_GAP_CM : (u32)(SIM_f64Gap * 100);
+
+	/* no echo beyond the range, the sonar reports 0 */
+	if (LOC_u32Cm > SIM_SONAR_MAX_CM)
+	{
+		LOC_u32Cm = 0;
+	}
+	switch (Copy_u8Data)
+	{
+	case SIM_SONAR_CMD_INCH: pSonar->Range = (u16)((LOC_u32Cm * 100) / 254);	break;
+	case SIM_SONAR_CMD_CM:   pSonar->Range = (u16)LOC_u32Cm;					break;
+	case SIM_SONAR_CMD_US:   pSonar->Range = (u16)(((LOC_u32Cm * 58) > 0xFFFF) ? 0xFFFF : (LOC_u32Cm * 58));	break;
+	default:																	break;
+	}
+	return 1;
+}
+
+static u8 SIM_u8SonarRead(u8 Copy_u8Index)
+{
+	SIM_Sonar_t *pSonar = &SIM_Sonars[Copy_u8Index];
+
+	return (pSonar->ReadIndex++ == 0) ? (u8)(pSonar->Range >> 8) : (u8)pSonar->Range;
+}
+
+/* One slave per sonar on I2C1, at the addresses of sonar.h */
+#define SIM_SONAR_SLAVE(INDEX, ADDRESS)																\
+	static void SIM_voidSonar##INDEX##Start(u8 Copy_u8Read) { SIM_voidSonarStart(INDEX, Copy_u8Read); }	\
+	static u8 SIM_u8Sonar##INDEX##Write(u8 Copy_u8Data) { return SIM_u8SonarWrite(INDEX, Copy_u8Data); }	\
+	static u8 SIM_u8Sonar##INDEX##Read(void) { return SIM_u8SonarRead(INDEX); }							\
+	static const SIM_I2CSlave_t SIM_Sonar##INDEX##Slave =												\
+		{SONAR_BASE_ADDRESS | (ADDRESS), SIM_voidSonar##INDEX##Start, SIM_u8Sonar##INDEX##Write, SIM_u8Sonar##INDEX##Read, NULL}
+
+SIM_SONAR_SLAVE(0, SONAR_F1_ADDRESS);
+SIM_SONAR_SLAVE(1, SONAR_F2_ADDRESS);
+SIM_SONAR_SLAVE(2, SONAR_B1_ADDRESS);
+SIM_SONAR_SLAVE(3, SONAR_B2_ADDRESS);
+
+void SIM_voidWorldInit(void)
+{
+	SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &SIM_Sonar0Slave);
+	SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &SIM_Sonar1Slave);
+	SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &SIM_Sonar2Slave);
+	SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &SIM_Sonar3Slave);
+}
+
+void SIM_voidWorldStep(u32 Copy_u32Us)
+{
+	double LOC_f64Dt = Copy_u32Us * 1e-6;
+	double LOC_f64Target;
+	double LOC_f64Accel;
+	u32 LOC_u32Ms;
+
+	SIM_f64TimeS += LOC_f64Dt;
+	LOC_u32Ms = (u32)(SIM_f64TimeS * 1000);
+
+	/* lead car: cruise, slow down for a while, cruise again */
+	LOC_f64Target = ((LOC_u32Ms >= SIM_LEAD_SLOW_START_MS) && (LOC_u32Ms < SIM_LEAD_SLOW_END_MS)) ?
+					(SIM_LEAD_SLOW_SPEED_KMH / 3.6) : (SIM_LEAD_SPEED_KMH / 3.6);
+	if (SIM_f64LeadSpeed < LOC_f64Target)
+	{
+		SIM_f64LeadSpeed += SIM_LEAD_ACCEL_MS2 * LOC_f64Dt;
+		SIM_f64LeadSpeed = (SIM_f64LeadSpeed > LOC_f64Target) ? LOC_f64Target : SIM_f64LeadSpeed;
+	}
+	else
+	{
+		SIM_f64LeadSpeed -= SIM_LEAD_ACCEL_MS2 * LOC_f64Dt;
+		SIM_f64LeadSpeed = (SIM_f64LeadSpeed < LOC_f64Target) ? LOC_f64Target : SIM_f64LeadSpeed;
+	}
+
+	/* BKIN of the TIM1 drive, asserted from SIM_BKIN_ASSERT_MS on */
+#if SIM_BKIN_ASSERT_MS
+	if (LOC_u32Ms >= SIM_BKIN_ASSERT_MS)
+	{
+		SIM_voidSetBreakInput(1);
+	}
+#endif
+
+	/* ego car: motor and brake duties against a linear drag */
+	LOC_f64Accel = ((SIM_u32TimerDutyQ16(SIM_MOTOR_TIMER, SIM_MOTOR_CHANNEL) / 65536.0) * SIM_MAX_ACCEL_MS2) -
+				   ((SIM_u32TimerDutyQ16(SIM_BRAKE_TIMER, SIM_BRAKE_CHANNEL) / 65536.0) * SIM_MAX_BRAKE_MS2) -
+				   (SIM_DRAG_PER_S * SIM_f64EgoSpeed);
+	SIM_f64EgoSpeed += LOC_f64Accel * LOC_f64Dt;
+	if (SIM_f64EgoSpeed < 0)
+	{
+		SIM_f64EgoSpeed = 0;
+	}
+	if (SIM_f64EgoSpeed > SIM_f64MaxSpeed)
+	{
+		SIM_f64MaxSpeed = SIM_f64EgoSpeed;
+	}
+
+	SIM_f64Gap += (SIM_f64LeadSpeed - SIM_f64EgoSpeed) * LOC_f64Dt;
+	if (SIM_f64Gap < SIM_f64MinGap)
+	{
+		SIM_f64MinGap = SIM_f64Gap;
+	}
+	if ((SIM_f64Gap <= 0) && (SIM_f64CollisionS < 0))
+	{
+		SIM_f64CollisionS = SIM_f64TimeS;
+	}
+}
+
+/* Hall edge period of the wheel, 0 when it is (almost) stopped */
+u32 SIM_u32WorldHallPeriodUs(void)
+{
+	double LOC_f64Circumference = 2 * SIM_PI * HALL_WHEEL_RADIUS_MM / 1000.0;
+
+	if (SIM_f64EgoSpeed < 0.05)
+	{
+		return 0;
+	}
+	return (u32)((LOC_f64Circumference / SIM_f64EgoSpeed / HALL_PULSES_PER_REV) * 1e6);
+}
+
+/* Fails the run (exit status 1) on a collision or a gap below SIM_MIN_GAP_M */
+u8 SIM_u8WorldReport(void)
+{
+	u8 LOC_u8Status = 0;
+
+	fprintf(stderr, "ego speed     : %.1f km/h (max %.1f km/h)\n", SIM_f64EgoSpeed * 3.6, SIM_f64MaxSpeed * 3.6);
+	fprintf(stderr, "lead speed    : %.1f km/h\n", SIM_f64LeadSpeed * 3.6);
+	fprintf(stderr, "gap           : %.2f m (min %.2f m)\n", SIM_f64Gap, SIM_f64MinGap);
+	if (SIM_f64CollisionS >= 0)
+	{
+		fprintf(stderr, "collision     : at %.3f s\n", SIM_f64CollisionS);
+		LOC_u8Status = 1;
+	}
+	else if (SIM_f64MinGap < SIM_MIN_GAP_M)
+	{
+		fprintf(stderr, "gap violation : %.2f m, limit %.2f m\n", SIM_f64MinGap, SIM_MIN_GAP_M);
+		LOC_u8Status = 1;
+	}
+	fprintf(stderr, "result        : %s\n", LOC_u8Status ? "FAIL" : "PASS");
+	return LOC_u8Status;
+}
+
+#endif
@@ -0,0 +1,1264 @@
+/*******************************************************/
+/* Layer     : Host simulation                         */
+/* SWC       : SIM (virtual STM32F103)                 */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#ifdef HOST_SIM
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+#include "stm32f103C8.h"
+#include "BIT_BAND.h"
+
+#include "SIM_interface.h"
+#include "SIM_config.h"
+#include "SIM_private.h"
+
+/* Register memory, the register blocks of stm32f103C8.h point into it */
+unsigned char SIM_u8PeriphMemory[SIM_PERIPH_SIZE] __attribute__((aligned(8)));
+unsigned char SIM_u8CoreMemory[SIM_CORE_SIZE] __attribute__((aligned(8)));
+
+/* Handlers of the firmware image, NULL when the image does not define them */
+extern void SysTick_Handler(void) __attribute__((weak));
+extern void DMA1_Channel1_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Channel2_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Channel3_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Channel4_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Channel5_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Channel6_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Channel7_IRQHandler(void) __attribute__((weak));
+extern void TIM2_IRQHandler(void) __attribute__((weak));
+extern void TIM3_IRQHandler(void) __attribute__((weak));
+extern void TIM4_IRQHandler(void) __attribute__((weak));
+extern void I2C1_EV_IRQHandler(void) __attribute__((weak));
+extern void I2C1_ER_IRQHandler(void) __attribute__((weak));
+extern void I2C2_EV_IRQHandler(void) __attribute__((weak));
+extern void I2C2_ER_IRQHandler(void) __attribute__((weak));
+extern void USART1_IRQHandler(void) __attribute__((weak));
+
+static void (*SIM_apfHandlers[SIM_IRQN_COUNT])(void);
+
+/* Virtual time */
+static unsigned long long SIM_u64TimeUs = 0;
+static clock_t SIM_HostStart;
+static unsigned long long SIM_u64FirmwareCycles = 0;	/* firmware cycles not yet turned into virtual time */
+static unsigned long long SIM_u64SettleCycles = 0;		/* part of them being turned into virtual time */
+#if SIM_CYCCNT_HOST_TIME
+static unsigned long long SIM_u64HostStartNs;
+static unsigned long long SIM_u64ModelNs = 0;		/* host time spent in SIM_voidAdvance */
+#endif
+static unsigned long long SIM_u64CycleMark = 0;		/* cycle total at the last CYCCNT update */
+static u32 SIM_u32HallPhaseUs = 0;
+static u32 SIM_u32StkDivider = 0;
+static u32 SIM_u32Interrupts = 0;			/* handler runs, ends SIM_voidWaitForInterrupt */
+
+/* Peripheral models */
+static volatile TIMER_RegDef_t * const SIM_apTimers[SIM_TIMERS] = {TIMER2, TIMER3, TIMER4, TIMER1};
+static const u8 SIM_au8TimerIrq[SIM_TIMERS] = {SIM_IRQN_TIM2, SIM_IRQN_TIM3, SIM_IRQN_TIM4, SIM_IRQN_TIM1_UP};
+static const u8 SIM_au8TimerUpDma[SIM_TIMERS] = {1, 2, 6, 4};	/* TIMx_UP requests: DMA1 channels 2, 3, 7 and 5 */
+static SIM_Timer_t SIM_Timers[SIM_TIMERS];
+static u8 SIM_u8BreakInput = 0;
+
+static SIM_DmaChannel_t SIM_Dma[SIM_DMA_CHANNELS];
+static u32 SIM_u32DmaISR = 0;
+
+static SIM_Usart_t SIM_Usart;
+
+static I2C_RegDef_t * const SIM_apI2C[SIM_I2C_BUSES] = {I2C1_BASE, I2C2_BASE};
+static const u8 SIM_au8I2CTxDma[SIM_I2C_BUSES] = {5, 3};
+static const u8 SIM_au8I2CRxDma[SIM_I2C_BUSES] = {6, 4};
+static const u8 SIM_au8I2CEvIrq[SIM_I2C_BUSES] = {SIM_IRQN_I2C1_EV, SIM_IRQN_I2C2_EV};
+static const u8 SIM_au8I2CErIrq[SIM_I2C_BUSES] = {SIM_IRQN_I2C1_ER, SIM_IRQN_I2C2_ER};
+static SIM_I2CBus_t SIM_I2C[SIM_I2C_BUSES];
+
+#if SIM_CYCCNT_HOST_TIME
+static unsigned long long SIM_u64HostNs(void)
+{
+	struct timespec LOC_Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &LOC_Now);
+	return ((unsigned long long)LOC_Now.tv_sec * 1000000000ULL) + (unsigned long long)LOC_Now.tv_nsec;
+}
+#endif
+
+/* Reset values, the handler table and the world, before main() runs */
+static void SIM_voidReset(void) __attribute__((constructor));
+static void SIM_voidReset(void)
+{
+	u8 i;
+
+	for (i = 0; i < SIM_TIMERS; i++)
+	{
+		SIM_apTimers[i]->ARR = 0xFFFF;
+	}
+	MUSART1->DR = SIM_DR_EMPTY;
+	MUSART1->SR = (1 << SIM_USART_SR_TXE) | (1 << SIM_USART_SR_TC);
+	SIM_Usart.TCLatch = 1;
+	for (i = 0; i < SIM_I2C_BUSES; i++)
+	{
+		SIM_apI2C[i]->DR = SIM_DR_EMPTY;
+	}
+
+	SIM_apfHandlers[SIM_IRQN_DMA1_CHANNEL1 + 0] = DMA1_Channel1_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_DMA1_CHANNEL1 + 1] = DMA1_Channel2_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_DMA1_CHANNEL1 + 2] = DMA1_Channel3_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_DMA1_CHANNEL1 + 3] = DMA1_Channel4_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_DMA1_CHANNEL1 + 4] = DMA1_Channel5_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_DMA1_CHANNEL1 + 5] = DMA1_Channel6_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_DMA1_CHANNEL1 + 6] = DMA1_Channel7_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_TIM2] = TIM2_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_TIM3] = TIM3_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_TIM4] = TIM4_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_I2C1_EV] = I2C1_EV_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_I2C1_ER] = I2C1_ER_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_I2C2_EV] = I2C2_EV_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_I2C2_ER] = I2C2_ER_IRQHandler;
+	SIM_apfHandlers[SIM_IRQN_USART1] = USART1_IRQHandler;
+
+	if (SIM_USART1_SINK_FILE != NULL)
+	{
+		SIM_Usart.pSink = fopen(SIM_USART1_SINK_FILE, "wb");
+	}
+	SIM_HostStart = clock();
+#if SIM_CYCCNT_HOST_TIME
+	SIM_u64HostStartNs = SIM_u64HostNs();
+#endif
+	SIM_voidWorldInit();
+}
+
+/************************************ NVIC ************************************/
+
+/* ISER / ICER and ISPR / ICPR are plain memory here: the clear registers are folded into the set ones */
+static void SIM_voidNvicSync(void)
+{
+	u8 i;
+
+	for (i = 0; i < (SIM_IRQN_COUNT / 32); i++)
+	{
+		NVIC->ISER[i] &= ~NVIC->ICER[i];
+		NVIC->ICER[i] = 0;
+		NVIC->ISPR[i] &= ~NVIC->ICPR[i];
+		NVIC->ICPR[i] = 0;
+	}
+}
+
+static void SIM_voidDmaSync(void);
+
+/* Calls the handler of an enabled interrupt, returns 1 if it ran */
+static u8 SIM_u8Raise(u8 Copy_u8Irq)
+{
+	SIM_voidNvicSync();
+	if (!GET_BIT(NVIC->ISER[Copy_u8Irq / 32], Copy_u8Irq % 32) || (SIM_apfHandlers[Copy_u8Irq] == NULL))
+	{
+		return 0;
+	}
+
+	SET_BIT(NVIC->IABR[Copy_u8Irq / 32], Copy_u8Irq % 32);
+	SIM_u32Interrupts++;
+	SIM_apfHandlers[Copy_u8Irq]();
+	CLR_BIT(NVIC->IABR[Copy_u8Irq / 32], Copy_u8Irq % 32);
+
+	SIM_voidNvicSync();
+	SIM_voidDmaSync();
+	return 1;
+}
+
+/************************************ DMA1 ************************************/
+
+/* Applies IFCR and latches the transfers (re)started by the software */
+static void SIM_voidDmaSync(void)
+{
+	u8 LOC_u8Channel;
+	u32 LOC_u32Clear = DMA1->IFCR;
+	volatile DMA_Channel_RegDef_t *pChannel;
+	SIM_DmaChannel_t *pState;
+
+	DMA1->IFCR = 0;
+	for (LOC_u8Channel = 0; LOC_u8Channel < SIM_DMA_CHANNELS; LOC_u8Channel++)
+	{
+		pChannel = &DMA1->Channel[LOC_u8Channel];
+		pState = &SIM_Dma[LOC_u8Channel];
+
+		/* CGIF clears all the flags of the channel */
+		if (GET_BIT(LOC_u32Clear, SIM_DMA_ISR_GIF(LOC_u8Channel)))
+		{
+			LOC_u32Clear |= 0xFUL << SIM_DMA_ISR_GIF(LOC_u8Channel);
+		}
+
+		if (!GET_BIT(pChannel->CCR, SIM_DMA_CCR_EN))
+		{
+			pState->Active = 0;
+		}
+		else if (!pState->Active || ((pChannel->CNDTR & 0xFFFF) != pState->Remaining) || (pChannel->CMAR != pState->Cmar))
+		{
+			pState->Active = 1;
+			pState->Remaining = pChannel->CNDTR & 0xFFFF;
+			pState->Length = pState->Remaining;
+			pState->Cmar = pChannel->CMAR;
+			pState->pu8Memory = (u8 *)pChannel->CMAR;
+		}
+	}
+
+	SIM_u32DmaISR &= ~LOC_u32Clear;
+	for (LOC_u8Channel = 0; LOC_u8Channel < SIM_DMA_CHANNELS; LOC_u8Channel++)
+	{
+		if (SIM_u32DmaISR & (0xEUL << SIM_DMA_ISR_GIF(LOC_u8Channel)))
+		{
+			SET_BIT(SIM_u32DmaISR, SIM_DMA_ISR_GIF(LOC_u8Channel));
+		}
+	}
+	DMA1->ISR = SIM_u32DmaISR;
+}
+
+/* One request of a peripheral: moves one data item (MSIZE) between CPAR and memory, returns 1 if it was moved */
+static u8 SIM_u8DmaRequest(u8 Copy_u8Channel)
+{
+	volatile DMA_Channel_RegDef_t *pChannel = &DMA1->Channel[Copy_u8Channel];
+	SIM_DmaChannel_t *pState = &SIM_Dma[Copy_u8Channel];
+	u8 LOC_u8Size;
+	u8 LOC_u8Byte;
+	u32 LOC_u32Data = 0;
+
+	SIM_voidDmaSync();
+	if (!pState->Active || (pState->Remaining == 0))
+	{
+		return 0;
+	}
+
+	/* little-endian items of 1, 2 or 4 bytes */
+	LOC_u8Size = (u8)(1 << ((pChannel->CCR >> SIM_DMA_CCR_MSIZE) & 3));
+	if (GET_BIT(pChannel->CCR, SIM_DMA_CCR_DIR))
+	{
+		for (LOC_u8Byte = 0; LOC_u8Byte < LOC_u8Size; LOC_u8Byte++)
+		{
+			LOC_u32Data |= (u32)pState->pu8Memory[LOC_u8Byte] << (8 * LOC_u8Byte);
+		}
+		*(volatile u32 *)pChannel->CPAR = LOC_u32Data;
+	}
+	else
+	{
+		LOC_u32Data = *(volatile u32 *)pChannel->CPAR;
+		for (LOC_u8Byte = 0; LOC_u8Byte < LOC_u8Size; LOC_u8Byte++)
+		{
+			pState->pu8Memory[LOC_u8Byte] = (u8)(LOC_u32Data >> (8 * LOC_u8Byte));
+		}
+	}
+	if (GET_BIT(pChannel->CCR, SIM_DMA_CCR_MINC))
+	{
+		pState->pu8Memory += LOC_u8Size;
+	}
+
+	pState->Remaining--;
+	if (pState->Remaining == (pState->Length / 2))
+	{
+		SET_BIT(SIM_u32DmaISR, SIM_DMA_ISR_HTIF(Copy_u8Channel));
+	}
+	if (pState->Remaining == 0)
+	{
+		SET_BIT(SIM_u32DmaISR, SIM_DMA_ISR_TCIF(Copy_u8Channel));
+		if (GET_BIT(pChannel->CCR, SIM_DMA_CCR_CIRC))
+		{
+			pState->Remaining = pState->Length;
+			pState->pu8Memory = (u8 *)pState->Cmar;
+		}
+	}
+	SET_BIT(SIM_u32DmaISR, SIM_DMA_ISR_GIF(Copy_u8Channel));
+	pChannel->CNDTR = pState->Remaining;
+	DMA1->ISR = SIM_u32DmaISR;
+
+	return 1;
+}
+
+static u32 SIM_u32DmaRemaining(u8 Copy_u8Channel)
+{
+	SIM_voidDmaSync();
+	return SIM_Dma[Copy_u8Channel].Active ? SIM_Dma[Copy_u8Channel].Remaining : 0;
+}
+
+/* Channel interrupts: TCIF / HTIF / TEIF with their enable bits */
+static u8 SIM_u8DmaServe(void)
+{
+	u8 LOC_u8Channel;
+	u8 LOC_u8Served = 0;
+
+	SIM_voidDmaSync();
+	for (LOC_u8Channel = 0; LOC_u8Channel < SIM_DMA_CHANNELS; LOC_u8Channel++)
+	{
+		if ((SIM_u32DmaISR >> SIM_DMA_ISR_GIF(LOC_u8Channel)) & DMA1->Channel[LOC_u8Channel].CCR & 0xE)
+		{
+			LOC_u8Served |= SIM_u8Raise(SIM_IRQN_DMA1_CHANNEL1 + LOC_u8Channel);
+		}
+	}
+	return LOC_u8Served;
+}
+
+/************************************ SysTick ************************************/
+
+static void SIM_voidStkStep(u32 Copy_u32Cycles)
+{
+	u32 LOC_u32Counts;
+	u32 LOC_u32Value;
+
+	if (!GET_BIT(STK->CTRL, SIM_STK_ENABLE))
+	{
+		CLR_BIT(STK->CTRL, SIM_STK_COUNTFLAG);
+		return;
+	}
+
+	if (GET_BIT(STK->CTRL, SIM_STK_CLKSOURCE))
+	{
+		LOC_u32Counts = Copy_u32Cycles;
+	}
+	else
+	{
+		SIM_u32StkDivider += Copy_u32Cycles;
+		LOC_u32Counts = SIM_u32StkDivider / 8;
+		SIM_u32StkDivider %= 8;
+	}
+
+	LOC_u32Value = STK->VAL & 0xFFFFFF;
+	while ((LOC_u32Counts != 0) && GET_BIT(STK->CTRL, SIM_STK_ENABLE))
+	{
+		if (LOC_u32Value == 0)
+		{
+			/* a write to VAL clears it, the next count reloads */
+			LOC_u32Value = STK->LOAD & 0xFFFFFF;
+			LOC_u32Counts--;
+			if (LOC_u32Value == 0)
+			{
+				break;
+			}
+		}
+		else if (LOC_u32Counts < LOC_u32Value)
+		{
+			LOC_u32Value -= LOC_u32Counts;
+			LOC_u32Counts = 0;
+		}
+		else
+		{
+			LOC_u32Counts -= LOC_u32Value;
+			LOC_u32Value = 0;
+			SET_BIT(STK->CTRL, SIM_STK_COUNTFLAG);
+			if (GET_BIT(STK->CTRL, SIM_STK_TICKINT) && (SysTick_Handler != NULL))
+			{
+				STK->VAL = 0;
+				SIM_u32Interrupts++;
+				SysTick_Handler();
+				SIM_voidDmaSync();
+				LOC_u32Value = STK->VAL & 0xFFFFFF;
+			}
+		}
+	}
+	STK->VAL = LOC_u32Value;
+}
+
+/************************************ TIM2..TIM4 ************************************/
+
+/* Active compare values: CCRx goes through at once without OCxPE, at the update events with it */
+static void SIM_voidTimerLoadCompare(u8 Copy_u8Timer, u8 Copy_u8Update)
+{
+	volatile TIMER_RegDef_t *pTimer = SIM_apTimers[Copy_u8Timer];
+	SIM_Timer_t *pState = &SIM_Timers[Copy_u8Timer];
+	u8 LOC_u8Channel;
+	u32 LOC_u32Ccmr;
+
+	for (LOC_u8Channel = 0; LOC_u8Channel < 4; LOC_u8Channel++)
+	{
+		LOC_u32Ccmr = (LOC_u8Channel < 2) ? pTimer->CCMR1 : pTimer->CCMR2;
+		if (Copy_u8Update || !GET_BIT(LOC_u32Ccmr, (SIM_TIM_CCMR_OCPE + ((LOC_u8Channel & 1) * 8))))
+		{
+			pState->Compare[LOC_u8Channel] = (&pTimer->CCR1)[LOC_u8Channel] & 0xFFFF;
+		}
+	}
+}
+
+/* Update event DMA request (UDE), after the preloaded registers are loaded */
+static void SIM_voidTimerUpdateDma(u8 Copy_u8Timer)
+{
+	if (GET_BIT(SIM_apTimers[Copy_u8Timer]->DIER, SIM_TIM_DIER_UDE))
+	{
+		SIM_u8DmaRequest(SIM_au8TimerUpDma[Copy_u8Timer]);
+	}
+}
+
+/* SR is rc_w0: the software can only clear the flags of the model */
+static void SIM_voidTimerSync(u8 Copy_u8Timer)
+{
+	volatile TIMER_RegDef_t *pTimer = SIM_apTimers[Copy_u8Timer];
+	SIM_Timer_t *pState = &SIM_Timers[Copy_u8Timer];
+	u8 LOC_u8Update = 0;
+
+	pState->SR &= pTimer->SR;
+
+	/* UG: counter and prescaler reinitialized, preloaded registers loaded unless UDIS is set */
+	if (GET_BIT(pTimer->EGR, SIM_TIM_EGR_UG))
+	{
+		pTimer->CNT = GET_BIT(pTimer->CR1, SIM_TIM_CR1_DIR) ? (pTimer->ARR & 0xFFFF) : 0;
+		pState->Prescaler = pTimer->PSC & 0xFFFF;
+		pState->Divider = 0;
+		LOC_u8Update = !GET_BIT(pTimer->CR1, SIM_TIM_CR1_UDIS);
+		if (!GET_BIT(pTimer->CR1, SIM_TIM_CR1_URS) && LOC_u8Update)
+		{
+			SET_BIT(pState->SR, SIM_TIM_SR_UIF);
+		}
+	}
+	/* TIM1 break: BG or an asserted BKIN with BKE clears MOE, held while BKIN stays asserted */
+	if ((pTimer == TIMER1) &&
+		(GET_BIT(pTimer->EGR, SIM_TIM_EGR_BG) || (SIM_u8BreakInput && GET_BIT(pTimer->BDTR, SIM_TIM_BDTR_BKE))))
+	{
+		CLR_BIT(pTimer->BDTR, SIM_TIM_BDTR_MOE);
+		SET_BIT(pState->SR, SIM_TIM_SR_BIF);
+	}
+	pTimer->EGR = 0;
+	SIM_voidTimerLoadCompare(Copy_u8Timer, LOC_u8Update);
+	if (LOC_u8Update)
+	{
+		SIM_voidTimerUpdateDma(Copy_u8Timer);
+	}
+	pTimer->SR = pState->SR;
+}
+
+static void SIM_voidTimerStep(u8 Copy_u8Timer, u32 Copy_u32Cycles)
+{
+	volatile TIMER_RegDef_t *pTimer = SIM_apTimers[Copy_u8Timer];
+	SIM_Timer_t *pState = &SIM_Timers[Copy_u8Timer];
+	u32 LOC_u32Ticks;
+	u32 LOC_u32Period;
+	u32 LOC_u32Counter;
+	u8 LOC_u8Update = 0;
+
+	SIM_voidTimerSync(Copy_u8Timer);
+	LOC_u32Period = (pTimer->ARR & 0xFFFF) + 1;
+	LOC_u32Counter = pTimer->CNT & 0xFFFF;
+	if (!GET_BIT(pTimer->CR1, SIM_TIM_CR1_CEN) || (LOC_u32Period == 1))
+	{
+		return;
+	}
+
+	pState->Divider += Copy_u32Cycles;
+	LOC_u32Ticks = pState->Divider / (pState->Prescaler + 1);
+	pState->Divider %= (pState->Prescaler + 1);
+	if (LOC_u32Ticks == 0)
+	{
+		return;
+	}
+
+	/* center-aligned modes are counted as up-counting */
+	if (!GET_BIT(pTimer->CR1, SIM_TIM_CR1_DIR))
+	{
+		LOC_u32Counter += LOC_u32Ticks;
+		if (LOC_u32Counter >= LOC_u32Period)
+		{
+			LOC_u32Counter %= LOC_u32Period;
+			LOC_u8Update = 1;
+		}
+	}
+	else if (LOC_u32Ticks > LOC_u32Counter)
+	{
+		LOC_u32Ticks -= LOC_u32Counter + 1;
+		LOC_u32Counter = (LOC_u32Period - 1) - (LOC_u32Ticks % LOC_u32Period);
+		LOC_u8Update = 1;
+	}
+	else
+	{
+		LOC_u32Counter -= LOC_u32Ticks;
+	}
+
+	if (LOC_u8Update)
+	{
+		if (!GET_BIT(pTimer->CR1, SIM_TIM_CR1_UDIS))
+		{
+			SET_BIT(pState->SR, SIM_TIM_SR_UIF);
+			pState->Prescaler = pTimer->PSC & 0xFFFF;
+			SIM_voidTimerLoadCompare(Copy_u8Timer, 1);
+			SIM_voidTimerUpdateDma(Copy_u8Timer);
+		}
+		if (GET_BIT(pTimer->CR1, SIM_TIM_CR1_OPM))
+		{
+			CLR_BIT(pTimer->CR1, SIM_TIM_CR1_CEN);
+			LOC_u32Counter = 0;
+		}
+	}
+	pTimer->CNT = LOC_u32Counter;
+	pTimer->SR = pState->SR;
+}
+
+u32 SIM_u32TimerDutyQ16(u8 Copy_u8Timer, u8 Copy_u8Channel)
+{
+	volatile TIMER_RegDef_t *pTimer = SIM_apTimers[Copy_u8Timer];
+	u32 LOC_u32Period;
+	u32 LOC_u32Compare;
+	u32 LOC_u32Outputs;
+
+	SIM_voidTimerSync(Copy_u8Timer);
+	LOC_u32Period = (pTimer->ARR & 0xFFFF) + 1;
+	LOC_u32Compare = SIM_Timers[Copy_u8Timer].Compare[Copy_u8Channel];
+	LOC_u32Outputs = (pTimer->CCER >> (4 * Copy_u8Channel)) & ((1UL << SIM_TIM_CCER_CC1E) | (1UL << SIM_TIM_CCER_CC1NE));
+	if (pTimer != TIMER1)
+	{
+		LOC_u32Outputs &= (1UL << SIM_TIM_CCER_CC1E);
+	}
+	else if (!GET_BIT(pTimer->BDTR, SIM_TIM_BDTR_MOE))
+	{
+		LOC_u32Outputs = 0;
+	}
+
+	if (!GET_BIT(pTimer->CR1, SIM_TIM_CR1_CEN) || (LOC_u32Outputs == 0))
+	{
+		return 0;
+	}
+	return (LOC_u32Compare >= LOC_u32Period) ? 65536UL : (u32)(((unsigned long long)LOC_u32Compare << 16) / LOC_u32Period);
+}
+
+void SIM_voidSetBreakInput(u8 Copy_u8Asserted)
+{
+	SIM_u8BreakInput = Copy_u8Asserted;
+	SIM_voidTimerSync(SIM_TIMER1);
+}
+
+/* Rising edge on TI1: CH1 captures CNT when it is an enabled input mapped on TI1 */
+static void SIM_voidTimerCapture(u8 Copy_u8Timer)
+{
+	volatile TIMER_RegDef_t *pTimer = SIM_apTimers[Copy_u8Timer];
+	SIM_Timer_t *pState = &SIM_Timers[Copy_u8Timer];
+
+	SIM_voidTimerSync(Copy_u8Timer);
+	if (GET_BIT(pTimer->CCER, SIM_TIM_CCER_CC1E) && ((pTimer->CCMR1 & SIM_TIM_CCMR1_CC1S_MASK) == 1))
+	{
+		if (GET_BIT(pState->SR, SIM_TIM_SR_CC1IF))
+		{
+			SET_BIT(pState->SR, SIM_TIM_SR_CC1OF);
+		}
+		pTimer->CCR1 = pTimer->CNT;
+		SET_BIT(pState->SR, SIM_TIM_SR_CC1IF);
+		pTimer->SR = pState->SR;
+	}
+}
+
+static u8 SIM_u8TimerServe(void)
+{
+	u8 LOC_u8Timer;
+	u8 LOC_u8Served = 0;
+
+	for (LOC_u8Timer = 0; LOC_u8Timer < SIM_TIMERS; LOC_u8Timer++)
+	{
+		SIM_voidTimerSync(LOC_u8Timer);
+		if (SIM_Timers[LOC_u8Timer].SR & SIM_apTimers[LOC_u8Timer]->DIER & SIM_TIM_IT_MASK)
+		{
+			if (SIM_u8Raise(SIM_au8TimerIrq[LOC_u8Timer]))
+			{
+				/* the handler read CCRx, which clears CCxIF */
+				SIM_voidTimerSync(LOC_u8Timer);
+				SIM_Timers[LOC_u8Timer].SR &= ~0x1EUL;
+				SIM_apTimers[LOC_u8Timer]->SR = SIM_Timers[LOC_u8Timer].SR;
+				LOC_u8Served = 1;
+			}
+		}
+	}
+	return LOC_u8Served;
+}
+
+/************************************ USART1 ************************************/
+
+static void SIM_voidUsartStatus(void)
+{
+	MUSART1->SR = (MUSART1->SR & ~((1UL << SIM_USART_SR_TXE) | (1UL << SIM_USART_SR_TC))) |
+				  ((u32)(MUSART1->DR == SIM_DR_EMPTY) << SIM_USART_SR_TXE) |
+				  ((u32)SIM_Usart.TCLatch << SIM_USART_SR_TC);
+}
+
+static void SIM_voidUsartStep(u32 Copy_u32Cycles)
+{
+	volatile UART_Register *pUsart = MUSART1;
+	u8 LOC_u8Guard = SIM_I2C_MAX_EVENTS;
+	u8 LOC_u8Byte;
+
+	if (!GET_BIT(pUsart->CR1, SIM_USART_CR1_UE) || !GET_BIT(pUsart->CR1, SIM_USART_CR1_TE))
+	{
+		return;
+	}
+
+	/* TC cleared by software */
+	if (!GET_BIT(pUsart->SR, SIM_USART_SR_TC))
+	{
+		SIM_Usart.TCLatch = 0;
+	}
+
+	for (;;)
+	{
+		/* the DMA refills the data register, the data register feeds the shifter */
+		if ((pUsart->DR == SIM_DR_EMPTY) && GET_BIT(pUsart->CR3, SIM_USART_CR3_DMAT))
+		{
+			SIM_u8DmaRequest(SIM_DMA_USART1_TX);
+		}
+		if (!SIM_Usart.Busy && (pUsart->DR != SIM_DR_EMPTY))
+		{
+			LOC_u8Byte = (u8)pUsart->DR;
+			pUsart->DR = SIM_DR_EMPTY;
+			SIM_Usart.Busy = 1;
+			SIM_Usart.Cycles = SIM_USART_FRAME_BITS * (pUsart->BRR & 0xFFFF);
+			SIM_Usart.TCLatch = 0;
+			SIM_Usart.Bytes++;
+			if (SIM_Usart.pSink != NULL)
+			{
+				fputc(LOC_u8Byte, SIM_Usart.pSink);
+			}
+			continue;
+		}
+		SIM_voidUsartStatus();
+
+		if (LOC_u8Guard != 0)
+		{
+			LOC_u8Guard--;
+			if (SIM_u8DmaServe())
+			{
+				continue;
+			}
+			if (((GET_BIT(pUsart->CR1, SIM_USART_CR1_TXEIE) && GET_BIT(pUsart->SR, SIM_USART_SR_TXE)) ||
+				 (GET_BIT(pUsart->CR1, SIM_USART_CR1_TCIE) && GET_BIT(pUsart->SR, SIM_USART_SR_TC))) &&
+				SIM_u8Raise(SIM_IRQN_USART1))
+			{
+				continue;
+			}
+		}
+
+		if (!SIM_Usart.Busy || (Copy_u32Cycles < SIM_Usart.Cycles))
+		{
+			SIM_Usart.Cycles -= SIM_Usart.Busy ? Copy_u32Cycles : 0;
+			break;
+		}
+		Copy_u32Cycles -= SIM_Usart.Cycles;
+		SIM_Usart.Busy = 0;
+		SIM_Usart.TCLatch = (pUsart->DR == SIM_DR_EMPTY);
+		LOC_u8Guard = SIM_I2C_MAX_EVENTS;
+	}
+	SIM_voidUsartStatus();
+}
+
+/************************************ I2C ************************************/
+
+static u32 SIM_u32I2CByteCycles(void)
+{
+	return SIM_I2C_BYTE_BITS * (SIM_CPU_CLK_HZ / SIM_I2C_SCL_HZ);
+}
+
+/* SR1 / SR2 seen by the software */
+static void SIM_voidI2CStatus(u8 Copy_u8Bus)
+{
+	I2C_RegDef_t *pI2C = SIM_apI2C[Copy_u8Bus];
+	SIM_I2CBus_t *pBus = &SIM_I2C[Copy_u8Bus];
+	u32 LOC_u32SR1 = pBus->SR1;
+	u8 LOC_u8Empty = (pI2C->DR == SIM_DR_EMPTY);
+
+	if ((pBus->Phase == SIM_I2C_TX) && LOC_u8Empty)
+	{
+		SET_BIT(LOC_u32SR1, SIM_I2C_SR1_TXE);
+		if (pBus->Started && !pBus->OnWire)
+		{
+			SET_BIT(LOC_u32SR1, SIM_I2C_SR1_BTF);
+		}
+	}
+	if (pBus->Read && !LOC_u8Empty)
+	{
+		SET_BIT(LOC_u32SR1, SIM_I2C_SR1_RXNE);
+		if (pBus->ShiftFull)
+		{
+			SET_BIT(LOC_u32SR1, SIM_I2C_SR1_BTF);
+		}
+	}
+	pI2C->SR1 = LOC_u32SR1;
+
+	if (pBus->Phase == SIM_I2C_IDLE)
+	{
+		pI2C->SR2 = 0;
+	}
+	else
+	{
+		pI2C->SR2 = (1 << SIM_I2C_SR2_MSL) | (1 << SIM_I2C_SR2_BUSY) | ((u32)(!pBus->Read) << SIM_I2C_SR2_TRA);
+	}
+}
+
+/* Immediate reactions to the software and the DMA, returns 1 if something moved */
+static u8 SIM_u8I2CUpdate(u8 Copy_u8Bus)
+{
+	I2C_RegDef_t *pI2C = SIM_apI2C[Copy_u8Bus];
+	SIM_I2CBus_t *pBus = &SIM_I2C[Copy_u8Bus];
+	u8 LOC_u8Moved = 0;
+
+	/* the software can only clear the error flags */
+	pBus->SR1 &= (pI2C->SR1 | ~SIM_I2C_SR1_ERR_MASK);
+
+	/* START: at once when the bus is free or between two bytes (repeated start) */
+	if (GET_BIT(pI2C->CR1, SIM_I2C_CR1_START) && !pBus->OnWire && !GET_BIT(pBus->SR1, SIM_I2C_SR1_SB) &&
+		(pBus->Phase != SIM_I2C_ADDRESSED))
+	{
+		CLR_BIT(pI2C->CR1, SIM_I2C_CR1_START);
+		SET_BIT(pBus->SR1, SIM_I2C_SR1_SB);
+		pBus->Phase = SIM_I2C_ADDRESS;
+		pBus->Read = 0;
+		pBus->Started = 0;
+		pBus->RxCount = 0;
+		pBus->Nacked = 0;
+		pBus->ShiftFull = 0;
+		LOC_u8Moved = 1;
+	}
+
+	/* SB is cleared by the address written in DR */
+	if (GET_BIT(pBus->SR1, SIM_I2C_SR1_SB) && (pI2C->DR != SIM_DR_EMPTY))
+	{
+		pBus->Shift = (u8)pI2C->DR;
+		pI2C->DR = SIM_DR_EMPTY;
+		CLR_BIT(pBus->SR1, SIM_I2C_SR1_SB);
+		pBus->Read = pBus->Shift & 1;
+		pBus->OnWire = 1;
+		pBus->Cycles = SIM_u32I2CByteCycles();
+		LOC_u8Moved = 1;
+	}
+
+	/* STOP: after the byte on the wire */
+	if (GET_BIT(pI2C->CR1, SIM_I2C_CR1_STOP) && !pBus->OnWire && (pBus->Phase != SIM_I2C_IDLE))
+	{
+		if ((pBus->pSlave != NULL) && (pBus->pSlave->pfStop != NULL))
+		{
+			pBus->pSlave->pfStop();
+		}
+		CLR_BIT(pI2C->CR1, SIM_I2C_CR1_STOP);
+		/* an address phase ended by the stop (abort) leaves no event behind */
+		CLR_BIT(pBus->SR1, SIM_I2C_SR1_ADDR);
+		pBus->Phase = SIM_I2C_IDLE;
+		pBus->pSlave = NULL;
+		LOC_u8Moved = 1;
+	}
+
+	if (pBus->Read)
+	{
+		/* DR freed: the byte waiting in the shift register moves in, then the DMA takes it */
+		if ((pI2C->DR == SIM_DR_EMPTY) && pBus->ShiftFull)
+		{
+			pI2C->DR = pBus->Shift;
+			pBus->ShiftFull = 0;
+			LOC_u8Moved = 1;
+		}
+		if ((pI2C->DR != SIM_DR_EMPTY) && GET_BIT(pI2C->CR2, SIM_I2C_CR2_DMAEN) &&
+			SIM_u8DmaRequest(SIM_au8I2CRxDma[Copy_u8Bus]))
+		{
+			pI2C->DR = SIM_DR_EMPTY;
+			LOC_u8Moved = 1;
+		}
+
+		/* next byte clocked in while the shift register is free, none after a NACK or with STOP pending */
+		if ((pBus->Phase == SIM_I2C_RX) && !pBus->OnWire && !pBus->ShiftFull && !pBus->Nacked &&
+			!GET_BIT(pI2C->CR1, SIM_I2C_CR1_STOP))
+		{
+			pBus->OnWire = 1;
+			pBus->Cycles = SIM_u32I2CByteCycles();
+			LOC_u8Moved = 1;
+		}
+	}
+	else if ((pBus->Phase == SIM_I2C_TX) && !pBus->OnWire && !GET_BIT(pI2C->CR1, SIM_I2C_CR1_STOP))
+	{
+		if ((pI2C->DR == SIM_DR_EMPTY) && GET_BIT(pI2C->CR2, SIM_I2C_CR2_DMAEN))
+		{
+			SIM_u8DmaRequest(SIM_au8I2CTxDma[Copy_u8Bus]);
+		}
+		if (pI2C->DR != SIM_DR_EMPTY)
+		{
+			pBus->Shift = (u8)pI2C->DR;
+			pI2C->DR = SIM_DR_EMPTY;
+			pBus->OnWire = 1;
+			pBus->Cycles = SIM_u32I2CByteCycles();
+			if (GET_BIT(pI2C->CR2, SIM_I2C_CR2_DMAEN))
+			{
+				SIM_u8DmaRequest(SIM_au8I2CTxDma[Copy_u8Bus]);
+			}
+			LOC_u8Moved = 1;
+		}
+	}
+
+	SIM_voidI2CStatus(Copy_u8Bus);
+	return LOC_u8Moved;
+}
+
+/* Clocks the byte on the wire, returns the cycles used */
+static u32 SIM_u32I2CWire(u8 Copy_u8Bus, u32 Copy_u32Cycles)
+{
+	I2C_RegDef_t *pI2C = SIM_apI2C[Copy_u8Bus];
+	SIM_I2CBus_t *pBus = &SIM_I2C[Copy_u8Bus];
+	u32 LOC_u32Used = pBus->Cycles;
+	u8 LOC_u8Byte;
+	u8 i;
+
+	if (Copy_u32Cycles < pBus->Cycles)
+	{
+		pBus->Cycles -= Copy_u32Cycles;
+		return Copy_u32Cycles;
+	}
+	pBus->OnWire = 0;
+	pBus->Cycles = 0;
+
+	if (pBus->Phase == SIM_I2C_ADDRESS)
+	{
+		pBus->pSlave = NULL;
+		for (i = 0; i < pBus->SlaveCount; i++)
+		{
+			if (pBus->apSlaves[i]->Address == (pBus->Shift >> 1))
+			{
+				pBus->pSlave = pBus->apSlaves[i];
+			}
+		}
+		if (pBus->pSlave == NULL)
+		{
+			SET_BIT(pBus->SR1, SIM_I2C_SR1_AF);
+			pBus->Phase = SIM_I2C_NACKED;
+		}
+		else
+		{
+			if (pBus->pSlave->pfStart != NULL)
+			{
+				pBus->pSlave->pfStart(pBus->Read);
+			}
+			SET_BIT(pBus->SR1, SIM_I2C_SR1_ADDR);
+			pBus->Phase = SIM_I2C_ADDRESSED;
+		}
+	}
+	else if (pBus->Phase == SIM_I2C_TX)
+	{
+		pBus->Started = 1;
+		if ((pBus->pSlave->pfWrite == NULL) || !pBus->pSlave->pfWrite(pBus->Shift))
+		{
+			SET_BIT(pBus->SR1, SIM_I2C_SR1_AF);
+			pBus->Phase = SIM_I2C_NACKED;
+		}
+	}
+	else if (pBus->Phase == SIM_I2C_RX)
+	{
+		LOC_u8Byte = (pBus->pSlave->pfRead != NULL) ? pBus->pSlave->pfRead() : 0xFF;
+
+		/* NACK: ACK cleared (for the next byte with POS), or the last DMA byte with LAST */
+		pBus->Nacked = (!GET_BIT(pI2C->CR1, SIM_I2C_CR1_ACK) && (!GET_BIT(pI2C->CR1, SIM_I2C_CR1_POS) || (pBus->RxCount >= 1))) ||
+					   (GET_BIT(pI2C->CR2, SIM_I2C_CR2_LAST) && GET_BIT(pI2C->CR2, SIM_I2C_CR2_DMAEN) &&
+						(SIM_u32DmaRemaining(SIM_au8I2CRxDma[Copy_u8Bus]) == 1));
+		pBus->RxCount++;
+		pBus->Started = 1;
+		if (pI2C->DR == SIM_DR_EMPTY)
+		{
+			pI2C->DR = LOC_u8Byte;
+		}
+		else
+		{
+			pBus->Shift = LOC_u8Byte;
+			pBus->ShiftFull = 1;
+		}
+	}
+
+	SIM_voidI2CStatus(Copy_u8Bus);
+	return LOC_u32Used;
+}
+
+/* Event / error interrupts. Reads of SR1 / SR2 / DR cannot be seen, so the model applies after the
+ * handler what its reads did in the RM0008 sequences: ADDR cleared, one byte read on RXNE, two on
+ * BTF once STOP is programmed (N = 2 and the end of N > 2), one on BTF otherwise */
+static u8 SIM_u8I2CServe(u8 Copy_u8Bus)
+{
+	I2C_RegDef_t *pI2C = SIM_apI2C[Copy_u8Bus];
+	SIM_I2CBus_t *pBus = &SIM_I2C[Copy_u8Bus];
+	u32 LOC_u32SR1 = pI2C->SR1;
+	u32 LOC_u32CR2 = pI2C->CR2;
+	u8 LOC_u8Reads;
+
+	if (GET_BIT(LOC_u32CR2, SIM_I2C_CR2_ITERREN) && (LOC_u32SR1 & SIM_I2C_SR1_ERR_MASK))
+	{
+		if (SIM_u8Raise(SIM_au8I2CErIrq[Copy_u8Bus]))
+		{
+			pBus->SR1 &= (pI2C->SR1 | ~SIM_I2C_SR1_ERR_MASK);
+			SIM_voidI2CStatus(Copy_u8Bus);
+			return 1;
+		}
+	}
+
+	if (!GET_BIT(LOC_u32CR2, SIM_I2C_CR2_ITEVTEN))
+	{
+		return 0;
+	}
+	if (!(LOC_u32SR1 & ((1 << SIM_I2C_SR1_SB) | (1 << SIM_I2C_SR1_ADDR) | (1 << SIM_I2C_SR1_BTF))) &&
+		!(GET_BIT(LOC_u32CR2, SIM_I2C_CR2_ITBUFEN) && (LOC_u32SR1 & ((1 << SIM_I2C_SR1_TXE) | (1 << SIM_I2C_SR1_RXNE)))))
+	{
+		return 0;
+	}
+	if (!SIM_u8Raise(SIM_au8I2CEvIrq[Copy_u8Bus]))
+	{
+		return 0;
+	}
+
+	if (GET_BIT(LOC_u32SR1, SIM_I2C_SR1_ADDR))
+	{
+		CLR_BIT(pBus->SR1, SIM_I2C_SR1_ADDR);
+		pBus->Phase = pBus->Read ? SIM_I2C_RX : SIM_I2C_TX;
+		if (pBus->Read)
+		{
+			/* the first byte is clocked in as soon as ADDR is cleared, even with STOP programmed (N = 1) */
+			pBus->OnWire = 1;
+			pBus->Cycles = SIM_u32I2CByteCycles();
+		}
+	}
+	else if (pBus->Read && (LOC_u32SR1 & ((1 << SIM_I2C_SR1_RXNE) | (1 << SIM_I2C_SR1_BTF))))
+	{
+		LOC_u8Reads = (GET_BIT(LOC_u32SR1, SIM_I2C_SR1_BTF) && GET_BIT(pI2C->CR1, SIM_I2C_CR1_STOP)) ? 2 : 1;
+		while ((LOC_u8Reads != 0) && (pI2C->DR != SIM_DR_EMPTY))
+		{
+			pI2C->DR = SIM_DR_EMPTY;
+			if (pBus->ShiftFull)
+			{
+				pI2C->DR = pBus->Shift;
+				pBus->ShiftFull = 0;
+			}
+			LOC_u8Reads--;
+		}
+	}
+	SIM_voidI2CStatus(Copy_u8Bus);
+	return 1;
+}
+
+static void SIM_voidI2CStep(u8 Copy_u8Bus, u32 Copy_u32Cycles)
+{
+	I2C_RegDef_t *pI2C = SIM_apI2C[Copy_u8Bus];
+	SIM_I2CBus_t *pBus = &SIM_I2C[Copy_u8Bus];
+	u8 LOC_u8Guard;
+	u8 LOC_u8Moved;
+
+	if (!GET_BIT(pI2C->CR1, SIM_I2C_CR1_PE))
+	{
+		pBus->Phase = SIM_I2C_IDLE;
+		pBus->OnWire = 0;
+		pBus->Read = 0;
+		pI2C->SR1 = 0;
+		pI2C->SR2 = 0;
+		return;
+	}
+
+	for (;;)
+	{
+		for (LOC_u8Guard = 0; LOC_u8Guard < SIM_I2C_MAX_EVENTS; LOC_u8Guard++)
+		{
+			LOC_u8Moved = SIM_u8I2CUpdate(Copy_u8Bus);
+			LOC_u8Moved |= SIM_u8I2CServe(Copy_u8Bus);
+			LOC_u8Moved |= SIM_u8DmaServe();
+			if (!LOC_u8Moved)
+			{
+				break;
+			}
+		}
+		if (!pBus->OnWire)
+		{
+			break;
+		}
+		Copy_u32Cycles -= SIM_u32I2CWire(Copy_u8Bus, Copy_u32Cycles);
+		if (pBus->OnWire)
+		{
+			break;
+		}
+	}
+}
+
+u8 SIM_u8AttachI2CSlave(u8 Copy_u8Bus, const SIM_I2CSlave_t *Copy_pSlave)
+{
+	SIM_I2CBus_t *pBus;
+
+	if ((Copy_u8Bus >= SIM_I2C_BUSES) || (Copy_pSlave == NULL) || (SIM_I2C[Copy_u8Bus].SlaveCount >= SIM_I2C_MAX_SLAVES))
+	{
+		return 0;
+	}
+	pBus = &SIM_I2C[Copy_u8Bus];
+	pBus->apSlaves[pBus->SlaveCount++] = Copy_pSlave;
+	return 1;
+}
+
+/************************************ Time ************************************/
+
+/* Software pending bits (ISPR) of enabled interrupts */
+static void SIM_voidNvicServe(void)
+{
+	u8 LOC_u8Irq;
+
+	SIM_voidNvicSync();
+	for (LOC_u8Irq = 0; LOC_u8Irq < SIM_IRQN_COUNT; LOC_u8Irq++)
+	{
+		if (GET_BIT(NVIC->ISPR[LOC_u8Irq / 32], LOC_u8Irq % 32) && GET_BIT(NVIC->ISER[LOC_u8Irq / 32], LOC_u8Irq % 32))
+		{
+			CLR_BIT(NVIC->ISPR[LOC_u8Irq / 32], LOC_u8Irq % 32);
+			SIM_u8Raise(LOC_u8Irq);
+		}
+	}
+}
+
+static void SIM_voidSlice(u32 Copy_u32Us)
+{
+	u32 LOC_u32Cycles = Copy_u32Us * SIM_CYCLES_PER_US;
+	u8 i;
+
+	SIM_voidDmaSync();
+	SIM_voidWorldStep(Copy_u32Us);
+	for (i = 0; i < SIM_TIMERS; i++)
+	{
+		SIM_voidTimerStep(i, LOC_u32Cycles);
+	}
+	SIM_voidUsartStep(LOC_u32Cycles);
+	for (i = 0; i < SIM_I2C_BUSES; i++)
+	{
+		SIM_voidI2CStep(i, LOC_u32Cycles);
+	}
+	SIM_voidStkStep(LOC_u32Cycles);
+	SIM_u8TimerServe();
+	SIM_u8DmaServe();
+	SIM_voidNvicServe();
+	SIM_u64TimeUs += Copy_u32Us;
+
+	/* settled firmware cycles leave the pending count as the virtual time takes them over */
+	if (SIM_u64SettleCycles != 0)
+	{
+		if (SIM_u64SettleCycles < LOC_u32Cycles)
+		{
+			LOC_u32Cycles = (u32)SIM_u64SettleCycles;
+		}
+		SIM_u64SettleCycles -= LOC_u32Cycles;
+		SIM_u64FirmwareCycles -= LOC_u32Cycles;
+	}
+}
+
+static void SIM_voidFinish(void)
+{
+	double LOC_f64HostS = (double)(clock() - SIM_HostStart) / CLOCKS_PER_SEC;
+	double LOC_f64SimS = (double)SIM_u64TimeUs / 1e6;
+
+	if (SIM_Usart.pSink != NULL)
+	{
+		fclose(SIM_Usart.pSink);
+	}
+	fprintf(stderr, "sim time      : %.3f s\n", LOC_f64SimS);
+	fprintf(stderr, "host time     : %.3f s (x%.1f)\n", LOC_f64HostS, (LOC_f64HostS > 0) ? (LOC_f64SimS / LOC_f64HostS) : 0.0);
+	fprintf(stderr, "usart1 bytes  : %u\n", SIM_Usart.Bytes);
+	exit(SIM_u8WorldReport());
+}
+
+void SIM_voidAdvance(u32 Copy_u32Us)
+{
+	u32 LOC_u32Slice;
+	u32 LOC_u32HallPeriod;
+#if SIM_CYCCNT_HOST_TIME
+	unsigned long long LOC_u64EntryNs = SIM_u64HostNs();
+#endif
+
+	while (Copy_u32Us != 0)
+	{
+		LOC_u32Slice = (Copy_u32Us < SIM_MAX_SLICE_US) ? Copy_u32Us : SIM_MAX_SLICE_US;
+
+		/* slices end on the hall edges so TIM2 captures the exact count */
+		LOC_u32HallPeriod = SIM_u32WorldHallPeriodUs();
+		if (LOC_u32HallPeriod == 0)
+		{
+			SIM_u32HallPhaseUs = 0;
+		}
+		else if (SIM_u32HallPhaseUs >= LOC_u32HallPeriod)
+		{
+			SIM_u32HallPhaseUs = LOC_u32HallPeriod - 1;
+		}
+		if ((LOC_u32HallPeriod != 0) && (LOC_u32Slice >= (LOC_u32HallPeriod - SIM_u32HallPhaseUs)))
+		{
+			LOC_u32Slice = LOC_u32HallPeriod - SIM_u32HallPhaseUs;
+		}
+
+		SIM_voidSlice(LOC_u32Slice);
+		Copy_u32Us -= LOC_u32Slice;
+
+		if (LOC_u32HallPeriod != 0)
+		{
+			SIM_u32HallPhaseUs += LOC_u32Slice;
+			if (SIM_u32HallPhaseUs >= LOC_u32HallPeriod)
+			{
+				SIM_u32HallPhaseUs = 0;
+				SIM_voidTimerCapture(0);
+				SIM_u8TimerServe();
+			}
+		}
+
+		if (SIM_u64TimeUs >= (SIM_RUN_TIME_MS * 1000ULL))
+		{
+			SIM_voidFinish();
+		}
+	}
+#if SIM_CYCCNT_HOST_TIME
+	SIM_u64ModelNs += SIM_u64HostNs() - LOC_u64EntryNs;
+#endif
+}
+
+/* Whole microseconds only, the rest stays pending. The slices take the cycles off the pending count as
+ * they add them to the virtual time, so CYCCNT never goes back, even in the handlers run meanwhile */
+void SIM_voidSettle(void)
+{
+	u32 LOC_u32Us = (u32)(SIM_u64FirmwareCycles / SIM_CYCLES_PER_US);
+
+	if (LOC_u32Us != 0)
+	{
+		SIM_u64SettleCycles = (unsigned long long)LOC_u32Us * SIM_CYCLES_PER_US;
+		SIM_voidAdvance(LOC_u32Us);
+	}
+}
+
+void SIM_voidIdle(void)
+{
+	SIM_voidSettle();
+	SIM_voidAdvance(SIM_IDLE_STEP_US);
+}
+
+/* An interrupt raised while the pending firmware cycles settle ends the wait at once, as WFI would */
+void SIM_voidWaitForInterrupt(void)
+{
+	u32 LOC_u32Interrupts = SIM_u32Interrupts;
+
+	SIM_voidSettle();
+	while (SIM_u32Interrupts == LOC_u32Interrupts)
+	{
+		SIM_voidAdvance(SIM_IDLE_STEP_US);
+	}
+}
+
+unsigned long long SIM_u64GetTimeUs(void)
+{
+	return SIM_u64TimeUs;
+}
+
+/* Host byte and bit of a peripheral alias word, NULL outside the simulated peripheral window */
+static unsigned char * SIM_pu8BitBandTarget(u32 Copy_u32Alias, u8 * Copy_pu8Bit)
+{
+	u32 LOC_u32Offset;
+
+	if ((Copy_u32Alias < BITBAND_PERIPH_ALIAS) || (Copy_u32Alias >= (BITBAND_PERIPH_ALIAS + (BITBAND_REGION_SIZE << 5))))
+	{
+		return NULL;
+	}
+	/* one word per bit: byte offset in bits 24:5, bit of the byte in bits 4:2 */
+	LOC_u32Offset = (Copy_u32Alias - BITBAND_PERIPH_ALIAS) >> 5;
+	if (LOC_u32Offset >= SIM_PERIPH_SIZE)
+	{
+		return NULL;
+	}
+	*Copy_pu8Bit = (u8)((Copy_u32Alias >> 2) & 7);
+	return &SIM_u8PeriphMemory[LOC_u32Offset];
+}
+
+void SIM_voidBitBandAliasWrite(u32 Copy_u32Alias, u32 Copy_u32Value)
+{
+	u8 LOC_u8Bit;
+	unsigned char * LOC_pu8Byte = SIM_pu8BitBandTarget(Copy_u32Alias, &LOC_u8Bit);
+
+	if (LOC_pu8Byte == NULL)
+	{
+		fprintf(stderr, "sim: bit-band alias 0x%08X outside the peripheral window\n", Copy_u32Alias);
+		exit(1);
+	}
+	/* only bit 0 of the stored value is used */
+	if (Copy_u32Value & 1)
+	{
+		SET_BIT(*LOC_pu8Byte, LOC_u8Bit);
+	}
+	else
+	{
+		CLR_BIT(*LOC_pu8Byte, LOC_u8Bit);
+	}
+}
+
+u32 SIM_u32BitBandAliasRead(u32 Copy_u32Alias)
+{
+	u8 LOC_u8Bit;
+	unsigned char * LOC_pu8Byte = SIM_pu8BitBandTarget(Copy_u32Alias, &LOC_u8Bit);
+
+	if (LOC_pu8Byte == NULL)
+	{
+		fprintf(stderr, "sim: bit-band alias 0x%08X outside the peripheral window\n", Copy_u32Alias);
+		exit(1);
+	}
+	return GET_BIT(*LOC_pu8Byte, LOC_u8Bit);
+}
+
+/* Target address of a simulated register, 0 for host memory (the SRAM variables of the firmware) */
+static u32 SIM_u32TargetAddress(volatile void * Copy_pRegister)
+{
+	volatile unsigned char * LOC_pu8Register = (volatile unsigned char *)Copy_pRegister;
+
+	if ((LOC_pu8Register >= SIM_u8PeriphMemory) && (LOC_pu8Register < &SIM_u8PeriphMemory[SIM_PERIPH_SIZE]))
+	{
+		return SIM_PERIPH_START + (u32)(LOC_pu8Register - SIM_u8PeriphMemory);
+	}
+	return 0;
+}
+
+void SIM_voidBitBandWrite(volatile void * Copy_pRegister, u32 Copy_u32Bit, u32 Copy_u32Value)
+{
+	u32 LOC_u32Address = SIM_u32TargetAddress(Copy_pRegister);
+
+	if (LOC_u32Address != 0)
+	{
+		SIM_voidBitBandAliasWrite(BITBAND_ALIAS_ADDRESS(LOC_u32Address, Copy_u32Bit), Copy_u32Value);
+	}
+	else if (Copy_u32Value & 1)
+	{
+		SET_BIT(*(volatile u32 *)Copy_pRegister, Copy_u32Bit);
+	}
+	else
+	{
+		CLR_BIT(*(volatile u32 *)Copy_pRegister, Copy_u32Bit);
+	}
+}
+
+u32 SIM_u32BitBandRead(volatile void * Copy_pRegister, u32 Copy_u32Bit)
+{
+	u32 LOC_u32Address = SIM_u32TargetAddress(Copy_pRegister);
+
+	if (LOC_u32Address != 0)
+	{
+		return SIM_u32BitBandAliasRead(BITBAND_ALIAS_ADDRESS(LOC_u32Address, Copy_u32Bit));
+	}
+	return GET_BIT(*(volatile u32 *)Copy_pRegister, Copy_u32Bit);
+}
+
+/* Instrumented builds (-finstrument-functions): every firmware call costs SIM_CYCLES_PER_CALL cycles */
+void __cyg_profile_func_enter(void * Copy_pFunction, void * Copy_pCallSite) __attribute__((no_instrument_function));
+void __cyg_profile_func_exit(void * Copy_pFunction, void * Copy_pCallSite) __attribute__((no_instrument_function));
+
+void __cyg_profile_func_enter(void * Copy_pFunction, void * Copy_pCallSite)
+{
+	(void)Copy_pFunction;
+	(void)Copy_pCallSite;
+	SIM_u64FirmwareCycles += SIM_CYCLES_PER_CALL;
+}
+
+void __cyg_profile_func_exit(void * Copy_pFunction, void * Copy_pCallSite)
+{
+	(void)Copy_pFunction;
+	(void)Copy_pCallSite;
+}
+
+u32 SIM_u32GetCycleCount(void)
+{
+	unsigned long long LOC_u64Cycles = (SIM_u64TimeUs * SIM_CYCLES_PER_US) + SIM_u64FirmwareCycles;
+
+#if SIM_CYCCNT_HOST_TIME
+	LOC_u64Cycles += ((SIM_u64HostNs() - SIM_u64HostStartNs - SIM_u64ModelNs) * SIM_HOST_CYCLES_PER_US) / 1000ULL;
+#endif
+
+	/* CYCCNT only counts while trace and the counter are enabled, firmware writes to it are kept */
+	if (GET_BIT(COREDEBUG->DEMCR, SIM_DEMCR_TRCENA) && GET_BIT(DWT->CTRL, SIM_DWT_CYCCNTENA))
+	{
+		DWT->CYCCNT += (u32)(LOC_u64Cycles - SIM_u64CycleMark);
+	}
+	SIM_u64CycleMark = LOC_u64Cycles;
+
+	return DWT->CYCCNT;
+}
+
+#endif
@@ -6,6 +6,7 @@
 
 #include "STD_TYPES.h"
 #include "BIT_MATH.h"
+#include "stm32f103C8.h"
 
 #include "STK_interface.h"
 #include "STK_private.h"
@@ -134,6 +135,19 @@ void MSTK_voidStopInterval(void)
 	MSTK_voidCounterEnDis(MSTK_COUNTER_DIS);
 }
 
+/* New reload value taken at once: VAL is cleared, the next count loads Copy_u32LoadVal */
+void MSTK_voidRestart(u32 Copy_u32LoadVal)
+{
+	MSTK -> LOAD = Copy_u32LoadVal ;
+	MSTK -> VAL = 0x00;
+}
+
+/* 1 while a SysTick exception waits, for example the count reached 0 with the interrupts masked */
+u8 MSTK_u8GetPendingFlag(void)
+{
+	return GET_BIT(SCB->ICSR, MSTK_PENDSTSET_BIT);
+}
+
 void SysTick_Handler(void)
 {
 	CallBack();
@@ -0,0 +1,288 @@
+/*******************************************************/
+/* Layer     : Service                                 */
+/* SWC       : SWT (software timers)                   */
+/* Version   : V01                                     */
+/*******************************************************/
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+
+#include "GPT.h"
+#include "SCH_interface.h"
+#include "SCH_config.h"
+
+#include "SWT_interface.h"
+#include "SWT_config.h"
+#include "SWT_private.h"
+
+#if (SWT_TICK_SOURCE == SWT_SOURCE_SCH) && (SWT_TICK_US != (SCH_TICK_MS * 1000))
+	#error "SWT_TICK_US must be the scheduler tick with SWT_SOURCE_SCH"
+#endif
+
+#if (SWT_TICK_SOURCE == SWT_SOURCE_GPT) && (GPT_RESERVED_CHANNELS & (1UL << SWT_GPT_CHANNEL))
+	#error "SWT_GPT_CHANNEL is reserved for another driver (GPT_RESERVED_CHANNELS)"
+#endif
+
+/* Hierarchical timing wheel: level 0 holds the timers of the next SWT_SLOTS ticks, one slot per tick,
+   a slot of level l spans SWT_SLOTS^l ticks and is moved one level down when its span begins */
+static SWT_Timer_t * SWT_apWheel[SWT_LEVELS][SWT_SLOTS];
+
+/* Next tick to process, the timers of all earlier ticks have expired */
+static u32 SWT_u32Next = 0;
+
+/* Wheel ticks counted by SWT_voidTick (SWT_SOURCE_GPT) */
+static volatile u32 SWT_u32Ticks = 0;
+
+/* Timers of the tick being processed, each one is unlinked right before its callback */
+static SWT_Timer_t * SWT_pExpired = NULL;
+
+static void SWT_voidLink(SWT_Timer_t ** Copy_ppHead, SWT_Timer_t * Copy_pTimer)
+{
+	Copy_pTimer->pNext = *Copy_ppHead;
+	if (Copy_pTimer->pNext != NULL)
+	{
+		Copy_pTimer->pNext->ppPrev = &Copy_pTimer->pNext;
+	}
+	Copy_pTimer->ppPrev = Copy_ppHead;
+	*Copy_ppHead = Copy_pTimer;
+}
+
+static void SWT_voidUnlink(SWT_Timer_t * Copy_pTimer)
+{
+	*Copy_pTimer->ppPrev = Copy_pTimer->pNext;
+	if (Copy_pTimer->pNext != NULL)
+	{
+		Copy_pTimer->pNext->ppPrev = Copy_pTimer->ppPrev;
+	}
+	Copy_pTimer->pNext = NULL;
+	Copy_pTimer->ppPrev = NULL;
+}
+
+/* Level l takes the expiries less than SWT_SLOTS^(l + 1) ticks after SWT_u32Next, in the slot of their level l digit */
+static void SWT_voidInsert(SWT_Timer_t * Copy_pTimer)
+{
+	u32 Local_u32Expiry = Copy_pTimer->Expiry;
+	u32 Local_u32Delta = Local_u32Expiry - SWT_u32Next;
+	u8 Local_u8Level = 0;
+
+	if ((s32)Local_u32Delta < 0)
+	{
+		/* Already due: expires with the next processed tick */
+		Local_u32Expiry = SWT_u32Next;
+		Local_u32Delta = 0;
+	}
+	else if (Local_u32Delta >= SWT_RANGE)
+	{
+		/* Beyond the wheel: parked in the top level and placed again when its slot cascades */
+		Local_u32Expiry = SWT_u32Next + SWT_RANGE - 1;
+		Local_u32Delta = SWT_RANGE - 1;
+	}
+
+	while (Local_u32Delta >= (1UL << (SWT_LEVEL_BITS * (Local_u8Level + 1))))
+	{
+		Local_u8Level++;
+	}
+	SWT_voidLink(&SWT_apWheel[Local_u8Level][(Local_u32Expiry >> (SWT_LEVEL_BITS * Local_u8Level)) & SWT_SLOT_MASK], Copy_pTimer);
+}
+
+/* Expires the timers of tick SWT_u32Next, the cost does not depend on the number of armed timers */
+static void SWT_voidProcessTick(void)
+{
+	u32 Local_u32Tick = SWT_u32Next;
+	u32 Local_u32Slot;
+	u8 Local_u8Level;
+	SWT_Timer_t * Local_pList;
+	SWT_Timer_t * Local_pTimer;
+
+	/* A tick starting the span of a slot of level l redistributes that slot, each timer cascades at most SWT_LEVELS - 1 times */
+	for (Local_u8Level = 1; Local_u8Level < SWT_LEVELS; Local_u8Level++)
+	{
+		if ((Local_u32Tick & ((1UL << (SWT_LEVEL_BITS * Local_u8Level)) - 1)) != 0)
+		{
+			break;
+		}
+		Local_u32Slot = (Local_u32Tick >> (SWT_LEVEL_BITS * Local_u8Level)) & SWT_SLOT_MASK;
+		Local_pList = SWT_apWheel[Local_u8Level][Local_u32Slot];
+		SWT_apWheel[Local_u8Level][Local_u32Slot] = NULL;
+		while (Local_pList != NULL)
+		{
+			Local_pTimer = Local_pList;
+			Local_pList = Local_pTimer->pNext;
+			SWT_voidInsert(Local_pTimer);
+		}
+	}
+
+	Local_u32Slot = Local_u32Tick & SWT_SLOT_MASK;
+	SWT_pExpired = SWT_apWheel[0][Local_u32Slot];
+	SWT_apWheel[0][Local_u32Slot] = NULL;
+	if (SWT_pExpired != NULL)
+	{
+		SWT_pExpired->ppPrev = &SWT_pExpired;
+	}
+	SWT_u32Next++;
+
+	/* A callback may stop the timers still waiting in the list, they unlink from it like from a slot */
+	while (SWT_pExpired != NULL)
+	{
+		Local_pTimer = SWT_pExpired;
+		SWT_voidUnlink(Local_pTimer);
+		if (Local_pTimer->Period != 0)
+		{
+			/* Drift free reload, whole periods lost to a late dispatch are skipped instead of run back to back */
+			Local_pTimer->Expiry += Local_pTimer->Period;
+			if ((s32)(SWT_u32Next - Local_pTimer->Expiry) > 0)
+			{
+				Local_pTimer->Expiry += ((SWT_u32Next - Local_pTimer->Expiry + Local_pTimer->Period - 1) / Local_pTimer->Period) * Local_pTimer->Period;
+			}
+			SWT_voidInsert(Local_pTimer);
+		}
+		if (Local_pTimer->pfCallBack != NULL)
+		{
+			Local_pTimer->pfCallBack(Local_pTimer);
+		}
+	}
+}
+
+void SWT_voidInit(void)
+{
+	u8 Local_u8Level;
+	u32 Local_u32Slot;
+
+	for (Local_u8Level = 0; Local_u8Level < SWT_LEVELS; Local_u8Level++)
+	{
+		for (Local_u32Slot = 0; Local_u32Slot < SWT_SLOTS; Local_u32Slot++)
+		{
+			SWT_apWheel[Local_u8Level][Local_u32Slot] = NULL;
+		}
+	}
+	SWT_pExpired = NULL;
+
+#if (SWT_TICK_SOURCE == SWT_SOURCE_GPT)
+	/* The channel is configured by Gpt_Init, SWT only starts it */
+	SWT_u32Ticks = 0;
+	Gpt_StartTimer(SWT_GPT_CHANNEL, Gpt_u32UsToTicks(SWT_GPT_CHANNEL, SWT_TICK_US));
+	Gpt_EnableNotification(SWT_GPT_CHANNEL);
+#endif
+	SWT_u32Next = SWT_u32GetTickCount();
+}
+
+void SWT_voidCreate(SWT_Timer_t * Copy_pTimer, void (*Copy_pfCallBack)(SWT_Timer_t *))
+{
+	Copy_pTimer->pNext = NULL;
+	Copy_pTimer->ppPrev = NULL;
+	Copy_pTimer->Expiry = 0;
+	Copy_pTimer->Period = 0;
+	Copy_pTimer->pfCallBack = Copy_pfCallBack;
+}
+
+/* Expires Copy_u32DelayTicks ticks from now (at least 1), then every Copy_u32PeriodTicks if not 0. A running timer is restarted */
+u8 SWT_u8Start(SWT_Timer_t * Copy_pTimer, u32 Copy_u32DelayTicks, u32 Copy_u32PeriodTicks)
+{
+	if ((Copy_pTimer == NULL) || (Copy_u32DelayTicks > SWT_MAX_DELAY) || (Copy_u32PeriodTicks > SWT_MAX_DELAY))
+	{
+		return STD_TYPES_NOK;
+	}
+
+	if (Copy_pTimer->ppPrev != NULL)
+	{
+		SWT_voidUnlink(Copy_pTimer);
+	}
+	Copy_pTimer->Expiry = SWT_u32GetTickCount() + ((Copy_u32DelayTicks == 0) ? 1 : Copy_u32DelayTicks);
+	Copy_pTimer->Period = Copy_u32PeriodTicks;
+	SWT_voidInsert(Copy_pTimer);
+#if (SWT_TICK_SOURCE == SWT_SOURCE_SCH)
+	/* The timers task may sleep past the new expiry */
+	SCH_voidAdvanceTask(SWT_SCH_TASK, Copy_pTimer->Expiry);
+#endif
+
+	return STD_TYPES_OK;
+}
+
+void SWT_voidStop(SWT_Timer_t * Copy_pTimer)
+{
+	if ((Copy_pTimer != NULL) && (Copy_pTimer->ppPrev != NULL))
+	{
+		SWT_voidUnlink(Copy_pTimer);
+	}
+}
+
+u8 SWT_u8IsRunning(const SWT_Timer_t * Copy_pTimer)
+{
+	return (Copy_pTimer->ppPrev != NULL);
+}
+
+/* Ticks left before a running timer expires, 0 for a stopped one */
+u32 SWT_u32GetRemaining(const SWT_Timer_t * Copy_pTimer)
+{
+	u32 Local_u32Remaining;
+
+	if (Copy_pTimer->ppPrev == NULL)
+	{
+		return 0;
+	}
+	Local_u32Remaining = Copy_pTimer->Expiry - SWT_u32GetTickCount();
+	return ((s32)Local_u32Remaining < 0) ? 0 : Local_u32Remaining;
+}
+
+/* Earliest tick SWT_voidDispatch has work at: the first busy slot of level 0, or the first
+   cascade of a busy slot of an upper level (its timers expire at or after it).
+   SWT_u32Next + SWT_RANGE when no timer is armed */
+u32 SWT_u32GetNextEvent(void)
+{
+	u32 Local_u32Next = SWT_u32Next + SWT_RANGE;
+	u32 Local_u32Span;
+	u32 Local_u32Tick;
+	u32 Local_u32Slot;
+	u8 Local_u8Level;
+
+	for (Local_u8Level = 0; Local_u8Level < SWT_LEVELS; Local_u8Level++)
+	{
+		/* Span starts from the first one not cascaded yet */
+		Local_u32Span = 1UL << (SWT_LEVEL_BITS * Local_u8Level);
+		Local_u32Tick = (SWT_u32Next + Local_u32Span - 1) & ~(Local_u32Span - 1);
+		for (Local_u32Slot = 0; Local_u32Slot < SWT_SLOTS; Local_u32Slot++)
+		{
+			if ((s32)(Local_u32Tick - Local_u32Next) >= 0)
+			{
+				break;
+			}
+			if (SWT_apWheel[Local_u8Level][(Local_u32Tick >> (SWT_LEVEL_BITS * Local_u8Level)) & SWT_SLOT_MASK] != NULL)
+			{
+				Local_u32Next = Local_u32Tick;
+				break;
+			}
+			Local_u32Tick += Local_u32Span;
+		}
+	}
+	return Local_u32Next;
+}
+
+u32 SWT_u32GetTickCount(void)
+{
+#if (SWT_TICK_SOURCE == SWT_SOURCE_GPT)
+	return SWT_u32Ticks;
+#else
+	return SCH_u32GetTickCount();
+#endif
+}
+
+/* Notification of the GPT channel (SWT_SOURCE_GPT), the only entry called from interrupt context */
+void SWT_voidTick(void)
+{
+	SWT_u32Ticks++;
+}
+
+/* Deferred context: runs the callbacks of every tick elapsed since the last call, from the main loop */
+void SWT_voidDispatch(void)
+{
+	u32 Local_u32Now = SWT_u32GetTickCount();
+
+	while ((s32)(Local_u32Now - SWT_u32Next) >= 0)
+	{
+		SWT_voidProcessTick();
+	}
+#if (SWT_TICK_SOURCE == SWT_SOURCE_SCH)
+	/* No release of the timers task before the next expiry, the scheduler can sleep until then */
+	SCH_voidDeferTask(SWT_SCH_TASK, SWT_u32GetNextEvent());
+#endif
+}
@@ -6,9 +6,58 @@
 #include <BIT_MATH.h>
 #include <stm32f103C8.h>
 #include <STD_TYPES.h>
+#include <BIT_BAND.h>
+#include "DMA_interface.h"
 #include "UART_interface.h"
-#include "UART_private.h"
 #include "UART_config.h"
+#include "UART_private.h"
+
+#if MUSART1_TX_MODE != MUSART1_TX_BLOCKING
+/* TX ring: Head is written by the senders (main context), Tail by the TXE interrupt / DMA completion */
+static u8 MUSART1_u8TxBuffer[MUSART1_TX_BUFFER_SIZE];
+static volatile u16 MUSART1_u16TxHead = 0;
+static volatile u16 MUSART1_u16TxTail = 0;
+#endif
+static volatile u32 MUSART1_u32TxDropped = 0;
+
+#if MUSART1_TX_MODE == MUSART1_TX_DMA
+/* bytes moved by the running DMA transfer, 0 when the channel is idle */
+static volatile u16 MUSART1_u16TxDmaLength = 0;
+
+/* starts DMA on the oldest contiguous chunk of the ring, the part after the wrap goes on the next completion */
+static void MUSART1_voidTxDmaKick(void)
+{
+	u16 LOC_u16Tail = MUSART1_u16TxTail;
+	u16 LOC_u16Index = LOC_u16Tail & MUSART1_TX_BUFFER_MASK;
+	u16 LOC_u16Pending = MUSART1_u16TxHead - LOC_u16Tail;
+
+	if (LOC_u16Pending > (MUSART1_TX_BUFFER_SIZE - LOC_u16Index))
+	{
+		LOC_u16Pending = MUSART1_TX_BUFFER_SIZE - LOC_u16Index;
+	}
+	if (LOC_u16Pending != 0)
+	{
+		MUSART1_u16TxDmaLength = LOC_u16Pending;
+		DMA_u8StartTransfer(MUSART1_TX_DMA_CHANNEL, (DMA_Address_t)&MUSART1->DR, (DMA_Address_t)&MUSART1_u8TxBuffer[LOC_u16Index], LOC_u16Pending);
+	}
+}
+
+static void MUSART1_voidTxDmaCallBack(u8 Copy_u8Event)
+{
+	if (Copy_u8Event == DMA_EV_HALF_TRANSFER)
+	{
+		return;
+	}
+	if (Copy_u8Event == DMA_EV_TRANSFER_ERROR)
+	{
+		/* the channel is stopped by the hardware, the chunk is lost */
+		MUSART1_u32TxDropped += MUSART1_u16TxDmaLength;
+	}
+	MUSART1_u16TxTail += MUSART1_u16TxDmaLength;
+	MUSART1_u16TxDmaLength = 0;
+	MUSART1_voidTxDmaKick();
+}
+#endif
 
 void MUSART1_voidInit(void)
 {
@@ -21,7 +70,7 @@ void MUSART1_voidInit(void)
 		LOC_u64Mantissa += 1;
 		LOC_u64Fraction = 0;
 	}
-#if MUSART1_STATUS == USART1_ENABLE
+#if MUSART1_STATUS == MUSART1_ENABLE
 
 	MUSART1->SR = 0;
 
@@ -114,9 +163,20 @@ void MUSART1_voidInit(void)
 #endif
 
 	MUSART1->BRR = (LOC_u64Mantissa << 4) | (LOC_u64Fraction / 100);
+
+#if MUSART1_TX_MODE == MUSART1_TX_DMA
+	{
+		const DMA_ChannelConfig_t LOC_TxDmaConfig = {DMA_MEM_TO_PERIPH, DMA_SIZE_8BIT, DMA_SIZE_8BIT, DMA_ENABLE, DMA_DISABLE, DMA_PRIORITY_LOW};
+
+		DMA_u8ChannelInit(MUSART1_TX_DMA_CHANNEL, &LOC_TxDmaConfig);
+		DMA_u8SetCallBack(MUSART1_TX_DMA_CHANNEL, MUSART1_voidTxDmaCallBack);
+		BITBAND_SET(MUSART1->CR3, USART_CR3_DMAT);
+	}
+#endif
+
 	SET_BIT(MUSART1->CR1, 13);
 
-#elif MUSART1_STATUS == USART1_DISABLE
+#elif MUSART1_STATUS == MUSART1_DISABLE
 	CLR_BIT(MUSART1->CR1, 0);
 
 #endif
@@ -124,13 +184,68 @@ void MUSART1_voidInit(void)
 
 void MUSART1_voidSendChar(u8 Copy_u8Char)
 {
+#if MUSART1_TX_MODE == MUSART1_TX_BLOCKING
 
 	MUSART1->DR = Copy_u8Char;
 
-	while (GET_BIT(MUSART1->SR, 6) == 0)
+	while (GET_BIT(MUSART1->SR, USART_SR_TC) == 0)
 		;
 
-	CLR_BIT(MUSART1->SR, 6);
+	BITBAND_CLR(MUSART1->SR, USART_SR_TC);
+
+#else
+
+	MUSART1_u16Enqueue(&Copy_u8Char, 1);
+
+#endif
+}
+
+u16 MUSART1_u16Enqueue(const u8 *Copy_pu8Data, u16 Copy_u16Length)
+{
+	u16 LOC_u16Iterator;
+
+#if MUSART1_TX_MODE == MUSART1_TX_BLOCKING
+
+	for (LOC_u16Iterator = 0; LOC_u16Iterator < Copy_u16Length; LOC_u16Iterator++)
+	{
+		MUSART1_voidSendChar(Copy_pu8Data[LOC_u16Iterator]);
+	}
+
+#else
+
+	u16 LOC_u16Head = MUSART1_u16TxHead;
+	u16 LOC_u16Free = MUSART1_TX_BUFFER_SIZE - (u16)(LOC_u16Head - MUSART1_u16TxTail);
+
+	if (Copy_u16Length > LOC_u16Free)
+	{
+		MUSART1_u32TxDropped += Copy_u16Length - LOC_u16Free;
+		Copy_u16Length = LOC_u16Free;
+	}
+	for (LOC_u16Iterator = 0; LOC_u16Iterator < Copy_u16Length; LOC_u16Iterator++)
+	{
+		MUSART1_u8TxBuffer[(LOC_u16Head + LOC_u16Iterator) & MUSART1_TX_BUFFER_MASK] = Copy_pu8Data[LOC_u16Iterator];
+	}
+	/* publish the bytes, then make sure the drain is running */
+	MUSART1_u16TxHead = LOC_u16Head + Copy_u16Length;
+
+#if MUSART1_TX_MODE == MUSART1_TX_INTERRUPT
+	BITBAND_SET(MUSART1->CR1, USART_CR1_TXEIE);
+#elif MUSART1_TX_MODE == MUSART1_TX_DMA
+	/* an idle channel raises no completion, so nobody else can start it meanwhile */
+	if (MUSART1_u16TxDmaLength == 0)
+	{
+		MUSART1_voidTxDmaKick();
+	}
+#endif
+
+#endif
+
+	return Copy_u16Length;
+}
+
+u32 MUSART1_u32GetDropCount(void)
+{
+	return MUSART1_u32TxDropped;
 }
 
 void MUSART1_voidSendString(u8 *Copy_ptrString)
@@ -152,7 +267,7 @@ u8 MUSART1_u8ReceiveChar(void)
 	u8 LOC_u8Data = 0;
 	u32 LOC_u8TimeOut = 0;
 
-	CLR_BIT(MUSART1->SR, 5);
+	BITBAND_CLR(MUSART1->SR, 5);
 
 	while ((GET_BIT(MUSART1->SR, 5) == 0) && (LOC_u8TimeOut < THRESHOLD_VALUE))
 	{
@@ -171,3 +286,32 @@ u8 MUSART1_u8ReceiveChar(void)
 
 	return LOC_u8Data;
 }
+
+#if MUSART1_TX_MODE == MUSART1_TX_INTERRUPT
+void USART1_IRQHandler(void)
+{
+	if (GET_BIT(MUSART1->CR1, USART_CR1_TXEIE) && GET_BIT(MUSART1->SR, USART_SR_TXE))
+	{
+		if (MUSART1_u16TxTail != MUSART1_u16TxHead)
+		{
+			MUSART1->DR = MUSART1_u8TxBuffer[MUSART1_u16TxTail & MUSART1_TX_BUFFER_MASK];
+			MUSART1_u16TxTail++;
+		}
+		else
+		{
+			/* ring empty, the next enqueue enables it again */
+			BITBAND_CLR(MUSART1->CR1, USART_CR1_TXEIE);
+		}
+	}
+}
+#endif
+
+#if MUSART1_RETARGET_PRINTF == MUSART1_ENABLE
+/* newlib output hook: printf only queues its text, what does not fit is counted by MUSART1_u32GetDropCount */
+int _write(int Copy_intFile, char *Copy_pcData, int Copy_intLength)
+{
+	(void)Copy_intFile;
+	MUSART1_u16Enqueue((const u8 *)Copy_pcData, (u16)Copy_intLength);
+	return Copy_intLength;
+}
+#endif
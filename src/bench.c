@@ -0,0 +1,116 @@
+#include "BIT_MATH.h"
+#include "STD_TYPES.h"
+
+#include "bench.h"
+#include "bench_config.h"
+#include "PROF_interface.h"
+#include "DIO.h"
+#include "Dio_Cfg.h"
+#include "Port.h"
+#include "PWM.h"
+#include "hall.h"
+#include "tracker.h"
+#include "sonar_config.h"
+
+#if BENCH_ENABLE
+
+#if !PROF_ENABLE
+#error "BENCH_ENABLE needs PROF_ENABLE"
+#endif
+
+//* application functions under test (main.c)
+void getRequiredDistance(u8 speedKM, u8 *distance);
+void getRequiredSpeed(u8 distance, u8 *currentSafeSpeed);
+void ACC();
+
+extern Port_ConfigType Port_PinsConfig[PortNumberOfPortPins];
+
+//* sink for the results, keeps the calls from being optimized away
+volatile u8 benchSink;
+
+void BENCH_Run()
+{
+    SpeedData speed;
+    PROF_Stats_t baseline;
+    PROF_Zone_t applicationZones[PROF_ZONE_BENCH_BASELINE];
+    u8 value;
+    u16 i;
+    u8 zone;
+
+    //* the functions under test carry their own application zones (ACC, HALL_GetSpeed, Port_Init),
+    //* kept aside so the benchmark calls do not show up in them
+    for (zone = 0; zone < PROF_ZONE_BENCH_BASELINE; zone++)
+    {
+        applicationZones[zone] = PROF_Zones[zone];
+    }
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        PROF_BEGIN(PROF_ZONE_BENCH_BASELINE);
+        PROF_END(PROF_ZONE_BENCH_BASELINE);
+
+        PROF_BEGIN(PROF_ZONE_BENCH_DIO_READ);
+        value = Dio_ReadChannel(BUT_1);
+        PROF_END(PROF_ZONE_BENCH_DIO_READ);
+        benchSink = value;
+
+        PROF_BEGIN(PROF_ZONE_BENCH_DIO_WRITE);
+        Dio_WriteChannel(LED_1, (Dio_LevelType)(i & 1));
+        PROF_END(PROF_ZONE_BENCH_DIO_WRITE);
+
+        PROF_BEGIN(PROF_ZONE_BENCH_DIO_WRITE_INLINE);
+        Dio_WriteChannelInline(LED_1, (Dio_LevelType)(i & 1));
+        PROF_END(PROF_ZONE_BENCH_DIO_WRITE_INLINE);
+
+        PROF_BEGIN(PROF_ZONE_BENCH_PORT_INIT);
+        Port_Init(Port_PinsConfig);
+        PROF_END(PROF_ZONE_BENCH_PORT_INIT);
+
+        PROF_BEGIN(PROF_ZONE_BENCH_PWM_DUTY);
+        MPWM_SetDutyCycle(MPWM_Channel_1, 0);
+        PROF_END(PROF_ZONE_BENCH_PWM_DUTY);
+
+        PROF_BEGIN(PROF_ZONE_BENCH_HALL_SPEED);
+        HALL_GetSpeed(&speed);
+        PROF_END(PROF_ZONE_BENCH_HALL_SPEED);
+        benchSink = speed.speedPerKm;
+
+        //* every speed and distance is visited over the iterations
+        PROF_BEGIN(PROF_ZONE_BENCH_REQ_DISTANCE);
+        getRequiredDistance((u8)(i * 4), &value);
+        PROF_END(PROF_ZONE_BENCH_REQ_DISTANCE);
+        benchSink = value;
+
+        PROF_BEGIN(PROF_ZONE_BENCH_REQ_SPEED);
+        getRequiredSpeed((u8)(i * 4), &value);
+        PROF_END(PROF_ZONE_BENCH_REQ_SPEED);
+        benchSink = value;
+
+        PROF_BEGIN(PROF_ZONE_BENCH_ACC);
+        ACC();
+        PROF_END(PROF_ZONE_BENCH_ACC);
+
+        //* one sweep apart, closing at 3 m/s from 40 m: every update runs the full filter step
+        PROF_BEGIN(PROF_ZONE_BENCH_TRACKER);
+        value = TRACKER_u8Update((u32)(i + 1) * SONAR_CONVERSION_MS, (u16)(4000 - (i * 3 * SONAR_CONVERSION_MS) / 10));
+        PROF_END(PROF_ZONE_BENCH_TRACKER);
+        benchSink = value;
+    }
+
+    for (zone = 0; zone < PROF_ZONE_BENCH_BASELINE; zone++)
+    {
+        PROF_Zones[zone] = applicationZones[zone];
+    }
+
+    //* the zones report the function alone: the cheapest empty zone is the cost of the markers,
+    //* the benchmark zones follow the baseline one up to the end of the table
+    if (PROF_u8GetStats(PROF_ZONE_BENCH_BASELINE, &baseline) == STD_TYPES_OK)
+    {
+        for (zone = PROF_ZONE_BENCH_BASELINE + 1; zone < PROF_ZONE_COUNT; zone++)
+        {
+            PROF_voidSubtract(zone, baseline.Min);
+        }
+    }
+}
+
+#endif
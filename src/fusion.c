@@ -0,0 +1,139 @@
+#include "BIT_MATH.h"
+#include "STD_TYPES.h"
+
+#include "fusion.h"
+#include "fusion_config.h"
+#include "sonar.h"
+#include "sonar_filter.h"
+
+#define FUSION_SENSORS 2
+
+static const u8 sensorIndex[FUSION_SENSORS] = {SONAR_F1, SONAR_F2};
+
+static u32 variance[FUSION_SENSORS];
+static u32 seenMs[FUSION_SENSORS]; //* last reading already taken into the variance
+static FusionState state;
+
+static u32 clampU32(u32 value, u32 min, u32 max)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+//* 255 while fresh, falling linearly to 0 at FUSION_STALE_MS
+static u32 freshness(u32 ageMs)
+{
+    if (ageMs <= FUSION_FRESH_MS)
+    {
+        return FUSION_FULL_CONFIDENCE;
+    }
+    if (ageMs >= FUSION_STALE_MS)
+    {
+        return 0;
+    }
+    return ((FUSION_STALE_MS - ageMs) * FUSION_FULL_CONFIDENCE) / (FUSION_STALE_MS - FUSION_FRESH_MS);
+}
+
+void FUSION_Init()
+{
+    u8 i;
+
+    for (i = 0; i < FUSION_SENSORS; i++)
+    {
+        variance[i] = FUSION_MIN_VARIANCE_CM2;
+        seenMs[i] = 0;
+    }
+    state.gapCm = 0;
+    state.confidence = 0;
+    state.sensors = 0;
+    state.timeMs = 0;
+}
+
+void FUSION_Update(u32 nowMs)
+{
+    SonarFilterStats stats[FUSION_SENSORS];
+    u32 fresh[FUSION_SENSORS];
+    u32 weight[FUSION_SENSORS];
+    u32 difference;
+    u32 confidence;
+    s32 residual;
+    u8 used = 0;
+    u8 i;
+
+    for (i = 0; i < FUSION_SENSORS; i++)
+    {
+        SONARFILTER_GetStats(sensorIndex[i], &stats[i]);
+        fresh[i] = stats[i].valid ? freshness(nowMs - stats[i].acceptMs) : 0;
+        if (fresh[i] != 0)
+        {
+            used |= (u8)(1 << i);
+        }
+    }
+
+    if (used == 0)
+    {
+        //* nothing usable: keep the last gap for the record, the controller sees no confidence
+        state.confidence = 0;
+        state.sensors = 0;
+        return;
+    }
+
+    if (used != (FUSION_USED_F1 | FUSION_USED_F2))
+    {
+        i = (used == FUSION_USED_F1) ? 0 : 1;
+        state.gapCm = stats[i].distanceCm;
+        confidence = (FUSION_SINGLE_CONFIDENCE * fresh[i]) / FUSION_FULL_CONFIDENCE;
+    }
+    else
+    {
+        difference = (stats[0].distanceCm > stats[1].distanceCm) ? (u32)(stats[0].distanceCm - stats[1].distanceCm)
+                                                                  : (u32)(stats[1].distanceCm - stats[0].distanceCm);
+        if (difference > FUSION_AGREE_CM)
+        {
+            //* disagreement: the nearer reading is the safe one, confidence falls with the gap between them
+            state.gapCm = (stats[0].distanceCm < stats[1].distanceCm) ? stats[0].distanceCm : stats[1].distanceCm;
+            confidence = (FUSION_FULL_CONFIDENCE * FUSION_AGREE_CM) / difference;
+            confidence = (confidence * ((fresh[0] < fresh[1]) ? fresh[0] : fresh[1])) / FUSION_FULL_CONFIDENCE;
+        }
+        else
+        {
+            //* inverse variance weights, variance >= FUSION_MIN_VARIANCE_CM2 keeps distance * weight within u32
+            for (i = 0; i < FUSION_SENSORS; i++)
+            {
+                weight[i] = (((u32)1 << 16) / variance[i]) * fresh[i] / FUSION_FULL_CONFIDENCE + 1;
+            }
+            state.gapCm = (u16)(((stats[0].distanceCm * weight[0]) + (stats[1].distanceCm * weight[1]) +
+                                 ((weight[0] + weight[1]) / 2)) /
+                                (weight[0] + weight[1]));
+            confidence = (fresh[0] > fresh[1]) ? fresh[0] : fresh[1];
+
+            //* each new reading moves the variance of its sensor toward its squared residual
+            for (i = 0; i < FUSION_SENSORS; i++)
+            {
+                if (stats[i].acceptMs != seenMs[i])
+                {
+                    seenMs[i] = stats[i].acceptMs;
+                    residual = (s32)stats[i].distanceCm - (s32)state.gapCm;
+                    variance[i] = clampU32((u32)((s32)variance[i] + (((residual * residual) - (s32)variance[i]) >>
+                                                                    FUSION_VARIANCE_SHIFT)),
+                                           FUSION_MIN_VARIANCE_CM2, FUSION_MAX_VARIANCE_CM2);
+                }
+            }
+        }
+    }
+
+    state.confidence = (u8)confidence;
+    state.sensors = used;
+    state.timeMs = 0;
+    for (i = 0; i < FUSION_SENSORS; i++)
+    {
+        if (((used >> i) & 1) && (stats[i].acceptMs > state.timeMs))
+        {
+            state.timeMs = stats[i].acceptMs;
+        }
+    }
+}
+
+void FUSION_GetState(FusionState *ptr_State)
+{
+    *ptr_State = state;
+}
@@ -1,13 +1,12 @@
 
 #include <BIT_MATH.h>
 #include <get_distance.h>
+#include <sonar.h>
+#include <sonar_filter.h>
 
 #include <STD_TYPES.h>
 
-void GetDistance_u16GetForwardDistance(u16 *Copy_ptrForwardDistanceData);
-void GetDistance_u16AllDistance(u16 *Copy_ptrAllDistanceData);
 void LOC_u16GetDistance(u16 *Copy_ptrDistanceData, u8 Copy_u8Count);
-u16 returnTestNum();
 
 void GetDistance_u16GetForwardDistance(u16 *Copy_ptrForwardDistanceData)
 {
@@ -18,20 +17,25 @@ void GetDistance_u16AllDistance(u16 *Copy_ptrAllDistanceData)
     LOC_u16GetDistance(Copy_ptrAllDistanceData, CountAll);
 }
 
+//* latest reading of every sonar, kept here because the ring hands each one out once
+static u16 latestDistance[CountAll];
+
 void LOC_u16GetDistance(u16 *Copy_ptrDistanceData, u8 Copy_u8Count)
 {
-    //* frist 2 for forward sonars and last 2 for backward
-    for (u8 i = 0; i < Copy_u8Count; i++)
+    RING_Sample_t sample;
+
+    //* batch all readings queued by the I2C interrupt since the last call, no interrupt masking needed
+    while (HAL_u8SonarPopSample(&sample) == STD_TYPES_OK)
     {
-        *(Copy_ptrDistanceData + i) = returnTestNum(); // HAL_u16SonarReportLastReading(SONAR_ADDRESS[i]);
+        if (sample.Source < CountAll)
+        {
+            //* spurious echoes are rejected here, the last accepted distance is kept instead
+            SONARFILTER_u8Update(sample.Source, sample.TimeStamp, (u16)sample.Value, &latestDistance[sample.Source]);
+        }
     }
+    //* frist 2 for forward sonars and last 2 for backward
     for (u8 i = 0; i < Copy_u8Count; i++)
     {
-        printf("sonar %d = %d \n", i + 1, *(Copy_ptrDistanceData + i));
+        *(Copy_ptrDistanceData + i) = latestDistance[i];
     }
 }
-
-u16 returnTestNum()
-{
-    return 40;
-}
\ No newline at end of file
@@ -2,31 +2,157 @@
 #include "STD_TYPES.h"
 
 #include "hall.h"
-#include "hall_private.h"
 #include "hall_config.h"
 #include "GPT.h"
-u32 oldCounter = 0x0;
-void HALL_GetSpeed(SpeedData *ptr_SpeedData)
+#include "hall_private.h"
+#include "RING_BUFFER.h"
+#include "PROF_interface.h"
+
+//* edge count, time and method of the previous sample of one estimate
+typedef struct
+{
+    u32 edges;
+    u32 time;
+    u8 method;
+} HallWindow;
+
+//* polled by HALL_GetSpeed (speed task)
+static HallWindow polledWindow = {0, 0, HALL_METHOD_PERIOD};
+//* queued by the capture interrupt, the only producer of speedRing, ACC is its only consumer
+static HallWindow queuedWindow = {0, 0, HALL_METHOD_PERIOD};
+RING_DEFINE(speedRing, HALL_RING_SIZE);
+
+//* period method: RPM from the time between the last two edges, good at low speed
+static u32 HALL_RpmFromPeriod(u32 now)
+{
+    u32 edges;
+    u32 period;
+    u32 sinceLastEdge;
+
+    //* period and last edge time must come from the same edge
+    do
+    {
+        edges = Gpt_u32GetCaptureEdgeCount();
+        period = Gpt_u32GetCapturePeriod();
+        sinceLastEdge = now - Gpt_u32GetLastCaptureTime();
+    } while (edges != Gpt_u32GetCaptureEdgeCount());
+
+    if ((edges < 2) || (period == 0) || (sinceLastEdge > HALL_STOP_TIMEOUT_TICKS))
+    {
+        return 0;
+    }
+    //* no edge for longer than the last period: the wheel is slower than that period says
+    if (sinceLastEdge > period)
+    {
+        period = sinceLastEdge;
+    }
+    return HALL_RPM_TIME_PRODUCT / period;
+}
+
+//* count method: RPM from the edges counted over the sample window, good at high speed
+static u32 HALL_RpmFromCount(u32 edges, u32 window)
+{
+    if (window == 0)
+    {
+        return 0;
+    }
+    if (edges > (0xFFFFFFFFUL / HALL_RPM_TIME_PRODUCT))
+    {
+        return HALL_RPM_AT_MAX_SPEED;
+    }
+    return (edges * HALL_RPM_TIME_PRODUCT) / window;
+}
+
+//* speed over the window since the previous estimate ending at now, with edges counted in total
+static void HALL_Estimate(HallWindow *window, u32 now, u32 edges, SpeedData *ptr_SpeedData)
 {
-    u32 snapshot = Gpt_u16GetCounter();
-    // TODO: need #define for each case 1) car moving 2) car stoped 3)Exception
-    if (snapshot == 0)
+    u32 newEdges = edges - window->edges;
+    u32 crossoverSq = HALL_CROSSOVER_EDGES_SQ(now - window->time);
+
+    //* count method once the window holds the crossover edge count (hall_config.h), back below half of it
+    if ((window->method == HALL_METHOD_PERIOD) && (newEdges >= 2) &&
+        ((newEdges > HALL_MAX_SQUARED_EDGES) || ((newEdges * newEdges) >= crossoverSq)))
+    {
+        window->method = HALL_METHOD_COUNT;
+    }
+    else if ((window->method == HALL_METHOD_COUNT) && (newEdges <= HALL_MAX_SQUARED_EDGES) &&
+             ((4 * newEdges * newEdges) < crossoverSq))
+    {
+        window->method = HALL_METHOD_PERIOD;
+    }
+
+    if (window->method == HALL_METHOD_COUNT)
+    {
+        ptr_SpeedData->RPM = HALL_RpmFromCount(newEdges, now - window->time);
+    }
+    else
+    {
+        ptr_SpeedData->RPM = HALL_RpmFromPeriod(now);
+    }
+    window->edges = edges;
+    window->time = now;
+
+    if (ptr_SpeedData->RPM == 0)
     {
         ptr_SpeedData->statusCode = CAR_NOT_MOVING;
     }
-    else if (snapshot > 0)
+    else
     {
         ptr_SpeedData->statusCode = CAR_MOVING;
     }
+    //* Q16.16 integer conversion, no soft-float on the M3
+    if (ptr_SpeedData->RPM >= HALL_RPM_AT_MAX_SPEED)
+    {
+        ptr_SpeedData->speedPerKm = HALL_MAX_SPEED_KMH;
+    }
     else
     {
-        ptr_SpeedData->statusCode = CAR_SPEED_EXCEPTION;
+        ptr_SpeedData->speedPerKm = (u8)((ptr_SpeedData->RPM * HALL_KMH_PER_RPM_Q16) >> 16);
+    }
+}
+
+//* TIM2 capture interrupt: queues one sample per edge, at most one per HALL_SAMPLE_PERIOD_MS. The window
+//* ends on the edge just captured, so the count method sees whole edge periods
+static void HALL_CaptureNotification(void)
+{
+    u32 now = Gpt_u32GetLastCaptureTime();
+    SpeedData data;
+    u32 rpm;
+    RING_Sample_t sample;
+
+    if ((now - queuedWindow.time) < HALL_SAMPLE_PERIOD_TICKS)
+    {
+        return;
     }
-    ptr_SpeedData->RPM = snapshot * 60;
-    ptr_SpeedData->speedPerKm = (ptr_SpeedData->RPM * 3.14 * wheelRaduis * 3) / (u32)25;
+    HALL_Estimate(&queuedWindow, now, Gpt_u32GetCaptureEdgeCount(), &data);
+
+    rpm = (data.RPM > 0xFFFFFF) ? 0xFFFFFF : data.RPM;
+    sample.TimeStamp = now;
+    sample.Value = (rpm << 8) | data.speedPerKm;
+    sample.Source = data.statusCode;
+    RING_u8Push(&speedRing, &sample);
+}
+
+void HALL_GetSpeed(SpeedData *ptr_SpeedData)
+{
+    PROF_BEGIN(PROF_ZONE_HALL_GET_SPEED);
+    HALL_Estimate(&polledWindow, Gpt_u32GetCaptureTime(), Gpt_u32GetCaptureEdgeCount(), ptr_SpeedData);
+    PROF_END(PROF_ZONE_HALL_GET_SPEED);
+}
+
+u8 HALL_u8PopSpeedSample(RING_Sample_t *ptr_Sample)
+{
+    return RING_u8Pop(&speedRing, ptr_Sample);
+}
+
+u8 HALL_u8GetMethod()
+{
+    return polledWindow.method;
 }
 
 void HALL_Init()
 {
-    Gpt_SetMode(External_Clock_MODE);
+    //* hall edges are timestamped by TIM2 CH1 input capture
+    Gpt_SetMode(Input_Capture_MODE);
+    Gpt_SetCaptureNotification(HALL_CaptureNotification);
 }
@@ -5,13 +5,44 @@
 #include <sonar.h>
 
 #include <STD_TYPES.h>
+#include <RCC_interface.h>
+#include <NVIC_interface.h>
+#include <DMA_interface.h>
+#include <I2C_interface.h>
+#include <UART_interface.h>
+#include <UART_config.h>
+#include <SCH_interface.h>
+#include <SCH_config.h>
+#include <SWT_interface.h>
+#include <PWM.h>
+#include <GPT.h>
+#include <speed_control.h>
+#include <speed_control_config.h>
+#include <telemetry.h>
+#include <safe_distance.h>
+#include <tracker.h>
+#include <sonar_filter.h>
+#include <sonar_filter_config.h>
+#include <fusion.h>
+#include <PROF_interface.h>
+#include <bench.h>
+#include <bench_config.h>
 
-//* macros for PWM channels
+//* actuators of stopAcu
 #define MOTOR 1
 #define BRAKE 2
 
 //* User input
 #define UserSpeed 80
+//* brake toward the safe speed when the lead car is closer than this in time, even if the gap still looks safe
+#define TTC_BRAKE_MS 3000
+//* a gap at the no echo distance means nothing within the sonar range: the road is clear, the safe
+//* distance of the user speed is beyond what the sonars see and must not cap the speed
+#define ACC_CLEAR_ROAD_CM SONAR_FILTER_NO_ECHO_CM
+//* fused gaps below this confidence (disagreeing or ageing sensors, see fusion_config.h) are still used as
+//* measured, but the speed is capped at ACC_UNTRUSTED_SPEED_KMH until the sensors agree again
+#define ACC_TRUSTED_CONFIDENCE 128
+#define ACC_UNTRUSTED_SPEED_KMH 30
 //* from user speed
 u8 userSpeedSafeDistance = 0;
 //''
@@ -19,10 +50,18 @@ u8 motorStatus = 1;
 u8 brakeStatus = 0;
 u8 currentDistance = 0;
 u8 currentSafeSpeed = 0;
+FusionState forwardGap;
+TrackerState leadTrack;
+
+//* actuators PWM channels
+const MPWM_ConfigType motorPwmConfig = {SPEEDCTRL_MOTOR_CHANNEL, SPEEDCTRL_PWM_PERIOD, 0, PWM_LOW};
+const MPWM_ConfigType brakePwmConfig = {SPEEDCTRL_BRAKE_CHANNEL, SPEEDCTRL_PWM_PERIOD, 0, PWM_LOW};
 
 //* Sensors data
 SpeedData currentSpeedData;
 u16 LOC_u16SonarDistance[4] = {0, 0, 0, 0};
+//* profiling zone sent after the next status frame
+u8 profileZone = 0;
 // LOC function
 void stopAcu(u8 PinNumber);
 void brake(u8 currentSafeSpeed);
@@ -30,32 +69,199 @@ void getRequiredDistance(u8 speedKM, u8 *distance);
 void getRequiredSpeed(u8 distance, u8 *currentSafeSpeed);
 void accelerate(u8 currentSafeSpeed);
 void ACC();
+void systemInit();
+//* scheduler tasks (SCH_Lcfg.c)
+void sonarTask(void);
+void speedTask(void);
+void accTask(void);
+void telemetryTask(void);
 int main()
 {
+    systemInit();
+    SCH_voidInit();
+    while (1)
+    {
+        SCH_voidDispatch();
+    }
     return 0;
 }
+
+void systemInit()
+{
+    RCC_voidInitSysClock();
+    //* DWT cycle counter for the PROF_BEGIN / PROF_END zones
+    PROF_voidInit();
+    //* software timers (sonar windows, I2C watchdog), expired by the scheduler timers task
+    SWT_voidInit();
+    RCC_voidEnableClock(RCC_AHB, 0);   /* DMA1 */
+    RCC_voidEnableClock(RCC_APB1, 0);  /* TIM2 hall counter */
+    RCC_voidEnableClock(RCC_APB1, 1);  /* TIM3 PWM */
+#if SPEEDCTRL_HBRIDGE
+    RCC_voidEnableClock(RCC_APB2, 11); /* TIM1 half bridges */
+#endif
+    RCC_voidEnableClock(RCC_APB1, 21); /* I2C1 sonar bus */
+    RCC_voidEnableClock(RCC_APB2, 0);  /* AFIO */
+    RCC_voidEnableClock(RCC_APB2, 2);  /* GPIOA */
+    RCC_voidEnableClock(RCC_APB2, 3);  /* GPIOB */
+    RCC_voidEnableClock(RCC_APB2, 14); /* USART1 log */
+
+    //* telemetry output: frames only fill the USART1 TX ring, drained by DMA1 channel 4 or the TXE interrupt
+    MUSART1_voidInit();
+#if MUSART1_TX_MODE == MUSART1_TX_DMA
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(DMA_CHANNEL4));
+#elif MUSART1_TX_MODE == MUSART1_TX_INTERRUPT
+    NVIC_u8EnableInterrupt(USART1_IRQN);
+#endif
+
+    //* sonar bus: interrupt / DMA driven I2C transactions
+    I2C_voidInit(I2C1);
+    I2C_voidPeripheralControl(I2C1, I2C_ENABLE);
+    NVIC_u8EnableInterrupt(I2C1_EV_IRQN);
+    NVIC_u8EnableInterrupt(I2C1_ER_IRQN);
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(DMA_CHANNEL6));
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(DMA_CHANNEL7));
+    SONARFILTER_Init();
+    FUSION_Init();
+
+    //* hall edges: TIM2 capture and overflow interrupt
+    HALL_Init();
+    NVIC_u8EnableInterrupt(TIM2_IRQN);
+
+    //* motor and brake actuators, driven by the speed controller, motor duty ramps fed by the TIM3 update DMA
+    MPWM_Init(&motorPwmConfig);
+    MPWM_Init(&brakePwmConfig);
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(MPWM_Ramp_Dma_Channel));
+    SPEEDCTRL_Init();
+    TRACKER_Init();
+    TELEMETRY_Init();
+#if BENCH_ENABLE
+    //* benchmark boot: hot paths measured once on the configured drivers, then the controller and the
+    //* gap estimation the benchmarked ACC() ran start again from rest
+    BENCH_Run();
+    SPEEDCTRL_Init();
+    SONARFILTER_Init();
+    FUSION_Init();
+    TRACKER_Init();
+#endif
+}
+
+//* sonar sweep, advances the ranging scheduler every tick but skips the conversion window
+void sonarTask(void)
+{
+    HAL_voidSonarRangingUpdate(SCH_u32GetTickCount() * SCH_TICK_MS);
+    SCH_voidDeferTask(SCH_TASK_SONAR, SCH_u32GetTickCount() + HAL_u32SonarGetIdleMs() / SCH_TICK_MS);
+}
+
+//* hall slow down and stop detection: the capture interrupt queues a sample per edge, between edges the
+//* last one can only be too high (no edge for longer than its period: the wheel slowed down or stopped)
+void speedTask(void)
+{
+    SpeedData sample;
+
+    HALL_GetSpeed(&sample);
+    if (sample.RPM < currentSpeedData.RPM)
+    {
+        currentSpeedData = sample;
+    }
+}
+
+//* ACC control law
+void accTask(void)
+{
+    ACC();
+}
+
+//* periodic binary status frame
+void telemetryTask(void)
+{
+    TelemetryStatus status;
+    SonarFilterStats filterStats;
+    u8 i;
+
+    status.timeMs = SCH_u32GetTickCount() * SCH_TICK_MS;
+    for (i = 0; i < 4; i++)
+    {
+        status.distance[i] = HAL_u16SonarGetDistance(i);
+        SONARFILTER_GetStats(i, &filterStats);
+        status.rejected[i] = filterStats.rejected;
+        status.filtered[i] = filterStats.distanceCm;
+    }
+    status.speed = currentSpeedData;
+    SPEEDCTRL_GetState(&status.control);
+    status.flags = (motorStatus ? TELEMETRY_FLAG_MOTOR : 0) | (brakeStatus ? TELEMETRY_FLAG_BRAKE : 0);
+#if SPEEDCTRL_HBRIDGE
+    if (MPWM_u8GetBreakState() == MPWM_BREAK_ACTIVE)
+    {
+        status.flags |= TELEMETRY_FLAG_BREAK;
+    }
+#endif
+    TELEMETRY_SendStatus(&status);
+#if PROF_ENABLE
+    //* one profiling zone per period, round robin
+    PROF_Stats_t profile;
+    if (PROF_u8GetStats(profileZone, &profile) == STD_TYPES_OK)
+    {
+        TELEMETRY_SendProfile(status.timeMs, profileZone, &profile);
+    }
+    profileZone = (profileZone + 1 >= PROF_ZONE_COUNT) ? 0 : (profileZone + 1);
+#endif
+#if SCH_IDLE_MEASURE
+    //* idle / active split of the last telemetry period
+    SCH_Load_t load;
+    SCH_voidGetLoad(&load);
+    TELEMETRY_SendLoad(status.timeMs, &load);
+#endif
+}
 void ACC()
 {
+    u8 LOC_u8SpeedLimit = UserSpeed;
+
+    PROF_BEGIN(PROF_ZONE_ACC);
     // Mode 1 maintain user speed
     getRequiredDistance(UserSpeed, &userSpeedSafeDistance);
-    printf("Safe Distance for user speed %d \n", userSpeedSafeDistance);
-    getRequiredSpeed(currentDistance, &currentSafeSpeed);
-    printf("current Safe Speed  %d \n", currentSafeSpeed);
     //* init data
     //! get car data
     GetDistance_u16GetForwardDistance(LOC_u16SonarDistance);
-    currentDistance = LOC_u16SonarDistance[(LOC_u16SonarDistance[1] > LOC_u16SonarDistance[0])] /* condtion return 1 if true and 0 if false */;
-    HALL_GetSpeed(&currentSpeedData);
-    printf("current Distance  %d \n", LOC_u16SonarDistance[0]);
-    printf("current Speed  %d \n", currentSpeedData.speedPerKm);
+    //* one forward gap from F1 and F2 with its confidence
+    FUSION_Update(SCH_u32GetTickCount() * SCH_TICK_MS);
+    FUSION_GetState(&forwardGap);
+    //* confidence picks between the measured gap and the speed cap, it never scales the gap. Before the first
+    //* reading (startup) no obstacle is known, stale sensors keep their last gap; both only cap the speed.
+    //* Sonars report cm, the safe distance tables use m
+    if ((forwardGap.timeMs == 0) || (forwardGap.gapCm >= ACC_CLEAR_ROAD_CM) || (forwardGap.gapCm >= 25500))
+    {
+        currentDistance = 255;
+    }
+    else
+    {
+        currentDistance = (u8)(forwardGap.gapCm / 100);
+    }
+    if (forwardGap.confidence < ACC_TRUSTED_CONFIDENCE)
+    {
+        LOC_u8SpeedLimit = ACC_UNTRUSTED_SPEED_KMH;
+    }
+    getRequiredSpeed(currentDistance, &currentSafeSpeed);
+    //* lead car track: gap, closing speed and time to collision (a time stamp of 0 means no reading yet)
+    if (forwardGap.timeMs != 0)
+    {
+        TRACKER_u8Update(forwardGap.timeMs, forwardGap.gapCm);
+    }
+    TRACKER_GetState(&leadTrack);
+    //* batch the speed samples queued by the hall capture interrupt, the newest wins
+    RING_Sample_t speedSample;
+    while (HALL_u8PopSpeedSample(&speedSample) == STD_TYPES_OK)
+    {
+        currentSpeedData.speedPerKm = HALL_SAMPLE_SPEED(speedSample.Value);
+        currentSpeedData.RPM = HALL_SAMPLE_RPM(speedSample.Value);
+        currentSpeedData.statusCode = speedSample.Source;
+    }
 
     //! Safe distance and speed for user
 
-    //* currentSpeedData.speedPerKm > UserSpeed we must speed down
-    if (currentSpeedData.speedPerKm > UserSpeed)
+    //* currentSpeedData.speedPerKm > UserSpeed (or the cap of an untrusted gap) we must speed down
+    if (currentSpeedData.speedPerKm > LOC_u8SpeedLimit)
     {
-        printf("if currentSpeedData.speedPerKm > UserSpeed \n");
-        brake(UserSpeed);
+        brake(LOC_u8SpeedLimit);
         //! sim for speed down
         // LOC_u16SonarDistance[0] = LOC_u16SonarDistance[0] + 10;
         // LOC_u16SonarDistance[1] = LOC_u16SonarDistance[1] + 10;
@@ -64,67 +270,40 @@ void ACC()
         // printf("end if \n");
     }
 
-    // //! case 1 userSpeedSafeDistance > currentDistance
-    if (userSpeedSafeDistance > currentDistance)
+    // //! case 1 userSpeedSafeDistance > currentDistance or the gap closes too fast
+    if ((userSpeedSafeDistance > currentDistance) || (leadTrack.ttcMs < TTC_BRAKE_MS))
     {
-        printf("user Speed Safe Distance bigger currentDistance \n");
-        brake(currentSafeSpeed);
-        accelerate(currentSafeSpeed);
+        brake((currentSafeSpeed < LOC_u8SpeedLimit) ? currentSafeSpeed : LOC_u8SpeedLimit);
+        accelerate((currentSafeSpeed < LOC_u8SpeedLimit) ? currentSafeSpeed : LOC_u8SpeedLimit);
     }
     //! case 2 userSpeedSafeDistance < currentDistance
     else if (userSpeedSafeDistance <= currentDistance)
     {
-        printf("Safe Distance lower current Distance \n");
-        accelerate(UserSpeed);
+        accelerate(LOC_u8SpeedLimit);
     }
+
+    //* one closed loop step toward the selected target
+    SPEEDCTRL_Step(currentSpeedData.speedPerKm);
+    PROF_END(PROF_ZONE_ACC);
 }
 
-//* tested
+//* O(1) lookups in the generated tables (safe_distance.h), speed in km/h and distance in m
 void getRequiredDistance(u8 speedKM, u8 *distance)
 {
-    u8 disArr[8] = {2, 4, 6, 14, 24, 38, 55, 75};
-    *distance = disArr[speedKM / 16 + (((speedKM % 16) / (float)16) >= .5)];
+    *distance = SAFE_GET_DISTANCE(speedKM);
 }
 
-//* tested
 void getRequiredSpeed(u8 distance, u8 *currentSafeSpeed)
 {
-    u8 SpeedArr[8] = {0, 16, 32, 48, 64, 80, 96, 112};
-    u8 disArr[8] = {2, 4, 6, 14, 24, 38, 55, 75};
-    u8 i;
-    if (distance > disArr[7])
-    {
-        *currentSafeSpeed = SpeedArr[7];
-    }
-    else if (distance == 0)
-    {
-        *currentSafeSpeed = SpeedArr[0];
-    }
-    else
-    {
-        for (i = 0; i < 0b1000; i++)
-        {
-            if (distance < disArr[i])
-            {
-                i--;
-                break;
-            }
-        }
-        *currentSafeSpeed = SpeedArr[i];
-    }
+    *currentSafeSpeed = SAFE_GET_SPEED(distance);
 }
 
 void brake(u8 currentSafeSpeed)
 {
     stopAcu(MOTOR);
-    while (currentSpeedData.speedPerKm > currentSafeSpeed)
-    {
-        // TODO: PWM_channel2(currentSafeSpeed);
-        HALL_GetSpeed(&currentSpeedData);
-    };
-    printf("brake current safe speed = %d \n", currentSafeSpeed);
-    printf("speedPerKm = %d \n", currentSpeedData.speedPerKm);
-    stopAcu(BRAKE);
+    //* the speed controller brakes down to the safe speed over the next ticks (rate limited), no waiting here
+    brakeStatus = 1;
+    SPEEDCTRL_SetTarget(currentSafeSpeed);
 }
 
 void stopAcu(u8 PinNumber)
@@ -133,16 +312,15 @@ void stopAcu(u8 PinNumber)
     {
     case MOTOR:
         motorStatus = 0;
-        printf("Motor Status  %d \n", motorStatus);
         break;
     case BRAKE:
         brakeStatus = 0;
-        printf("Brake Status  %d \n", motorStatus);
         break;
     }
 }
 void accelerate(u8 currentSafeSpeed)
 {
-    currentSpeedData.speedPerKm = currentSafeSpeed;
-    printf("motor  Speed %d \n", currentSpeedData.speedPerKm);
+    motorStatus = 1;
+    brakeStatus = 0;
+    SPEEDCTRL_SetTarget(currentSafeSpeed);
 }
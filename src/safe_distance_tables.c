@@ -0,0 +1,46 @@
+//* generated by tools/gen_safe_tables.py, do not edit
+//* reaction 500 ms, deceleration 800 cm/s^2, margin 200 cm
+
+#include "STD_TYPES.h"
+
+#include "safe_distance.h"
+
+//* speed (km/h) -> safe distance (m)
+const u8 SAFE_DistanceTable[256] = {
+      2,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,   5,   6,
+      6,   6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,
+     12,  12,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  19,  19,  20,
+     20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  27,  27,  28,  29,  30,  30,
+     31,  32,  33,  33,  34,  35,  36,  37,  37,  38,  39,  40,  41,  42,  43,  44,
+     44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,
+     60,  61,  62,  64,  65,  66,  67,  68,  69,  70,  71,  73,  74,  75,  76,  77,
+     79,  80,  81,  82,  84,  85,  86,  87,  89,  90,  91,  93,  94,  95,  97,  98,
+     99, 101, 102, 103, 105, 106, 108, 109, 111, 112, 114, 115, 116, 118, 119, 121,
+    122, 124, 126, 127, 129, 130, 132, 133, 135, 137, 138, 140, 142, 143, 145, 147,
+    148, 150, 152, 153, 155, 157, 158, 160, 162, 164, 165, 167, 169, 171, 173, 174,
+    176, 178, 180, 182, 184, 186, 188, 189, 191, 193, 195, 197, 199, 201, 203, 205,
+    207, 209, 211, 213, 215, 217, 219, 221, 223, 225, 227, 229, 232, 234, 236, 238,
+    240, 242, 244, 247, 249, 251, 253, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+//* distance (m) -> safe speed (km/h)
+const u8 SAFE_SpeedTable[256] = {
+      0,   0,   0,   5,  10,  14,  17,  20,  23,  26,  28,  31,  33,  35,  37,  39,
+     41,  43,  44,  46,  48,  49,  51,  53,  54,  56,  57,  59,  60,  61,  63,  64,
+     65,  67,  68,  69,  70,  72,  73,  74,  75,  76,  77,  78,  80,  81,  82,  83,
+     84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,  98,
+     99, 100, 101, 102, 103, 104, 105, 106, 106, 107, 108, 109, 110, 111, 111, 112,
+    113, 114, 115, 115, 116, 117, 118, 119, 119, 120, 121, 122, 122, 123, 124, 125,
+    125, 126, 127, 128, 128, 129, 130, 131, 131, 132, 133, 133, 134, 135, 135, 136,
+    137, 137, 138, 139, 140, 140, 141, 142, 142, 143, 144, 144, 145, 145, 146, 147,
+    147, 148, 149, 149, 150, 151, 151, 152, 152, 153, 154, 154, 155, 155, 156, 157,
+    157, 158, 158, 159, 160, 160, 161, 161, 162, 163, 163, 164, 164, 165, 166, 166,
+    167, 167, 168, 168, 169, 170, 170, 171, 171, 172, 172, 173, 173, 174, 175, 175,
+    176, 176, 177, 177, 178, 178, 179, 179, 180, 180, 181, 181, 182, 183, 183, 184,
+    184, 185, 185, 186, 186, 187, 187, 188, 188, 189, 189, 190, 190, 191, 191, 192,
+    192, 193, 193, 194, 194, 195, 195, 196, 196, 197, 197, 198, 198, 199, 199, 200,
+    200, 201, 201, 202, 202, 203, 203, 203, 204, 204, 205, 205, 206, 206, 207, 207,
+    208, 208, 209, 209, 210, 210, 210, 211, 211, 212, 212, 213, 213, 214, 214, 215,
+};
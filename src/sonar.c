@@ -6,49 +6,248 @@
 #include "BIT_MATH.h"
 
 #include "sonar.h"
-#include "STK_interface.h"
+#include "sonar_config.h"
 #include "I2C_interface.h"
+#include "RING_BUFFER.h"
+#include "SWT_interface.h"
+#include "SWT_config.h"
+
+/************************************Local Variables************************************/
+
+/*last event reported by the I2C engine for the running sonar transfer*/
+static volatile u8 LOC_u8SonarI2CEvent;
+
+/*ranging scheduler states*/
+#define SONAR_STATE_TRIGGER (0)
+#define SONAR_STATE_CONVERT (1)
+#define SONAR_STATE_READ (2)
+
+/*I2C address and firing group of every sonar*/
+static const u8 LOC_u8SonarAddress[SONAR_COUNT] = {SONAR_BASE_ADDRESS | SONAR_F1_ADDRESS, SONAR_BASE_ADDRESS | SONAR_F2_ADDRESS,
+												   SONAR_BASE_ADDRESS | SONAR_B1_ADDRESS, SONAR_BASE_ADDRESS | SONAR_B2_ADDRESS};
+static const u8 LOC_u8SonarGroup[SONAR_COUNT] = SONAR_GROUPS;
+
+/*ranging scheduler context*/
+static u8 LOC_u8SonarState = SONAR_STATE_TRIGGER;
+static u8 LOC_u8SonarGroupIndex = 0;
+static u8 LOC_u8SonarNext = 0;
+static u32 LOC_u32SonarSweepCount = 0;
+static u32 LOC_u32SonarBusResets = 0;
+
+/*conversion window of the fired group (polled) and watchdog of the ranging transactions (run from the software timer dispatch)*/
+static void LOC_voidSonarWatchdog(SWT_Timer_t *Copy_pTimer);
+static SWT_Timer_t LOC_SonarWindowTimer = SWT_TIMER_INIT(NULL);
+static SWT_Timer_t LOC_SonarWatchdogTimer = SWT_TIMER_INIT(LOC_voidSonarWatchdog);
+
+/*sonar being read, its raw bytes and the last distances of all sonars*/
+static volatile u8 LOC_u8SonarReading = 0;
+static u8 LOC_u8SonarRxArr[2];
+static u8 LOC_u8SonarRangeCmd = TAKE_RANGE_CMD;
+static volatile u16 LOC_u16SonarDistance[SONAR_COUNT];
+
+/*readings handed to the control task, filled from the I2C interrupt*/
+RING_DEFINE(LOC_SonarRing, SONAR_RING_SIZE);
+static volatile u32 LOC_u32SonarReadTime = 0;
 
 /************************************Functions' Definition************************************/
-void LOC_voidSonarSaveRangeReading(u8 Copy_u8Address);
 
-void LOC_voidSonarSaveRangeReading(u8 Copy_u8Address)
+static void LOC_voidSonarI2CCallBack(u8 Copy_u8I2Cx, u8 Copy_u8AppEv)
 {
-	/*local variable to save the data to be sent*/
-	u8 LOC_u8Temp = TAKE_RANGE_CMD;
+	(void)Copy_u8I2Cx;
+	LOC_u8SonarI2CEvent = Copy_u8AppEv;
+}
 
-	/*this function is to send data from the buffer as a master through I2C */
-	I2C_voidMasterSendData(I2C1, &LOC_u8Temp, 1, Copy_u8Address, I2C_NO_REPEAT_S);
+/*runs one DMA transaction on I2C1 and waits for its end, the bytes themselves are moved without the CPU*/
+/*a transaction still running after SONAR_TRANSFER_TIMEOUT_POLLS polls is aborted and reported as failed*/
+static u8 LOC_u8SonarTransfer(u8 Copy_u8Address, u8 *Copy_pu8TxBuffer, u8 Copy_u8TxLen, u8 *Copy_pu8RxBuffer, u8 Copy_u8RxLen)
+{
+	u32 LOC_u32Polls = 0;
+	I2C_Transaction_t LOC_Transaction =
+	{
+		.SlaveAdd = Copy_u8Address,
+		.pTxBuffer = Copy_pu8TxBuffer,
+		.TxLen = Copy_u8TxLen,
+		.pRxBuffer = Copy_pu8RxBuffer,
+		.RxLen = Copy_u8RxLen,
+		.RepeatedState = I2C_NO_REPEAT_S,
+		.TransferMode = I2C_MODE_DMA,
+		.pfCallBack = LOC_voidSonarI2CCallBack
+	};
+
+	if (I2C_u8SubmitTransaction(I2C1, &LOC_Transaction) != STD_TYPES_OK)
+	{
+		return STD_TYPES_NOK;
+	}
+	while ((I2C_u8GetState(I2C1) != I2C_STATE_READY) && (LOC_u32Polls < SONAR_TRANSFER_TIMEOUT_POLLS))
+	{
+		LOC_u32Polls++;
+	}
+	if (I2C_u8GetState(I2C1) != I2C_STATE_READY)
+	{
+		/*the callback reports I2C_EV_ABORTED, the bus is released for the ranging scheduler*/
+		I2C_voidAbortTransaction(I2C1);
+		LOC_u32SonarBusResets++;
+	}
+
+	return (LOC_u8SonarI2CEvent == I2C_EV_CMPLT) ? STD_TYPES_OK : STD_TYPES_NOK;
 }
 
-u16 HAL_u16SonarReportLastReading(u8 Copy_u8Address)
+void HAL_u16SonarChangeAddress(u8 Copy_u8Address, u8 Copy_u8NewAddress)
 {
-	/*Local array to save readings byte by byte */
-	u8 Loc_u8ReceivedArr[2];
+	/*local array to store commands and address*/
+	u8 Loc_u8Arr[3] = {CHANGE_SEQUENCE_1, CHANGE_SEQUENCE_2, Copy_u8NewAddress};
 
-	/*local variable to save readings in order*/
-	u16 Loc_u16Result;
+	/*sending new address (3 bytes through DMA)*/
+	LOC_u8SonarTransfer(Copy_u8Address, Loc_u8Arr, 3, NULL, 0);
+}
 
-	LOC_voidSonarSaveRangeReading(Copy_u8Address);
+/*read completion, called by the I2C engine from interrupt context*/
+static void LOC_voidSonarReadCallBack(u8 Copy_u8I2Cx, u8 Copy_u8AppEv)
+{
+	(void)Copy_u8I2Cx;
+	if (Copy_u8AppEv == I2C_EV_CMPLT)
+	{
+		RING_Sample_t LOC_Sample;
+
+		LOC_u16SonarDistance[LOC_u8SonarReading] = (LOC_u8SonarRxArr[0] << 8) | LOC_u8SonarRxArr[1];
+		LOC_Sample.TimeStamp = LOC_u32SonarReadTime;
+		LOC_Sample.Value = LOC_u16SonarDistance[LOC_u8SonarReading];
+		LOC_Sample.Source = LOC_u8SonarReading;
+		/*a full ring drops the new reading, Dropped keeps count*/
+		RING_u8Push(&LOC_SonarRing, &LOC_Sample);
+	}
+	/*on error the last valid distance is kept*/
+}
+
+/*restarted at every submission, it only expires on a transaction that outlived SONAR_I2C_WATCHDOG_MS*/
+static void LOC_voidSonarWatchdog(SWT_Timer_t *Copy_pTimer)
+{
+	(void)Copy_pTimer;
+	if (I2C_u8GetState(I2C1) != I2C_STATE_READY)
+	{
+		I2C_voidAbortTransaction(I2C1);
+		LOC_u32SonarBusResets++;
+	}
+}
+
+/*finds the next sonar of the current group starting from LOC_u8SonarNext, returns SONAR_COUNT if none is left*/
+static u8 LOC_u8SonarNextInGroup(void)
+{
+	while ((LOC_u8SonarNext < SONAR_COUNT) && (LOC_u8SonarGroup[LOC_u8SonarNext] != LOC_u8SonarGroupIndex))
+	{
+		LOC_u8SonarNext++;
+	}
+	return LOC_u8SonarNext;
+}
 
-	/*delay with 100 ms between readings*/
-	MSTK_voidSetBusyWait(100, MSTK_MILLIS);
+void HAL_voidSonarRangingUpdate(u32 Copy_u32TimeMs)
+{
+	I2C_Transaction_t LOC_Transaction = {.RepeatedState = I2C_NO_REPEAT_S};
+	u8 LOC_u8Sonar;
+
+	/*one transaction at a time on the bus, come back on the next call*/
+	if (I2C_u8GetState(I2C1) != I2C_STATE_READY)
+	{
+		return;
+	}
+
+	switch (LOC_u8SonarState)
+	{
+	case SONAR_STATE_TRIGGER:
+		LOC_u8Sonar = LOC_u8SonarNextInGroup();
+		if (LOC_u8Sonar < SONAR_COUNT)
+		{
+			/*start ranging of the next sonar of the group (1 byte, interrupt mode)*/
+			LOC_Transaction.SlaveAdd = LOC_u8SonarAddress[LOC_u8Sonar];
+			LOC_Transaction.pTxBuffer = &LOC_u8SonarRangeCmd;
+			LOC_Transaction.TxLen = 1;
+			LOC_Transaction.TransferMode = I2C_MODE_INTERRUPT;
+			if (I2C_u8SubmitTransaction(I2C1, &LOC_Transaction) == STD_TYPES_OK)
+			{
+				/*the conversion window is counted from the last trigger of the group*/
+				SWT_u8Start(&LOC_SonarWindowTimer, SWT_MS_TO_TICKS(SONAR_CONVERSION_MS), 0);
+				SWT_u8Start(&LOC_SonarWatchdogTimer, SWT_MS_TO_TICKS(SONAR_I2C_WATCHDOG_MS), 0);
+				LOC_u8SonarNext++;
+			}
+		}
+		else
+		{
+			LOC_u8SonarState = SONAR_STATE_CONVERT;
+		}
+		break;
+
+	case SONAR_STATE_CONVERT:
+		if (!SWT_u8IsRunning(&LOC_SonarWindowTimer))
+		{
+			LOC_u8SonarNext = 0;
+			LOC_u8SonarState = SONAR_STATE_READ;
+		}
+		break;
+
+	case SONAR_STATE_READ:
+		LOC_u8Sonar = LOC_u8SonarNextInGroup();
+		if (LOC_u8Sonar < SONAR_COUNT)
+		{
+			/*read the 2 bytes range of the next sonar of the group through DMA*/
+			LOC_u8SonarReading = LOC_u8Sonar;
+			LOC_u32SonarReadTime = Copy_u32TimeMs;
+			LOC_Transaction.SlaveAdd = LOC_u8SonarAddress[LOC_u8Sonar];
+			LOC_Transaction.pRxBuffer = LOC_u8SonarRxArr;
+			LOC_Transaction.RxLen = 2;
+			LOC_Transaction.TransferMode = I2C_MODE_DMA;
+			LOC_Transaction.pfCallBack = LOC_voidSonarReadCallBack;
+			if (I2C_u8SubmitTransaction(I2C1, &LOC_Transaction) == STD_TYPES_OK)
+			{
+				SWT_u8Start(&LOC_SonarWatchdogTimer, SWT_MS_TO_TICKS(SONAR_I2C_WATCHDOG_MS), 0);
+				LOC_u8SonarNext++;
+			}
+		}
+		else
+		{
+			/*group done, fire the next one*/
+			LOC_u8SonarGroupIndex++;
+			if (LOC_u8SonarGroupIndex >= SONAR_GROUP_COUNT)
+			{
+				LOC_u8SonarGroupIndex = 0;
+				LOC_u32SonarSweepCount++;
+			}
+			LOC_u8SonarNext = 0;
+			LOC_u8SonarState = SONAR_STATE_TRIGGER;
+		}
+		break;
+
+	default:
+		LOC_u8SonarState = SONAR_STATE_TRIGGER;
+		break;
+	}
+}
 
-	/*reading data from the sonar*/
-	I2C_voidMasterReceiveData(I2C1, Loc_u8ReceivedArr, 2, Copy_u8Address);
+u16 HAL_u16SonarGetDistance(u8 Copy_u8Index)
+{
+	return (Copy_u8Index < SONAR_COUNT) ? LOC_u16SonarDistance[Copy_u8Index] : 0;
+}
 
-	/*swap array result index 0 with index 1*/
-	Loc_u16Result = (Loc_u8ReceivedArr[0] << 8) | Loc_u8ReceivedArr[1];
+u8 HAL_u8SonarPopSample(RING_Sample_t *Copy_pSample)
+{
+	return RING_u8Pop(&LOC_SonarRing, Copy_pSample);
+}
 
-	/*return from this function */
-	return Loc_u16Result;
+u32 HAL_u32SonarGetSweepCount(void)
+{
+	return LOC_u32SonarSweepCount;
 }
 
-void HAL_u16SonarChangeAddress(u8 Copy_u8Address, u8 Copy_u8NewAddress)
+u32 HAL_u32SonarGetBusResets(void)
 {
-	/*local array to store commands and address*/
-	u8 Loc_u8Arr[3] = {CHANGE_SEQUENCE_1, CHANGE_SEQUENCE_2, Copy_u8NewAddress};
+	return LOC_u32SonarBusResets;
+}
 
-	/*sending new address*/
-	I2C_voidMasterSendData(I2C1, Loc_u8Arr, 3, Copy_u8Address, I2C_NO_REPEAT_S);
+u32 HAL_u32SonarGetIdleMs(void)
+{
+	/*only the conversion window is known in advance, a transaction ends with an interrupt*/
+	if ((LOC_u8SonarState != SONAR_STATE_CONVERT) || !SWT_u8IsRunning(&LOC_SonarWindowTimer))
+	{
+		return 0;
+	}
+	return (SWT_u32GetRemaining(&LOC_SonarWindowTimer) * SWT_TICK_US) / 1000;
 }
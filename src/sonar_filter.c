@@ -0,0 +1,120 @@
+#include "BIT_MATH.h"
+#include "STD_TYPES.h"
+
+#include "sonar_filter.h"
+#include "sonar_filter_config.h"
+#include "sonar_config.h"
+
+#define SONAR_FILTER_MAX_WINDOW 5
+
+//* fixed size state per sonar, every stage is O(1) per reading
+typedef struct
+{
+    u16 window[SONAR_FILTER_MAX_WINDOW]; //* last raw readings, oldest overwritten first
+    u8 count;                            //* readings in the window, up to its size
+    u8 next;                             //* slot of the next reading
+    u8 valid;                            //* an accepted reading exists
+    u16 output;                          //* last accepted distance
+    u32 acceptMs;                        //* time of the last accepted reading
+    u32 lastMs;                          //* time of the newest reading
+    u16 rejected;
+} SonarFilter;
+
+static const u8 medianSize[SONAR_COUNT] = SONAR_FILTER_MEDIAN;
+static const u16 maxRate[SONAR_COUNT] = SONAR_FILTER_MAX_RATE_CM_S;
+static const u16 holdMs[SONAR_COUNT] = SONAR_FILTER_HOLD_MS;
+
+static SonarFilter filters[SONAR_COUNT];
+
+//* median of at most 5 values: insertion sort of a copy, constant bound
+static u16 median(const u16 *values, u8 count)
+{
+    u16 sorted[SONAR_FILTER_MAX_WINDOW];
+    u8 i;
+    u8 j;
+
+    for (i = 0; i < count; i++)
+    {
+        for (j = i; (j > 0) && (sorted[j - 1] > values[i]); j--)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = values[i];
+    }
+    return sorted[count / 2];
+}
+
+void SONARFILTER_Init()
+{
+    u8 i;
+
+    for (i = 0; i < SONAR_COUNT; i++)
+    {
+        filters[i].count = 0;
+        filters[i].next = 0;
+        filters[i].valid = 0;
+        filters[i].output = 0;
+        filters[i].acceptMs = 0;
+        filters[i].lastMs = 0;
+        filters[i].rejected = 0;
+    }
+}
+
+u8 SONARFILTER_u8Update(u8 sensor, u32 timeMs, u16 rawCm, u16 *ptr_FilteredCm)
+{
+    SonarFilter *filter;
+    u8 size;
+    u16 value;
+    u32 dt;
+    u32 step;
+
+    if (sensor >= SONAR_COUNT)
+    {
+        return STD_TYPES_NOK;
+    }
+    filter = &filters[sensor];
+    size = medianSize[sensor];
+    size = (size > SONAR_FILTER_MAX_WINDOW) ? SONAR_FILTER_MAX_WINDOW : ((size == 0) ? 1 : size);
+    filter->lastMs = timeMs;
+
+    //* running median over the last readings
+    filter->window[filter->next] = (rawCm == 0) ? SONAR_FILTER_NO_ECHO_CM : rawCm;
+    filter->next = (filter->next + 1 >= size) ? 0 : (filter->next + 1);
+    filter->count += (filter->count < size);
+    value = median(filter->window, filter->count);
+
+    //* rate of change gate against the last accepted distance, reopened once the hold time ran out
+    dt = timeMs - filter->acceptMs;
+    if (filter->valid && (maxRate[sensor] != 0) && (dt <= holdMs[sensor]))
+    {
+        step = ((maxRate[sensor] * dt) / 1000) + SONAR_FILTER_GATE_SLACK_CM;
+        if ((u32)((value > filter->output) ? (value - filter->output) : (filter->output - value)) > step)
+        {
+            filter->rejected++;
+            *ptr_FilteredCm = filter->output;
+            return STD_TYPES_NOK;
+        }
+    }
+
+    filter->valid = 1;
+    filter->output = value;
+    filter->acceptMs = timeMs;
+    *ptr_FilteredCm = value;
+    return STD_TYPES_OK;
+}
+
+void SONARFILTER_GetStats(u8 sensor, SonarFilterStats *ptr_Stats)
+{
+    const SonarFilter *filter;
+
+    if (sensor >= SONAR_COUNT)
+    {
+        return;
+    }
+    filter = &filters[sensor];
+    ptr_Stats->valid = filter->valid;
+    ptr_Stats->distanceCm = filter->output;
+    ptr_Stats->rejected = filter->rejected;
+    ptr_Stats->acceptMs = filter->acceptMs;
+    ptr_Stats->ageMs = filter->lastMs - filter->acceptMs;
+}
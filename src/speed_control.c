@@ -0,0 +1,94 @@
+#include "BIT_MATH.h"
+#include "STD_TYPES.h"
+
+#include "speed_control.h"
+#include "speed_control_config.h"
+#include "PWM.h"
+
+//* reference slopes in km/h (Q8) per controller step
+#define SPEEDCTRL_ACCEL_STEP_Q8 ((SPEEDCTRL_MAX_ACCEL_KMH_S * 256 * SPEEDCTRL_PERIOD_MS) / 1000)
+#define SPEEDCTRL_DECEL_STEP_Q8 ((SPEEDCTRL_MAX_DECEL_KMH_S * 256 * SPEEDCTRL_PERIOD_MS) / 1000)
+
+static u8 targetKm = 0;
+static s32 referenceQ8 = 0;
+static s32 integral = 0;
+static s32 effort = 0;
+
+static s32 clamp(s32 value, s32 min, s32 max)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+//* both actuators switch at the same PWM update event, motor and brake never overlap mid-period
+static void setDuties(MPWM_DutyCycleType motorDuty, MPWM_DutyCycleType brakeDuty)
+{
+    const MPWM_DutyUpdateType duties[2] = {{SPEEDCTRL_MOTOR_CHANNEL, motorDuty}, {SPEEDCTRL_BRAKE_CHANNEL, brakeDuty}};
+
+    MPWM_SetDutyCycles(duties, 2);
+}
+
+void SPEEDCTRL_Init()
+{
+    targetKm = 0;
+    referenceQ8 = 0;
+    integral = 0;
+    effort = 0;
+    setDuties(0, 0);
+}
+
+void SPEEDCTRL_SetTarget(u8 newTargetKm)
+{
+    targetKm = newTargetKm;
+}
+
+//* one controller step, called once per SPEEDCTRL_PERIOD_MS
+void SPEEDCTRL_Step(u8 measuredKm)
+{
+    s32 errorQ8;
+    s32 command;
+    s32 previousEffort;
+
+    //* acceleration limit: the reference moves toward the target with bounded slope
+    referenceQ8 = clamp((s32)targetKm * 256, referenceQ8 - SPEEDCTRL_DECEL_STEP_Q8, referenceQ8 + SPEEDCTRL_ACCEL_STEP_Q8);
+
+    errorQ8 = referenceQ8 - ((s32)measuredKm * 256);
+
+    //* anti-windup: the integral only grows while the output is not saturated in the same direction
+    if (!((effort >= SPEEDCTRL_PWM_PERIOD && errorQ8 > 0) || (effort <= -SPEEDCTRL_PWM_PERIOD && errorQ8 < 0)))
+    {
+        integral = clamp(integral + ((SPEEDCTRL_KI_Q8 * errorQ8) >> 16), -SPEEDCTRL_PWM_PERIOD, SPEEDCTRL_PWM_PERIOD);
+    }
+
+    command = clamp(((SPEEDCTRL_KP_Q8 * errorQ8) >> 16) + integral, -SPEEDCTRL_PWM_PERIOD, SPEEDCTRL_PWM_PERIOD);
+
+    //* jerk limit: bounded duty change per step
+    previousEffort = effort;
+    effort = clamp(command, effort - SPEEDCTRL_MAX_DUTY_STEP, effort + SPEEDCTRL_MAX_DUTY_STEP);
+
+    //* positive effort drives the motor, negative effort drives the brake, never both
+    if ((effort >= 0) && (previousEffort >= 0))
+    {
+        //* brake already released: the motor duty ramps to the new value without CPU per period
+        if ((effort != previousEffort) &&
+            (MPWM_u8StartRamp(SPEEDCTRL_MOTOR_CHANNEL, (MPWM_DutyCycleType)effort, SPEEDCTRL_RAMP_PERIODS, MPWM_RAMP_S_CURVE, NULL) != STD_TYPES_OK))
+        {
+            setDuties((MPWM_DutyCycleType)effort, 0);
+        }
+    }
+    else if (effort >= 0)
+    {
+        setDuties((MPWM_DutyCycleType)effort, 0);
+    }
+    else
+    {
+        setDuties(0, (MPWM_DutyCycleType)(-effort));
+    }
+}
+
+void SPEEDCTRL_GetState(SpeedCtrlState *ptr_State)
+{
+    ptr_State->targetKm = targetKm;
+    ptr_State->referenceKm = (u8)(referenceQ8 >> 8);
+    ptr_State->integral = integral;
+    ptr_State->effort = effort;
+}
@@ -0,0 +1,160 @@
+#include "BIT_MATH.h"
+#include "STD_TYPES.h"
+
+#include "telemetry.h"
+#include "telemetry_config.h"
+#include "UART_interface.h"
+
+//* largest raw frame with some room: header 7, status payload 37, CRC 2
+#define TELEMETRY_MAX_FRAME 48
+//* COBS adds one byte per 254 bytes (one here) and the frame ends with the 0x00 delimiter
+#define TELEMETRY_MAX_ENCODED (TELEMETRY_MAX_FRAME + 2)
+
+static u16 sequence = 0;
+
+static u8 *putU16(u8 *ptr, u16 value)
+{
+    ptr[0] = (u8)value;
+    ptr[1] = (u8)(value >> 8);
+    return ptr + 2;
+}
+
+static u8 *putU32(u8 *ptr, u32 value)
+{
+    ptr = putU16(ptr, (u16)value);
+    return putU16(ptr, (u16)(value >> 16));
+}
+
+static u16 saturateU16(u32 value)
+{
+    return (value > 0xFFFF) ? 0xFFFF : (u16)value;
+}
+
+//* CRC16-CCITT, polynomial 0x1021, initial value 0xFFFF, bitwise (a status frame is 46 bytes)
+static u16 crc16(const u8 *data, u8 length)
+{
+    u16 crc = 0xFFFF;
+    u8 bit;
+
+    while (length--)
+    {
+        crc ^= (u16)(*data++) << 8;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (u16)((crc << 1) ^ 0x1021) : (u16)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+//* consistent overhead byte stuffing: removes every 0x00 so it can delimit frames, returns the encoded length
+static u8 cobsEncode(const u8 *input, u8 length, u8 *output)
+{
+    u8 codeIndex = 0;
+    u8 outIndex = 1;
+    u8 code = 1;
+    u8 i;
+
+    for (i = 0; i < length; i++)
+    {
+        if (input[i] == 0)
+        {
+            output[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+        else
+        {
+            output[outIndex++] = input[i];
+            code++;
+        }
+    }
+    output[codeIndex] = code;
+    return outIndex;
+}
+
+static void sendFrame(const u8 *frame, u8 length)
+{
+    u8 encoded[TELEMETRY_MAX_ENCODED];
+    u8 encodedLength = cobsEncode(frame, length, encoded);
+
+    encoded[encodedLength++] = 0;
+    //* a frame cut by a full TX ring fails its CRC on the host, the drop counter tells how many bytes
+    MUSART1_u16Enqueue(encoded, encodedLength);
+}
+
+void TELEMETRY_Init()
+{
+    sequence = 0;
+}
+
+void TELEMETRY_SendStatus(const TelemetryStatus *ptr_Status)
+{
+    u8 frame[TELEMETRY_MAX_FRAME];
+    u8 *ptr = frame;
+    u8 i;
+    s32 effort = ptr_Status->control.effort;
+
+    *ptr++ = TELEMETRY_FRAME_STATUS;
+    ptr = putU16(ptr, sequence++);
+    ptr = putU32(ptr, ptr_Status->timeMs);
+
+    for (i = 0; i < 4; i++)
+    {
+        ptr = putU16(ptr, ptr_Status->distance[i]);
+    }
+    *ptr++ = ptr_Status->speed.speedPerKm;
+    *ptr++ = ptr_Status->speed.statusCode;
+    ptr = putU16(ptr, saturateU16(ptr_Status->speed.RPM));
+    *ptr++ = ptr_Status->control.targetKm;
+    *ptr++ = ptr_Status->control.referenceKm;
+    //* positive effort is motor duty, negative effort is brake duty
+    ptr = putU16(ptr, (effort > 0) ? (u16)effort : 0);
+    ptr = putU16(ptr, (effort < 0) ? (u16)(-effort) : 0);
+    *ptr++ = ptr_Status->flags;
+    ptr = putU16(ptr, saturateU16(MUSART1_u32GetDropCount()));
+    for (i = 0; i < 4; i++)
+    {
+        ptr = putU16(ptr, ptr_Status->rejected[i]);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        ptr = putU16(ptr, ptr_Status->filtered[i]);
+    }
+
+    ptr = putU16(ptr, crc16(frame, (u8)(ptr - frame)));
+    sendFrame(frame, (u8)(ptr - frame));
+}
+
+void TELEMETRY_SendProfile(u32 timeMs, u8 zone, const PROF_Stats_t *ptr_Stats)
+{
+    u8 frame[TELEMETRY_MAX_FRAME];
+    u8 *ptr = frame;
+
+    *ptr++ = TELEMETRY_FRAME_PROFILE;
+    ptr = putU16(ptr, sequence++);
+    ptr = putU32(ptr, timeMs);
+    *ptr++ = zone;
+    ptr = putU32(ptr, ptr_Stats->Count);
+    ptr = putU32(ptr, ptr_Stats->Min);
+    ptr = putU32(ptr, ptr_Stats->Max);
+    ptr = putU32(ptr, ptr_Stats->Mean);
+
+    ptr = putU16(ptr, crc16(frame, (u8)(ptr - frame)));
+    sendFrame(frame, (u8)(ptr - frame));
+}
+
+void TELEMETRY_SendLoad(u32 timeMs, const SCH_Load_t *ptr_Load)
+{
+    u8 frame[TELEMETRY_MAX_FRAME];
+    u8 *ptr = frame;
+
+    *ptr++ = TELEMETRY_FRAME_LOAD;
+    ptr = putU16(ptr, sequence++);
+    ptr = putU32(ptr, timeMs);
+    ptr = putU32(ptr, ptr_Load->IdleUs);
+    ptr = putU32(ptr, ptr_Load->ActiveUs);
+
+    ptr = putU16(ptr, crc16(frame, (u8)(ptr - frame)));
+    sendFrame(frame, (u8)(ptr - frame));
+}
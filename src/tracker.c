@@ -0,0 +1,74 @@
+#include "BIT_MATH.h"
+#include "STD_TYPES.h"
+
+#include "tracker.h"
+#include "tracker_config.h"
+
+//* gap and relative speed are kept in Q4 (1/16 cm, 1/16 cm/s), with gaps below 65536 cm,
+//* speeds within TRACKER_MAX_SPEED_CM_S and dt within 1000 ms every product below fits in s32
+
+typedef char TRACKER_MaxDtInRange[(TRACKER_MAX_DT_MS > 0 && TRACKER_MAX_DT_MS <= 1000) ? 1 : -1];
+
+static u8 valid = 0;
+static u32 lastTimeMs = 0;
+static s32 gapQ4 = 0;
+static s32 speedQ4 = 0;
+
+static s32 clamp(s32 value, s32 min, s32 max)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+void TRACKER_Init()
+{
+    valid = 0;
+    lastTimeMs = 0;
+    gapQ4 = 0;
+    speedQ4 = 0;
+}
+
+u8 TRACKER_u8Update(u32 timeMs, u16 gapCm)
+{
+    u32 dt = timeMs - lastTimeMs;
+    s32 residualQ4;
+
+    if (valid && (dt == 0))
+    {
+        return STD_TYPES_NOK;
+    }
+    lastTimeMs = timeMs;
+
+    //* first reading or a stale track: restart from the measurement with no relative speed
+    if (!valid || (dt > TRACKER_MAX_DT_MS))
+    {
+        valid = 1;
+        gapQ4 = (s32)gapCm << 4;
+        speedQ4 = 0;
+        return STD_TYPES_OK;
+    }
+
+    //* predict over dt, then correct gap and speed with the residual
+    gapQ4 += (speedQ4 * (s32)dt) / 1000;
+    residualQ4 = ((s32)gapCm << 4) - gapQ4;
+    gapQ4 = clamp(gapQ4 + ((TRACKER_ALPHA_Q8 * residualQ4) >> 8), 0, 0xFFFF << 4);
+    speedQ4 = clamp(speedQ4 + ((((TRACKER_BETA_Q8 * residualQ4) >> 8) * 1000) / (s32)dt),
+                    -(TRACKER_MAX_SPEED_CM_S << 4), TRACKER_MAX_SPEED_CM_S << 4);
+
+    return STD_TYPES_OK;
+}
+
+void TRACKER_GetState(TrackerState *ptr_State)
+{
+    u32 ttcMs = TRACKER_TTC_NONE;
+
+    //* gap < 2^20 (Q4) so gap * 1000 stays below 2^30
+    if (valid && (speedQ4 < 0))
+    {
+        ttcMs = ((u32)gapQ4 * 1000) / (u32)(-speedQ4);
+        ttcMs = (ttcMs > TRACKER_TTC_NONE) ? TRACKER_TTC_NONE : ttcMs;
+    }
+    ptr_State->valid = valid;
+    ptr_State->gapCm = (u16)((gapQ4 + 8) >> 4);
+    ptr_State->relSpeedCmS = (s16)(speedQ4 / 16);
+    ptr_State->ttcMs = (u16)ttcMs;
+}
@@ -0,0 +1,33 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+//* shared helpers of the HOST_SIM tests under tests/, built and run by tools/run_host_tests.py
+//* every test is a plain program: it prints the failed checks and exits non zero when one failed
+
+#include <stdio.h>
+
+static int hostTestFailures = 0;
+
+#define TEST_CHECK(cond, ...)                                             \
+    do                                                                    \
+    {                                                                     \
+        if (!(cond))                                                      \
+        {                                                                 \
+            hostTestFailures++;                                           \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);                   \
+            printf(__VA_ARGS__);                                          \
+            printf("\n");                                                 \
+        }                                                                 \
+    } while (0)
+
+#define TEST_RESULT() ((hostTestFailures == 0) ? 0 : 1)
+
+//* the virtual target calls into the world model of SIM_Lcfg.c, tests that drive the registers
+//* themselves link an empty world instead
+#define HOST_TEST_EMPTY_WORLD()                                           \
+    void SIM_voidWorldInit(void) {}                                       \
+    void SIM_voidWorldStep(u32 Copy_u32ElapsedUs) { (void)Copy_u32ElapsedUs; } \
+    u32 SIM_u32WorldHallPeriodUs(void) { return 0; }                      \
+    u8 SIM_u8WorldReport(void) { return 0; }
+
+#endif
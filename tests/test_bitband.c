@@ -0,0 +1,137 @@
+//* bit-band accesses of every register migrated to BIT_BAND.h against a plain read-modify-write of the
+//* same register: for every bit and a few seed patterns BITBAND_SET / BITBAND_CLR / BITBAND_WRITE must leave
+//* the value SET_BIT / CLR_BIT give, BITBAND_GET must read GET_BIT, and the neighbour registers stay as
+//* they were. The target alias address is checked against the Cortex-M3 formula on its own
+//* Sources: src/SIM_program.c
+
+#include <stddef.h>
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+
+#include "stm32f103C8.h"
+#include "BIT_BAND.h"
+#include "SIM_interface.h"
+
+#include "host_test.h"
+
+HOST_TEST_EMPTY_WORLD()
+
+typedef struct
+{
+    const char *name;
+    u32 address;
+    volatile u32 *reg;
+} MigratedRegister;
+
+#define REGISTER(NAME, BASE, TYPE, FIELD) {NAME, (BASE) + (u32)offsetof(TYPE, FIELD), &((TYPE *)PERIPH_BASE(BASE))->FIELD}
+
+#define DMA_CCR(CHANNEL)                                                                                        \
+    REGISTER("DMA1 CCR" #CHANNEL, DMA1_u32_BASE_ADDRESS, DMA_RegDef_t, Channel[(CHANNEL) - 1].CCR)
+
+//* the registers the drivers set and clear through BITBAND_SET / BITBAND_CLR
+static const MigratedRegister registers[] = {
+    REGISTER("RCC AHBENR", RCC_u32_BASE_ADDRESS, RCC_RegDef_t, AHBENR),
+    REGISTER("RCC APB1ENR", RCC_u32_BASE_ADDRESS, RCC_RegDef_t, APB1ENR),
+    REGISTER("RCC APB2ENR", RCC_u32_BASE_ADDRESS, RCC_RegDef_t, APB2ENR),
+    DMA_CCR(1), DMA_CCR(2), DMA_CCR(3), DMA_CCR(4), DMA_CCR(5), DMA_CCR(6), DMA_CCR(7),
+    REGISTER("TIM1 CR1", TIMER1_BASE_ADDRESS, TIMER_RegDef_t, CR1),
+    REGISTER("TIM1 DIER", TIMER1_BASE_ADDRESS, TIMER_RegDef_t, DIER),
+    REGISTER("TIM1 CCER", TIMER1_BASE_ADDRESS, TIMER_RegDef_t, CCER),
+    REGISTER("TIM1 BDTR", TIMER1_BASE_ADDRESS, TIMER_RegDef_t, BDTR),
+    REGISTER("TIM3 CR1", TIMER3_BASE_ADDRESS, TIMER_RegDef_t, CR1),
+    REGISTER("TIM3 DIER", TIMER3_BASE_ADDRESS, TIMER_RegDef_t, DIER),
+    REGISTER("TIM3 CCER", TIMER3_BASE_ADDRESS, TIMER_RegDef_t, CCER),
+    REGISTER("TIM4 CR1", TIMER4_BASE_ADDRESS, TIMER_RegDef_t, CR1),
+    REGISTER("TIM4 DIER", TIMER4_BASE_ADDRESS, TIMER_RegDef_t, DIER),
+    REGISTER("TIM4 CCER", TIMER4_BASE_ADDRESS, TIMER_RegDef_t, CCER),
+    REGISTER("I2C1 CR1", I2C1_BASE_ADDRESS, I2C_RegDef_t, CR1),
+    REGISTER("I2C1 CR2", I2C1_BASE_ADDRESS, I2C_RegDef_t, CR2),
+    REGISTER("I2C1 SR1", I2C1_BASE_ADDRESS, I2C_RegDef_t, SR1),
+    REGISTER("I2C2 CR1", I2C2_BASE_ADDRESS, I2C_RegDef_t, CR1),
+    REGISTER("I2C2 CR2", I2C2_BASE_ADDRESS, I2C_RegDef_t, CR2),
+    REGISTER("I2C2 SR1", I2C2_BASE_ADDRESS, I2C_RegDef_t, SR1),
+    REGISTER("EXTI IMR", EXTI_u32_BASE_ADDRESS, EXTI_RegDef_t, IMR),
+    REGISTER("EXTI RTSR", EXTI_u32_BASE_ADDRESS, EXTI_RegDef_t, RTSR),
+    REGISTER("EXTI FTSR", EXTI_u32_BASE_ADDRESS, EXTI_RegDef_t, FTSR),
+    REGISTER("USART1 SR", USART1_u32_BASE_ADDRESS, UART_Register, SR),
+    REGISTER("USART1 CR1", USART1_u32_BASE_ADDRESS, UART_Register, CR1),
+    REGISTER("USART1 CR3", USART1_u32_BASE_ADDRESS, UART_Register, CR3),
+};
+
+#define REGISTER_COUNT (sizeof(registers) / sizeof(registers[0]))
+
+static const u32 seeds[] = {0x00000000UL, 0xFFFFFFFFUL, 0xA5A5A5A5UL, 0x5A5A5A5AUL};
+
+#define SEED_COUNT (sizeof(seeds) / sizeof(seeds[0]))
+#define GUARD 0xC3C3C3C3UL
+
+//* one access through the alias against the same access done on a plain copy, the words around stay put
+static void checkAccess(const MigratedRegister *r, u32 bit, u32 seed, u8 access)
+{
+    static const char *const names[] = {"SET", "CLR", "WRITE 1", "WRITE 0"};
+    volatile u32 *reg = r->reg;
+    u32 expected = seed;
+
+    reg[-1] = GUARD;
+    reg[1] = GUARD;
+    *reg = seed;
+    switch (access)
+    {
+    case 0:
+        BITBAND_SET(*reg, bit);
+        SET_BIT(expected, bit);
+        break;
+    case 1:
+        BITBAND_CLR(*reg, bit);
+        CLR_BIT(expected, bit);
+        break;
+    case 2:
+        BITBAND_WRITE(*reg, bit, 1);
+        SET_BIT(expected, bit);
+        break;
+    default:
+        BITBAND_WRITE(*reg, bit, 0);
+        CLR_BIT(expected, bit);
+        break;
+    }
+    TEST_CHECK(*reg == expected, "%s bit %u, seed 0x%08X: BITBAND_%s gives 0x%08X, read-modify-write 0x%08X", r->name,
+               bit, seed, names[access], *reg, expected);
+    TEST_CHECK(BITBAND_GET(*reg, bit) == GET_BIT(expected, bit), "%s bit %u: BITBAND_GET after BITBAND_%s", r->name,
+               bit, names[access]);
+    TEST_CHECK((reg[-1] == GUARD) && (reg[1] == GUARD), "%s bit %u: BITBAND_%s touched a neighbour register", r->name,
+               bit, names[access]);
+}
+
+int main(void)
+{
+    u32 i;
+    u32 bit;
+    u32 seed;
+    u8 access;
+
+    for (i = 0; i < REGISTER_COUNT; i++)
+    {
+        for (bit = 0; bit < 32; bit++)
+        {
+            //* alias word of the target: region base + 0x02000000 + byte offset * 32 + bit * 4
+            u32 alias = (registers[i].address & 0xF0000000UL) + 0x02000000UL +
+                        ((registers[i].address - BITBAND_PERIPH_START) * 32) + (bit * 4);
+
+            TEST_CHECK(BITBAND_ALIAS_ADDRESS(registers[i].address, bit) == alias,
+                       "%s bit %u: alias 0x%08X, expected 0x%08X", registers[i].name, bit,
+                       (u32)BITBAND_ALIAS_ADDRESS(registers[i].address, bit), alias);
+            for (seed = 0; seed < SEED_COUNT; seed++)
+            {
+                for (access = 0; access < 4; access++)
+                {
+                    checkAccess(&registers[i], bit, seeds[seed], access);
+                }
+            }
+        }
+        *registers[i].reg = 0;
+    }
+
+    printf("bitband: %u registers, %d failure(s)\n", (u32)REGISTER_COUNT, hostTestFailures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,136 @@
+//* forward gap fusion of F1 / F2 through the real sonar filter: no reading yet, agreeing sensors,
+//* disagreeing sensors (nearer gap, confidence AGREE / difference), the staleness ramp of one and both
+//* sensors from FUSION_FRESH_MS to FUSION_STALE_MS, and a lone fresh sensor (FUSION_SINGLE_CONFIDENCE)
+//* Sources: src/fusion.c src/sonar_filter.c
+
+#include "STD_TYPES.h"
+
+#include "sonar.h"
+#include "fusion.h"
+#include "fusion_config.h"
+
+#include "sonar_filter.h"
+
+#include "host_test.h"
+
+//* readings of one sensor are SWEEP_MS apart, like the sonar sweeps
+#define SWEEP_MS 100
+#define SETTLE_READINGS 3
+
+static void restart(void)
+{
+    SONARFILTER_Init();
+    FUSION_Init();
+}
+
+//* steady readings of one sensor up to lastMs, enough to fill the median window
+static void feed(u8 sensor, u32 lastMs, u16 cm)
+{
+    u16 filtered;
+    u32 i;
+
+    for (i = SETTLE_READINGS; i > 0; i--)
+    {
+        SONARFILTER_u8Update(sensor, lastMs - (i - 1) * SWEEP_MS, cm, &filtered);
+    }
+}
+
+static FusionState fuse(u32 nowMs)
+{
+    FusionState state;
+
+    FUSION_Update(nowMs);
+    FUSION_GetState(&state);
+    return state;
+}
+
+//* confidence of a sensor last seen ageMs ago, the ramp of fusion.c
+static u32 expectedFreshness(u32 ageMs)
+{
+    if (ageMs <= FUSION_FRESH_MS)
+    {
+        return FUSION_FULL_CONFIDENCE;
+    }
+    if (ageMs >= FUSION_STALE_MS)
+    {
+        return 0;
+    }
+    return ((FUSION_STALE_MS - ageMs) * FUSION_FULL_CONFIDENCE) / (FUSION_STALE_MS - FUSION_FRESH_MS);
+}
+
+int main(void)
+{
+    FusionState state;
+    u32 age;
+    u32 previous;
+    u32 expected;
+
+    //* startup: no reading, no confidence, no time stamp
+    restart();
+    state = fuse(1000);
+    TEST_CHECK((state.confidence == 0) && (state.sensors == 0) && (state.timeMs == 0),
+               "no reading: confidence %u, sensors %u, time %u", state.confidence, state.sensors, state.timeMs);
+
+    //* agreeing sensors: fused between them, full confidence
+    restart();
+    feed(SONAR_F1, 1000, 1000);
+    feed(SONAR_F2, 1000, 1020);
+    state = fuse(1000);
+    TEST_CHECK((state.gapCm >= 1000) && (state.gapCm <= 1020), "agreeing: gap %u cm", state.gapCm);
+    TEST_CHECK(state.confidence == FUSION_FULL_CONFIDENCE, "agreeing: confidence %u", state.confidence);
+    TEST_CHECK(state.sensors == (FUSION_USED_F1 | FUSION_USED_F2), "agreeing: sensors %u", state.sensors);
+    TEST_CHECK(state.timeMs == 1000, "agreeing: time %u", state.timeMs);
+
+    //* disagreeing sensors: the nearer gap, confidence falling with the difference
+    restart();
+    feed(SONAR_F1, 1000, 1400);
+    feed(SONAR_F2, 1000, 1000);
+    state = fuse(1000);
+    expected = (FUSION_FULL_CONFIDENCE * FUSION_AGREE_CM) / 400;
+    TEST_CHECK(state.gapCm == 1000, "disagreeing: gap %u cm, expected the nearer 1000", state.gapCm);
+    TEST_CHECK(state.confidence == expected, "disagreeing: confidence %u, expected %u", state.confidence, expected);
+    TEST_CHECK(state.sensors == (FUSION_USED_F1 | FUSION_USED_F2), "disagreeing: sensors %u", state.sensors);
+    //* just past the agreement limit the confidence is still below full
+    restart();
+    feed(SONAR_F1, 1000, 1000);
+    feed(SONAR_F2, 1000, 1000 + FUSION_AGREE_CM + 1);
+    state = fuse(1000);
+    TEST_CHECK((state.gapCm == 1000) && (state.confidence < FUSION_FULL_CONFIDENCE),
+               "barely disagreeing: gap %u cm, confidence %u", state.gapCm, state.confidence);
+
+    //* both sensors ageing together: the confidence follows the ramp, never rises, and the gap is kept
+    restart();
+    feed(SONAR_F1, 1000, 800);
+    feed(SONAR_F2, 1000, 800);
+    previous = FUSION_FULL_CONFIDENCE;
+    for (age = 0; age <= FUSION_STALE_MS + SWEEP_MS; age += 25)
+    {
+        state = fuse(1000 + age);
+        expected = expectedFreshness(age);
+        TEST_CHECK(state.confidence == expected, "age %u ms: confidence %u, expected %u", age, state.confidence,
+                   expected);
+        TEST_CHECK(state.confidence <= previous, "age %u ms: confidence rose to %u", age, state.confidence);
+        TEST_CHECK(state.gapCm == 800, "age %u ms: gap %u cm", age, state.gapCm);
+        previous = state.confidence;
+    }
+    TEST_CHECK((state.sensors == 0) && (state.timeMs == 1000), "stale: sensors %u, time %u", state.sensors,
+               state.timeMs);
+
+    //* one sensor fresh, the other one stale: the fresh one alone at the single sensor confidence
+    restart();
+    feed(SONAR_F1, 1000, 900);
+    feed(SONAR_F2, 1000 + FUSION_STALE_MS, 700);
+    state = fuse(1000 + FUSION_STALE_MS);
+    TEST_CHECK((state.gapCm == 700) && (state.sensors == FUSION_USED_F2) &&
+                   (state.confidence == FUSION_SINGLE_CONFIDENCE),
+               "single sensor: gap %u cm, sensors %u, confidence %u", state.gapCm, state.sensors, state.confidence);
+    //* and its own staleness ramp on top
+    age = (FUSION_FRESH_MS + FUSION_STALE_MS) / 2;
+    state = fuse(1000 + FUSION_STALE_MS + age);
+    expected = (FUSION_SINGLE_CONFIDENCE * expectedFreshness(age)) / FUSION_FULL_CONFIDENCE;
+    TEST_CHECK(state.confidence == expected, "single sensor %u ms old: confidence %u, expected %u", age,
+               state.confidence, expected);
+
+    printf("fusion: %d failure(s)\n", hostTestFailures);
+    return TEST_RESULT();
+}
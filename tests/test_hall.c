@@ -0,0 +1,93 @@
+//* hall speed from TIM2 captures of the virtual target against the float formula, over a sweep of edge periods
+//* from above HALL_MAX_SPEED_KMH down to the stop timeout. Tolerance: RPM within 1 of 60e6 / period (integer
+//* division), speedPerKm in [exact - 1.5, exact + 0.01] km/h: the whole km/h truncation of the Q16.16 product
+//* plus the truncated RPM (HALL_KMH_PER_RPM, 0.38 km/h per RPM on the 1 m wheel)
+//* Sources: src/hall.c src/GPT1.c src/NVIC_program.c src/DMA_program.c src/PROF_program.c src/SIM_program.c
+
+#include <math.h>
+
+#include "STD_TYPES.h"
+
+#include "NVIC_interface.h"
+#include "GPT.h"
+#include "hall.h"
+#include "hall_config.h"
+#include "hall_private.h"
+#include "SIM_interface.h"
+
+#include "host_test.h"
+
+#define SWEEP_POINTS 200
+#define SWEEP_MIN_US 40000UL     //* faster than HALL_MAX_SPEED_KMH: saturated
+#define SWEEP_MAX_US 1990000UL   //* just inside HALL_STOP_TIMEOUT_MS
+
+#define KMH_TOLERANCE_LOW 1.5
+#define KMH_TOLERANCE_HIGH 0.01
+
+static u32 hallPeriodUs;
+
+void SIM_voidWorldInit(void) {}
+void SIM_voidWorldStep(u32 Copy_u32Us) { (void)Copy_u32Us; }
+u32 SIM_u32WorldHallPeriodUs(void) { return hallPeriodUs; }
+u8 SIM_u8WorldReport(void) { return 0; }
+
+static double exactKmh(u32 periodUs)
+{
+    double rpm = 60e6 / ((double)periodUs * HALL_PULSES_PER_REV);
+
+    return rpm * 2.0 * M_PI * HALL_WHEEL_RADIUS_MM * 60.0 / 1e6;
+}
+
+//* runs the wheel at one edge period long enough for a settled capture, then takes one sample
+static void sample(u32 periodUs, SpeedData *data)
+{
+    hallPeriodUs = periodUs;
+    SIM_voidAdvance(3 * periodUs + 1000);
+    HALL_GetSpeed(data);
+}
+
+int main(void)
+{
+    SpeedData data;
+    double ratio = pow((double)SWEEP_MAX_US / SWEEP_MIN_US, 1.0 / (SWEEP_POINTS - 1));
+    double exact;
+    double worst = 0;
+    u32 period;
+    u32 i;
+
+    HALL_Init();
+    NVIC_u8EnableInterrupt(TIM2_IRQN);
+
+    for (i = 0; i < SWEEP_POINTS; i++)
+    {
+        period = (u32)(SWEEP_MIN_US * pow(ratio, i));
+        sample(period, &data);
+        exact = exactKmh(period);
+
+        TEST_CHECK(fabs((double)data.RPM - 60e6 / ((double)period * HALL_PULSES_PER_REV)) < 1.0,
+                   "period %u us: RPM %u, exact %.3f", period, data.RPM, 60e6 / ((double)period * HALL_PULSES_PER_REV));
+        TEST_CHECK(data.statusCode == CAR_MOVING, "period %u us: status %u", period, data.statusCode);
+        if (exact >= HALL_MAX_SPEED_KMH)
+        {
+            TEST_CHECK(data.speedPerKm == HALL_MAX_SPEED_KMH, "period %u us: %u km/h, expected the %u km/h saturation",
+                       period, data.speedPerKm, HALL_MAX_SPEED_KMH);
+            continue;
+        }
+        TEST_CHECK((data.speedPerKm >= exact - KMH_TOLERANCE_LOW) && (data.speedPerKm <= exact + KMH_TOLERANCE_HIGH),
+                   "period %u us: %u km/h, exact %.3f km/h", period, data.speedPerKm, exact);
+        if (exact - data.speedPerKm > worst)
+        {
+            worst = exact - data.speedPerKm;
+        }
+    }
+
+    //* no edge for longer than the stop timeout
+    hallPeriodUs = 0;
+    SIM_voidAdvance(HALL_STOP_TIMEOUT_MS * 1000UL + 10000);
+    HALL_GetSpeed(&data);
+    TEST_CHECK((data.RPM == 0) && (data.speedPerKm == 0) && (data.statusCode == CAR_NOT_MOVING),
+               "stopped wheel: RPM %u, %u km/h, status %u", data.RPM, data.speedPerKm, data.statusCode);
+
+    printf("hall: %u periods, worst error %.3f km/h, %d failure(s)\n", SWEEP_POINTS, worst, hostTestFailures);
+    return TEST_RESULT();
+}
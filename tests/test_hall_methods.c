@@ -0,0 +1,113 @@
+//* period / count method switch of the hall speed on a toothed wheel (100 pulses per turn, 100 us edge jitter):
+//* the crossover is T = sqrt(2 * 100 us * 10 ms) = 1414 us, 160 km/h on the 1 m wheel, back at half the
+//* edges per sample (80 km/h). The wheel speeds up from 20 to 240 km/h and slows down again, sampled every 10 ms
+//* like the speed task, the method must follow the crossover and both methods stay within their error bound
+//* Sources: src/hall.c src/GPT1.c src/NVIC_program.c src/DMA_program.c src/PROF_program.c src/SIM_program.c
+//* Flags: -DHALL_PULSES_PER_REV=100 -DHALL_EDGE_JITTER_US=100
+
+#include <math.h>
+
+#include "STD_TYPES.h"
+
+#include "NVIC_interface.h"
+#include "GPT.h"
+#include "hall.h"
+#include "hall_config.h"
+#include "SIM_interface.h"
+
+#include "host_test.h"
+
+#define SAMPLE_MS 10
+#define RAMP_KMH_PER_S 20.0
+#define LOW_KMH 20.0
+#define HIGH_KMH 240.0
+
+//* crossover speeds of the configuration above, a sample window counts them within one edge
+#define CROSSOVER_UP_KMH 160.0
+#define CROSSOVER_DOWN_KMH 80.0
+#define SWITCH_MARGIN_KMH 10.0
+
+static double speedKmh;
+
+static double circumference(void) { return 2.0 * M_PI * HALL_WHEEL_RADIUS_MM / 1000.0; }
+
+void SIM_voidWorldInit(void) {}
+void SIM_voidWorldStep(u32 Copy_u32Us) { (void)Copy_u32Us; }
+u32 SIM_u32WorldHallPeriodUs(void)
+{
+    return (u32)(circumference() / (speedKmh / 3.6) / HALL_PULSES_PER_REV * 1e6);
+}
+u8 SIM_u8WorldReport(void) { return 0; }
+
+static u32 switches;
+static double switchUpKmh;
+static double switchDownKmh;
+
+static void sampleAt(double kmh, u8 *method)
+{
+    SpeedData data;
+    double periodUs;
+    double bound;
+
+    speedKmh = kmh;
+    SIM_voidAdvance(SAMPLE_MS * 1000);
+    HALL_GetSpeed(&data);
+
+    //* period method: exact up to the whole km/h truncation, count method: one edge per window on top
+    periodUs = (double)SIM_u32WorldHallPeriodUs();
+    bound = 1.5 + ((HALL_u8GetMethod() == HALL_METHOD_COUNT) ? (kmh * periodUs / (SAMPLE_MS * 1000.0)) : 0.0);
+    TEST_CHECK(fabs(data.speedPerKm - kmh) <= bound, "%.1f km/h measured %u km/h (%s method), bound %.2f", kmh,
+               data.speedPerKm, (HALL_u8GetMethod() == HALL_METHOD_COUNT) ? "count" : "period", bound);
+
+    if (HALL_u8GetMethod() != *method)
+    {
+        switches++;
+        if (HALL_u8GetMethod() == HALL_METHOD_COUNT)
+        {
+            switchUpKmh = kmh;
+        }
+        else
+        {
+            switchDownKmh = kmh;
+        }
+        *method = HALL_u8GetMethod();
+    }
+}
+
+int main(void)
+{
+    double step = RAMP_KMH_PER_S * SAMPLE_MS / 1000.0;
+    double kmh;
+    u8 method;
+
+    HALL_Init();
+    NVIC_u8EnableInterrupt(TIM2_IRQN);
+
+    //* settle at the low speed first
+    speedKmh = LOW_KMH;
+    SIM_voidAdvance(100000);
+    method = HALL_METHOD_PERIOD;
+    sampleAt(LOW_KMH, &method);
+    TEST_CHECK(method == HALL_METHOD_PERIOD, "count method at %.0f km/h", LOW_KMH);
+
+    for (kmh = LOW_KMH; kmh < HIGH_KMH; kmh += step)
+    {
+        sampleAt(kmh, &method);
+    }
+    TEST_CHECK(method == HALL_METHOD_COUNT, "still the period method at %.0f km/h", HIGH_KMH);
+    for (kmh = HIGH_KMH; kmh > LOW_KMH; kmh -= step)
+    {
+        sampleAt(kmh, &method);
+    }
+    TEST_CHECK(method == HALL_METHOD_PERIOD, "still the count method at %.0f km/h", LOW_KMH);
+
+    TEST_CHECK(switches == 2, "%u method switches, expected 2 (hysteresis)", switches);
+    TEST_CHECK(fabs(switchUpKmh - CROSSOVER_UP_KMH) <= SWITCH_MARGIN_KMH, "count method from %.1f km/h, expected %.0f",
+               switchUpKmh, CROSSOVER_UP_KMH);
+    TEST_CHECK(fabs(switchDownKmh - CROSSOVER_DOWN_KMH) <= SWITCH_MARGIN_KMH,
+               "period method from %.1f km/h, expected %.0f", switchDownKmh, CROSSOVER_DOWN_KMH);
+
+    printf("hall methods: count from %.1f km/h, period from %.1f km/h, %u switches, %d failure(s)\n", switchUpKmh,
+           switchDownKmh, switches, hostTestFailures);
+    return TEST_RESULT();
+}
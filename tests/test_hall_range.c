@@ -0,0 +1,151 @@
+//* Q16.16 hall speed over the whole capture range: every edge period from 1 capture tick up to the stop timeout
+//* (past the 16-bit counter: with one pulse per turn of the 1 m wheel every period up to 88.6 ms saturates) goes
+//* through HALL_GetSpeed on stubbed captures and is checked against the float formula, with the tolerance of
+//* test_hall.c (RPM within 1, speedPerKm in [exact - 1.5, exact + 0.01] km/h or saturated). Then a host timing
+//* of the km/h conversion alone, the float formula the driver used before against the Q16.16 one it uses now
+//* Sources: src/hall.c
+//* Flags: -DPROF_ENABLE=0
+
+#include <math.h>
+#include <time.h>
+
+#include "STD_TYPES.h"
+
+#include "GPT.h"
+#include "hall.h"
+#include "hall_config.h"
+#include "hall_private.h"
+
+#include "host_test.h"
+
+#define PERIOD_MIN 1UL
+#define PERIOD_MAX HALL_STOP_TIMEOUT_TICKS
+
+#define KMH_TOLERANCE_LOW 1.5
+#define KMH_TOLERANCE_HIGH 0.01
+
+//* conversions timed per formula: TIMING_ROUNDS passes over the whole capture range
+#define TIMING_ROUNDS 5
+
+//* capture stubs: one edge period, the last edge captured right at the estimate
+static u32 capturePeriod;
+static u32 captureTime;
+static u32 captureEdges;
+
+void Gpt_SetMode(Gpt_ModeType mode) { (void)mode; }
+void Gpt_SetCaptureNotification(void (*notification)(void)) { (void)notification; }
+u32 Gpt_u32GetCaptureTime(void) { return captureTime; }
+u32 Gpt_u32GetCapturePeriod(void) { return capturePeriod; }
+u32 Gpt_u32GetLastCaptureTime(void) { return captureTime; }
+u32 Gpt_u32GetCaptureEdgeCount(void) { return captureEdges; }
+
+//* sink for the timed conversions, keeps them from being optimized away
+static volatile u32 timingSink;
+
+static double exactRpm(u32 period) { return 60e6 / ((double)period * GPT_CAPTURE_TICK_US * HALL_PULSES_PER_REV); }
+
+//* the float formula: km/h from RPM with the wheel circumference in double
+static u8 floatKmh(u32 rpm)
+{
+    double kmh = rpm * 2.0 * M_PI * HALL_WHEEL_RADIUS_MM * 60.0 / 1e6;
+
+    return (kmh >= HALL_MAX_SPEED_KMH) ? HALL_MAX_SPEED_KMH : (u8)kmh;
+}
+
+//* the Q16.16 formula of HALL_Estimate (hall.c), checked against it by the sweep below
+static u8 fixedKmh(u32 rpm)
+{
+    if (rpm >= HALL_RPM_AT_MAX_SPEED)
+    {
+        return HALL_MAX_SPEED_KMH;
+    }
+    return (u8)((rpm * HALL_KMH_PER_RPM_Q16) >> 16);
+}
+
+//* one edge period, two new edges per estimate so both methods see the same period
+static void sample(u32 period, SpeedData *data)
+{
+    capturePeriod = period;
+    captureEdges += 2;
+    captureTime += 2 * period;
+    HALL_GetSpeed(data);
+}
+
+static double timeConversions(u8 (*convert)(u32), const char *name)
+{
+    struct timespec start;
+    struct timespec end;
+    double ns;
+    u32 round;
+    u32 period;
+    u32 sum = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (round = 0; round < TIMING_ROUNDS; round++)
+    {
+        for (period = PERIOD_MIN; period <= PERIOD_MAX; period++)
+        {
+            sum += convert(HALL_RPM_TIME_PRODUCT / period);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    timingSink = sum;
+
+    ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) /
+         ((double)TIMING_ROUNDS * (PERIOD_MAX - PERIOD_MIN + 1));
+    printf("%s conversion: %.2f ns\n", name, ns);
+    return ns;
+}
+
+int main(void)
+{
+    SpeedData data;
+    double exact;
+    double worst = 0;
+    double floatNs;
+    double fixedNs;
+    u32 period;
+    u32 saturated = 0;
+    u32 unsaturated = 0;
+
+    HALL_Init();
+    //* the first estimate only opens the window
+    sample(PERIOD_MAX, &data);
+
+    for (period = PERIOD_MIN; period <= PERIOD_MAX; period++)
+    {
+        sample(period, &data);
+        exact = exactRpm(period) * 2.0 * M_PI * HALL_WHEEL_RADIUS_MM * 60.0 / 1e6;
+
+        TEST_CHECK(fabs((double)data.RPM - exactRpm(period)) < 1.0, "period %u: RPM %u, exact %.3f", period, data.RPM,
+                   exactRpm(period));
+        TEST_CHECK(data.statusCode == CAR_MOVING, "period %u: status %u", period, data.statusCode);
+        TEST_CHECK(data.speedPerKm == fixedKmh(data.RPM), "period %u: %u km/h, the timed formula gives %u", period,
+                   data.speedPerKm, fixedKmh(data.RPM));
+        if (data.speedPerKm == HALL_MAX_SPEED_KMH)
+        {
+            TEST_CHECK(exact >= HALL_MAX_SPEED_KMH - KMH_TOLERANCE_LOW, "period %u: saturated at %.3f km/h", period,
+                       exact);
+            saturated++;
+            continue;
+        }
+        TEST_CHECK((data.speedPerKm >= exact - KMH_TOLERANCE_LOW) && (data.speedPerKm <= exact + KMH_TOLERANCE_HIGH),
+                   "period %u: %u km/h, exact %.3f km/h", period, data.speedPerKm, exact);
+        unsaturated++;
+        if (exact - data.speedPerKm > worst)
+        {
+            worst = exact - data.speedPerKm;
+        }
+    }
+    TEST_CHECK(unsaturated != 0, "every period saturated");
+    printf("hall range: periods %u..%u, %u saturated, worst error %.3f km/h\n", (u32)PERIOD_MIN, (u32)PERIOD_MAX,
+           saturated, worst);
+
+    //* no pass / fail on the host timings, the target cycles come from the BENCH_HALL_SPEED zone
+    floatNs = timeConversions(floatKmh, "float");
+    fixedNs = timeConversions(fixedKmh, "fixed");
+    printf("float / fixed: x%.1f\n", floatNs / fixedNs);
+
+    printf("hall range: %d failure(s)\n", hostTestFailures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,199 @@
+//* I2C transaction engine against the register model of the virtual target: one, two and N byte
+//* receptions in interrupt and DMA mode, a reception whose handler runs late, and an abort, must all hand
+//* the bus back with ACK set and POS clear
+//* Sources: src/I2C_program.c src/DMA_program.c src/NVIC_program.c src/PROF_program.c src/SIM_program.c
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+
+#include "stm32f103C8.h"
+#include "NVIC_interface.h"
+#include "DMA_interface.h"
+#include "I2C_interface.h"
+#include "I2C_private.h"
+#include "SIM_interface.h"
+
+#include "host_test.h"
+
+HOST_TEST_EMPTY_WORLD()
+
+#define SLAVE_ADDRESS 0x70
+#define STEP_US 10
+#define MAX_STEPS 10000
+
+static u8 slaveNext;
+static u8 events;
+static u8 lastEvent;
+//* the first byte sent by the slave masks the event interrupt, the handler then runs late
+static u8 delayHandler;
+
+static void slaveStart(u8 read) { (void)read; }
+static u8 slaveWrite(u8 data) { (void)data; return 1; }
+static u8 slaveRead(void)
+{
+    if (delayHandler)
+    {
+        delayHandler = 0;
+        NVIC_u8DisableInterrupt(I2C1_EV_IRQN);
+    }
+    return slaveNext++;
+}
+static void slaveStop(void) {}
+
+static const SIM_I2CSlave_t slave = {SLAVE_ADDRESS, slaveStart, slaveWrite, slaveRead, slaveStop};
+
+static void callBack(u8 I2Cx, u8 AppEv)
+{
+    (void)I2Cx;
+    events++;
+    lastEvent = AppEv;
+}
+
+//* waits for the engine and the stop condition on the bus with a bounded number of virtual time steps
+static u8 waitReady(void)
+{
+    u32 step;
+
+    for (step = 0; (step < MAX_STEPS) &&
+                   ((I2C_u8GetState(I2C1) != I2C_STATE_READY) || GET_BIT(I2C1_BASE->SR2, I2C_SR2_BUSY));
+         step++)
+    {
+        SIM_voidAdvance(STEP_US);
+    }
+    return (I2C_u8GetState(I2C1) == I2C_STATE_READY) && !GET_BIT(I2C1_BASE->SR2, I2C_SR2_BUSY);
+}
+
+static void checkBusReleased(const char *what)
+{
+    TEST_CHECK(GET_BIT(I2C1_BASE->CR1, I2C_CR1_ACK) == 1, "%s: ACK left disabled", what);
+    TEST_CHECK(GET_BIT(I2C1_BASE->CR1, I2C_CR1_POS) == 0, "%s: POS left set", what);
+}
+
+static void readCase(u8 length, u8 mode)
+{
+    u8 command = 0x51;
+    u8 rx[8] = {0};
+    u8 first = slaveNext;
+    u8 i;
+    I2C_Transaction_t transaction =
+    {
+        .SlaveAdd = SLAVE_ADDRESS,
+        .pTxBuffer = &command,
+        .TxLen = 1,
+        .pRxBuffer = rx,
+        .RxLen = length,
+        .RepeatedState = I2C_NO_REPEAT_S,
+        .TransferMode = mode,
+        .pfCallBack = callBack,
+    };
+    char what[32];
+
+    snprintf(what, sizeof(what), "%s read of %u", (mode == I2C_MODE_DMA) ? "DMA" : "IT", length);
+    events = 0;
+    TEST_CHECK(I2C_u8SubmitTransaction(I2C1, &transaction) == STD_TYPES_OK, "%s: not accepted", what);
+    TEST_CHECK(waitReady(), "%s: never completed", what);
+    TEST_CHECK((events == 1) && (lastEvent == I2C_EV_CMPLT), "%s: events %u last %u", what, events, lastEvent);
+    //* the register model swaps DR once the handler returns, so it cannot serve the two DR reads of
+    //* the final BTF of an interrupt reception: its last byte is only checked by the DMA and single byte runs
+    for (i = 0; i < (((mode == I2C_MODE_DMA) || (length == 1)) ? length : (u8)(length - 1)); i++)
+    {
+        TEST_CHECK(rx[i] == (u8)(first + i), "%s: byte %u is %u, expected %u", what, i, rx[i], (u8)(first + i));
+    }
+    checkBusReleased(what);
+}
+
+//* a read of LATE_LENGTH bytes whose event handler only runs once BTF and RXNE are both set, with more than
+//* three bytes left: DR must be read on BTF too or BTF never clears and the event interrupt keeps firing
+#define LATE_LENGTH 5
+
+static void lateReadCase(void)
+{
+    u8 command = 0x51;
+    u8 rx[LATE_LENGTH] = {0};
+    u8 first = slaveNext;
+    u32 step;
+    u8 i;
+    I2C_Transaction_t transaction =
+    {
+        .SlaveAdd = SLAVE_ADDRESS,
+        .pTxBuffer = &command,
+        .TxLen = 1,
+        .pRxBuffer = rx,
+        .RxLen = LATE_LENGTH,
+        .RepeatedState = I2C_NO_REPEAT_S,
+        .TransferMode = I2C_MODE_INTERRUPT,
+        .pfCallBack = callBack,
+    };
+
+    events = 0;
+    delayHandler = 1;
+    TEST_CHECK(I2C_u8SubmitTransaction(I2C1, &transaction) == STD_TYPES_OK, "late read: not accepted");
+    for (step = 0;
+         (step < MAX_STEPS) && !(GET_BIT(I2C1_BASE->SR1, I2C_SR1_BTF) && GET_BIT(I2C1_BASE->SR1, I2C_SR1_RXNE));
+         step++)
+    {
+        SIM_voidAdvance(STEP_US);
+    }
+    TEST_CHECK(GET_BIT(I2C1_BASE->SR1, I2C_SR1_BTF) && GET_BIT(I2C1_BASE->SR1, I2C_SR1_RXNE),
+               "late read: BTF and RXNE never set together");
+    NVIC_u8EnableInterrupt(I2C1_EV_IRQN);
+    TEST_CHECK(waitReady(), "late read: never completed");
+    TEST_CHECK((events == 1) && (lastEvent == I2C_EV_CMPLT), "late read: events %u last %u", events, lastEvent);
+    for (i = 0; i < LATE_LENGTH - 1; i++)
+    {
+        TEST_CHECK(rx[i] == (u8)(first + i), "late read: byte %u is %u, expected %u", i, rx[i], (u8)(first + i));
+    }
+    checkBusReleased("late read");
+}
+
+int main(void)
+{
+    static const u8 lengths[] = {2, 3, 1, 4, 2, 1, 5};
+    u8 command = 0x51;
+    u8 rx[4];
+    u8 i;
+    I2C_Transaction_t transaction =
+    {
+        .SlaveAdd = SLAVE_ADDRESS,
+        .pTxBuffer = &command,
+        .TxLen = 1,
+        .pRxBuffer = rx,
+        .RxLen = 4,
+        .RepeatedState = I2C_NO_REPEAT_S,
+        .TransferMode = I2C_MODE_INTERRUPT,
+        .pfCallBack = callBack,
+    };
+
+    SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &slave);
+    I2C_voidInit(I2C1);
+    I2C_voidPeripheralControl(I2C1, I2C_ENABLE);
+    NVIC_u8EnableInterrupt(I2C1_EV_IRQN);
+    NVIC_u8EnableInterrupt(I2C1_ER_IRQN);
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(DMA_CHANNEL6));
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(DMA_CHANNEL7));
+
+    //* a short reception must not leave the next, longer one NACKing its first byte
+    for (i = 0; i < sizeof(lengths); i++)
+    {
+        readCase(lengths[i], I2C_MODE_INTERRUPT);
+        readCase(lengths[i], I2C_MODE_DMA);
+    }
+
+    lateReadCase();
+    readCase(LATE_LENGTH, I2C_MODE_INTERRUPT);
+
+    //* abort in the middle of a reception
+    events = 0;
+    TEST_CHECK(I2C_u8SubmitTransaction(I2C1, &transaction) == STD_TYPES_OK, "abort: not accepted");
+    SIM_voidAdvance(STEP_US * 20);
+    TEST_CHECK(I2C_u8GetState(I2C1) == I2C_STATE_BUSY_RX, "abort: not in the reception yet");
+    I2C_voidAbortTransaction(I2C1);
+    TEST_CHECK((events == 1) && (lastEvent == I2C_EV_ABORTED), "abort: events %u last %u", events, lastEvent);
+    TEST_CHECK(waitReady(), "abort: engine stuck");
+    checkBusReleased("abort");
+    readCase(2, I2C_MODE_INTERRUPT);
+    readCase(3, I2C_MODE_DMA);
+
+    printf("i2c: %d failure(s)\n", hostTestFailures);
+    return TEST_RESULT();
+}
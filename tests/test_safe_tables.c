@@ -0,0 +1,76 @@
+//* generated safe distance / safe speed tables against the braking model of safe_distance_config.h:
+//* both tables non decreasing, every distance the model rounded up to whole meters, every safe speed
+//* one whose distance fits the gap while the next whole km/h does not (up to the 255 saturation),
+//* and the two tables agreeing with each other
+//* Sources: src/safe_distance_tables.c
+
+#include <math.h>
+
+#include "STD_TYPES.h"
+
+#include "safe_distance.h"
+#include "safe_distance_config.h"
+
+#include "host_test.h"
+
+#define TABLE_SIZE 256
+
+//* safe distance of a speed in m, the formula of tools/gen_safe_tables.py
+static double modelDistance(double kmh)
+{
+    double v = kmh / 3.6;
+
+    return v * (SAFE_REACTION_TIME_MS / 1000.0) + v * v / (2.0 * (SAFE_DECEL_CM_S2 / 100.0)) +
+           SAFE_MARGIN_CM / 100.0;
+}
+
+int main(void)
+{
+    u32 i;
+    u32 decreases = 0;
+    double exact;
+    u8 speed;
+
+    for (i = 1; i < TABLE_SIZE; i++)
+    {
+        if ((SAFE_DistanceTable[i] < SAFE_DistanceTable[i - 1]) || (SAFE_SpeedTable[i] < SAFE_SpeedTable[i - 1]))
+        {
+            decreases++;
+        }
+    }
+    TEST_CHECK(decreases == 0, "%u decreasing table entries", decreases);
+
+    for (i = 0; i < TABLE_SIZE; i++)
+    {
+        exact = modelDistance(i);
+        if (exact >= TABLE_SIZE - 1)
+        {
+            TEST_CHECK(SAFE_GET_DISTANCE(i) == TABLE_SIZE - 1, "%u km/h: %u m, expected the saturation", i,
+                       SAFE_GET_DISTANCE(i));
+        }
+        else
+        {
+            TEST_CHECK((SAFE_GET_DISTANCE(i) >= exact - 1e-9) && (SAFE_GET_DISTANCE(i) < exact + 1.0),
+                       "%u km/h: %u m, model %.3f m", i, SAFE_GET_DISTANCE(i), exact);
+            //* the safe speed of the safe distance of a speed is at least that speed
+            TEST_CHECK(SAFE_GET_SPEED(SAFE_GET_DISTANCE(i)) >= i, "%u km/h: safe speed %u of its %u m", i,
+                       SAFE_GET_SPEED(SAFE_GET_DISTANCE(i)), SAFE_GET_DISTANCE(i));
+        }
+    }
+
+    for (i = 0; i < TABLE_SIZE; i++)
+    {
+        speed = SAFE_GET_SPEED(i);
+        if (speed == 0)
+        {
+            continue;
+        }
+        TEST_CHECK(modelDistance(speed) <= i + 1e-9, "%u m: safe speed %u km/h needs %.3f m", i, speed,
+                   modelDistance(speed));
+        TEST_CHECK((speed == TABLE_SIZE - 1) || (modelDistance(speed + 1) > i), "%u m: %u km/h fits as well", i,
+                   speed + 1);
+    }
+
+    printf("safe tables: %d failure(s)\n", hostTestFailures);
+    return TEST_RESULT();
+}
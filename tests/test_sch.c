@@ -0,0 +1,176 @@
+//* scheduler releases, lateness and overrun counting on a fake tick: SysTick is replaced by stubs, the
+//* tick is SCH_voidTick called by the idle wait (one interrupt per wait) and by a task that runs too long
+//* Sources: src/SCH_program.c
+
+#include "STD_TYPES.h"
+
+#include "STK_interface.h"
+#include "STK_config.h"
+#include "SCH_interface.h"
+#include "SCH_config.h"
+#include "SCH_private.h"
+
+#include "host_test.h"
+
+#define RUN_TICKS 60
+#define MAX_RUNS 256
+
+#define TASK_PLAIN 0   //* period 10, offset 0
+#define TASK_FAST 1    //* period 5, offset 2
+#define TASK_LONG 2    //* period 4, offset 1, its third run takes LONG_RUN_TICKS
+#define TASK_SLOW 3    //* period 20, offset 3
+#define TASK_DEFER 4   //* period 7, offset 6, defers itself to DEFER_TICK on its first run
+
+#define LONG_RUN_TICKS 9
+#define DEFER_TICK 30
+
+typedef struct
+{
+    u8 task;
+    u32 tick;
+} TaskRun;
+
+static TaskRun runs[MAX_RUNS];
+static u32 runCount;
+static u32 longRuns;
+static u32 deferRuns;
+
+//* SysTick stubs: VAL reads 0, the tick interrupt is the fake tick below
+void MSTK_voidInit(void) {}
+void MSTK_voidSetIntervalPeriodic(u32 Copy_u32Ticks, u8 Copy_u8ValueType, void (*Copy_ptr)(void))
+{
+    (void)Copy_u32Ticks;
+    (void)Copy_u8ValueType;
+    (void)Copy_ptr;
+}
+u32 MSTK_u32CurrentVal(void) { return 0; }
+void MSTK_voidCounterEnDis(u8 Copy_u8CounterEnOrDis) { (void)Copy_u8CounterEnOrDis; }
+void MSTK_voidRestart(u32 Copy_u32LoadVal) { (void)Copy_u32LoadVal; }
+u8 MSTK_u8GetPendingFlag(void) { return 0; }
+
+//* the idle wait ends with the (fake) tick interrupt
+void SIM_voidIdle(void) { SCH_voidTick(); }
+void SIM_voidWaitForInterrupt(void) { SCH_voidTick(); }
+//* no cycle accounting, the tasks take no time
+void SIM_voidSettle(void) {}
+
+static void record(u8 task)
+{
+    if (runCount < MAX_RUNS)
+    {
+        runs[runCount].task = task;
+        runs[runCount].tick = SCH_u32GetTickCount();
+        runCount++;
+    }
+}
+
+static void plainTask(void) { record(TASK_PLAIN); }
+static void fastTask(void) { record(TASK_FAST); }
+static void slowTask(void) { record(TASK_SLOW); }
+
+static void longTask(void)
+{
+    u8 i;
+
+    record(TASK_LONG);
+    longRuns++;
+    if (longRuns == 3)
+    {
+        //* the tick interrupts keep coming while the task runs
+        for (i = 0; i < LONG_RUN_TICKS; i++)
+        {
+            SCH_voidTick();
+        }
+    }
+}
+
+static void deferTask(void)
+{
+    record(TASK_DEFER);
+    deferRuns++;
+    if (deferRuns == 1)
+    {
+        SCH_voidDeferTask(TASK_DEFER, DEFER_TICK);
+    }
+}
+
+const SCH_Task_t SCH_Tasks[SCH_NUMBER_OF_TASKS] =
+{
+    [TASK_PLAIN] = {.pfTask = plainTask, .Period = 10, .Offset = 0},
+    [TASK_FAST] = {.pfTask = fastTask, .Period = 5, .Offset = 2},
+    [TASK_LONG] = {.pfTask = longTask, .Period = 4, .Offset = 1},
+    [TASK_SLOW] = {.pfTask = slowTask, .Period = 20, .Offset = 3},
+    [TASK_DEFER] = {.pfTask = deferTask, .Period = 7, .Offset = 6},
+};
+
+//* ticks of the runs of one task, returns their number
+static u32 runsOf(u8 task, u32 *ticks, u32 size)
+{
+    u32 i;
+    u32 count = 0;
+
+    for (i = 0; i < runCount; i++)
+    {
+        if ((runs[i].task == task) && (count < size))
+        {
+            ticks[count++] = runs[i].tick;
+        }
+    }
+    return count;
+}
+
+static void checkRuns(u8 task, const u32 *expected, u32 count)
+{
+    u32 ticks[64];
+    u32 found = runsOf(task, ticks, 64);
+    u32 i;
+
+    TEST_CHECK(found >= count, "task %u ran %u times, expected at least %u", task, found, count);
+    for (i = 0; (i < count) && (i < found); i++)
+    {
+        TEST_CHECK(ticks[i] == expected[i], "task %u run %u at tick %u, expected %u", task, i, ticks[i], expected[i]);
+    }
+}
+
+int main(void)
+{
+    //* releases before the long run (tick 9 to 18) are on time, the ones it covers run late on its end
+    static const u32 plainTicks[] = {0, 18, 20, 30, 40, 50};
+    static const u32 fastTicks[] = {2, 7, 18, 18, 22, 27, 32};
+    static const u32 longTicks[] = {1, 5, 9, 18, 21, 25, 29};
+    static const u32 slowTicks[] = {3, 23, 43};
+    static const u32 deferTicks[] = {6, 30, 37, 44};
+    const SCH_TaskStats_t *stats;
+
+    SCH_voidInit();
+    while (SCH_u32GetTickCount() < RUN_TICKS)
+    {
+        SCH_voidDispatch();
+    }
+
+    checkRuns(TASK_PLAIN, plainTicks, sizeof(plainTicks) / sizeof(plainTicks[0]));
+    checkRuns(TASK_FAST, fastTicks, sizeof(fastTicks) / sizeof(fastTicks[0]));
+    checkRuns(TASK_LONG, longTicks, sizeof(longTicks) / sizeof(longTicks[0]));
+    checkRuns(TASK_SLOW, slowTicks, sizeof(slowTicks) / sizeof(slowTicks[0]));
+    checkRuns(TASK_DEFER, deferTicks, sizeof(deferTicks) / sizeof(deferTicks[0]));
+
+    //* the long run passed the releases 13 and 17 of its own task, 17 is served one tick late
+    stats = SCH_pGetTaskStats(TASK_LONG);
+    TEST_CHECK(stats->OverrunCount == 2, "long task overruns %u, expected 2", stats->OverrunCount);
+    TEST_CHECK(stats->WcetUs == LONG_RUN_TICKS * SCH_TICK_MS * 1000UL, "long task WCET %u us", stats->WcetUs);
+    TEST_CHECK(stats->MaxLateness == 1, "long task lateness %u, expected 1", stats->MaxLateness);
+
+    //* the releases covered by the long run start at its end, the fast task also runs its release 17 then
+    stats = SCH_pGetTaskStats(TASK_PLAIN);
+    TEST_CHECK(stats->MaxLateness == 8, "plain task lateness %u, expected 8", stats->MaxLateness);
+    TEST_CHECK(stats->OverrunCount == 0, "plain task overruns %u, expected 0", stats->OverrunCount);
+    stats = SCH_pGetTaskStats(TASK_FAST);
+    TEST_CHECK(stats->MaxLateness == 6, "fast task lateness %u, expected 6", stats->MaxLateness);
+    TEST_CHECK(stats->OverrunCount == 1, "fast task overruns %u, expected 1", stats->OverrunCount);
+    stats = SCH_pGetTaskStats(TASK_DEFER);
+    TEST_CHECK(stats->MaxLateness == 0, "deferred task lateness %u, expected 0", stats->MaxLateness);
+    TEST_CHECK(stats->RunCount == deferRuns, "deferred task run count %u, ran %u", stats->RunCount, deferRuns);
+
+    printf("sch: %u runs, %d failure(s)\n", runCount, hostTestFailures);
+    return TEST_RESULT();
+}
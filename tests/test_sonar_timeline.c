@@ -0,0 +1,197 @@
+//* ranging scheduler timeline on the virtual I2C bus with two firing groups (front pair, back pair):
+//* every group is triggered, left alone for its conversion window, then read in order, and the groups
+//* alternate without a trigger of the other group inside a conversion window
+//* Sources: src/sonar.c src/SWT_program.c src/I2C_program.c src/DMA_program.c src/NVIC_program.c src/PROF_program.c src/SIM_program.c
+//* Flags: -DSONAR_GROUP_COUNT=2 -DSONAR_GROUPS={0,0,1,1}
+
+#include "STD_TYPES.h"
+#include "BIT_MATH.h"
+
+#include "NVIC_interface.h"
+#include "DMA_interface.h"
+#include "I2C_interface.h"
+#include "SWT_interface.h"
+#include "SIM_interface.h"
+#include "sonar.h"
+#include "sonar_config.h"
+
+#include "host_test.h"
+
+HOST_TEST_EMPTY_WORLD()
+
+#define RUN_MS 1000
+#define MAX_EVENTS 256
+//* a read may start late by the scheduling step and the transactions queued before it
+#define WINDOW_SLACK_US 6000
+//* all triggers of a group go out back to back
+#define TRIGGER_SPREAD_US 3000
+
+#define EVENT_TRIGGER 0
+#define EVENT_READ 1
+
+typedef struct
+{
+    u32 timeUs;
+    u8 sonar;
+    u8 kind;
+} TimelineEvent;
+
+static const u8 groupOf[SONAR_COUNT] = SONAR_GROUPS;
+static TimelineEvent timeline[MAX_EVENTS];
+static u32 eventCount;
+static u8 readIndex[SONAR_COUNT];
+static u32 ticks;
+
+//* fake scheduler tick of the software timers (SWT_SOURCE_SCH), one per loop step
+u32 SCH_u32GetTickCount(void) { return ticks; }
+void SCH_voidDeferTask(u8 Copy_u8Task, u32 Copy_u32Tick) { (void)Copy_u8Task; (void)Copy_u32Tick; }
+void SCH_voidAdvanceTask(u8 Copy_u8Task, u32 Copy_u32Tick) { (void)Copy_u8Task; (void)Copy_u32Tick; }
+
+static u16 rangeOf(u8 sonar) { return (u16)(300 + 100 * sonar); }
+
+static void record(u8 sonar, u8 kind)
+{
+    if (eventCount < MAX_EVENTS)
+    {
+        timeline[eventCount].timeUs = (u32)SIM_u64GetTimeUs();
+        timeline[eventCount].sonar = sonar;
+        timeline[eventCount].kind = kind;
+        eventCount++;
+    }
+}
+
+static void sonarStart(u8 sonar, u8 read)
+{
+    readIndex[sonar] = 0;
+    if (read)
+    {
+        record(sonar, EVENT_READ);
+    }
+}
+
+static u8 sonarWrite(u8 sonar, u8 data)
+{
+    if (data == TAKE_RANGE_CMD)
+    {
+        record(sonar, EVENT_TRIGGER);
+    }
+    return 1;
+}
+
+static u8 sonarRead(u8 sonar)
+{
+    return (readIndex[sonar]++ == 0) ? (u8)(rangeOf(sonar) >> 8) : (u8)rangeOf(sonar);
+}
+
+#define TEST_SONAR(INDEX, ADDRESS)                                                  \
+    static void start##INDEX(u8 read) { sonarStart(INDEX, read); }                  \
+    static u8 write##INDEX(u8 data) { return sonarWrite(INDEX, data); }             \
+    static u8 read##INDEX(void) { return sonarRead(INDEX); }                        \
+    static const SIM_I2CSlave_t slave##INDEX =                                      \
+        {SONAR_BASE_ADDRESS | (ADDRESS), start##INDEX, write##INDEX, read##INDEX, NULL}
+
+TEST_SONAR(0, SONAR_F1_ADDRESS);
+TEST_SONAR(1, SONAR_F2_ADDRESS);
+TEST_SONAR(2, SONAR_B1_ADDRESS);
+TEST_SONAR(3, SONAR_B2_ADDRESS);
+
+//* walks the timeline one group at a time: triggers of its members, conversion window, reads of its members
+static void checkTimeline(void)
+{
+    u32 i = 0;
+    u32 groups = 0;
+    u8 group = 0;
+    u8 sonar;
+    u32 firstTrigger;
+    u32 lastTrigger;
+
+    while (i < eventCount)
+    {
+        firstTrigger = timeline[i].timeUs;
+        lastTrigger = firstTrigger;
+        for (sonar = 0; sonar < SONAR_COUNT; sonar++)
+        {
+            if (groupOf[sonar] != group)
+            {
+                continue;
+            }
+            if (i >= eventCount)
+            {
+                return;
+            }
+            TEST_CHECK((timeline[i].kind == EVENT_TRIGGER) && (timeline[i].sonar == sonar),
+                       "group %u: event %u is %s of sonar %u, expected trigger of sonar %u", group, i,
+                       timeline[i].kind ? "read" : "trigger", timeline[i].sonar, sonar);
+            lastTrigger = timeline[i].timeUs;
+            i++;
+        }
+        TEST_CHECK(lastTrigger - firstTrigger <= TRIGGER_SPREAD_US, "group %u: triggers spread over %u us", group,
+                   lastTrigger - firstTrigger);
+
+        for (sonar = 0; sonar < SONAR_COUNT; sonar++)
+        {
+            if (groupOf[sonar] != group)
+            {
+                continue;
+            }
+            if (i >= eventCount)
+            {
+                return;
+            }
+            TEST_CHECK((timeline[i].kind == EVENT_READ) && (timeline[i].sonar == sonar),
+                       "group %u: event %u is %s of sonar %u, expected read of sonar %u", group, i,
+                       timeline[i].kind ? "read" : "trigger", timeline[i].sonar, sonar);
+            TEST_CHECK(timeline[i].timeUs - lastTrigger >= SONAR_CONVERSION_MS * 1000UL,
+                       "group %u: sonar %u read %u us after the last trigger, inside the conversion window", group,
+                       sonar, timeline[i].timeUs - lastTrigger);
+            TEST_CHECK(timeline[i].timeUs - lastTrigger <= SONAR_CONVERSION_MS * 1000UL + WINDOW_SLACK_US,
+                       "group %u: sonar %u read %u us after the last trigger", group, sonar,
+                       timeline[i].timeUs - lastTrigger);
+            i++;
+        }
+        groups++;
+        group = (u8)((group + 1) % SONAR_GROUP_COUNT);
+    }
+    TEST_CHECK(groups >= 2 * SONAR_GROUP_COUNT, "only %u groups ranged in %u ms", groups, RUN_MS);
+}
+
+int main(void)
+{
+    RING_Sample_t sample;
+    u32 samples = 0;
+
+    SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &slave0);
+    SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &slave1);
+    SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &slave2);
+    SIM_u8AttachI2CSlave(SIM_I2C_BUS1, &slave3);
+    I2C_voidInit(I2C1);
+    I2C_voidPeripheralControl(I2C1, I2C_ENABLE);
+    NVIC_u8EnableInterrupt(I2C1_EV_IRQN);
+    NVIC_u8EnableInterrupt(I2C1_ER_IRQN);
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(DMA_CHANNEL6));
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(DMA_CHANNEL7));
+    SWT_voidInit();
+
+    //* the application loop: sonar task every tick, timers dispatched first
+    for (ticks = 1; ticks <= RUN_MS; ticks++)
+    {
+        SWT_voidDispatch();
+        HAL_voidSonarRangingUpdate(ticks);
+        SIM_voidAdvance(1000);
+        while (HAL_u8SonarPopSample(&sample) == STD_TYPES_OK)
+        {
+            TEST_CHECK(sample.Value == rangeOf(sample.Source), "sonar %u reading %u, expected %u", sample.Source,
+                       sample.Value, rangeOf(sample.Source));
+            samples++;
+        }
+    }
+
+    checkTimeline();
+    TEST_CHECK(HAL_u32SonarGetBusResets() == 0, "%u watchdog bus resets", HAL_u32SonarGetBusResets());
+    TEST_CHECK(HAL_u32SonarGetSweepCount() >= 2, "%u sweeps in %u ms", HAL_u32SonarGetSweepCount(), RUN_MS);
+    TEST_CHECK(samples >= 2 * SONAR_COUNT, "%u readings queued", samples);
+
+    printf("sonar timeline: %u events, %u sweeps, %u readings, %d failure(s)\n", eventCount,
+           HAL_u32SonarGetSweepCount(), samples, hostTestFailures);
+    return TEST_RESULT();
+}
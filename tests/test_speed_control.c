@@ -0,0 +1,109 @@
+//* speed controller closed loop on the virtual TIM3 outputs against the vehicle model of the simulation
+//* (full motor duty SIM_MAX_ACCEL_MS2, full brake duty SIM_MAX_BRAKE_MS2, linear drag SIM_DRAG_PER_S):
+//* every target step must settle within SETTLE_LIMIT_MS and stay under its overshoot limit. The limits fence
+//* the response of the current gains: the integral built while the reference ramps carries the speed past
+//* the target, further when braking (stronger actuator, steeper reference slope)
+//* Sources: src/speed_control.c src/PWM.c src/DMA_program.c src/NVIC_program.c src/PROF_program.c src/SIM_program.c
+
+#include "STD_TYPES.h"
+
+#include "NVIC_interface.h"
+#include "DMA_interface.h"
+#include "PWM.h"
+#include "speed_control.h"
+#include "speed_control_config.h"
+#include "SIM_interface.h"
+#include "SIM_config.h"
+
+#include "host_test.h"
+
+//* pass / fail limits of one target step, overshoot is beyond the target in the direction of the step
+#define ACCEL_OVERSHOOT_LIMIT_KMH 6.0
+#define BRAKE_OVERSHOOT_LIMIT_KMH 12.0
+#define SETTLE_BAND_KMH 1.0       //* settled: within this band of the target for good (1 km/h measurement steps)
+#define SETTLE_LIMIT_MS 14000     //* from the target change, includes the reference ramp
+
+#define STEP_WINDOW_MS 25000
+
+#define MOTOR_TIMER (SPEEDCTRL_MOTOR_CHANNEL / MPWM_CHANNELS_PER_TIMER)
+#define MOTOR_CHANNEL (SPEEDCTRL_MOTOR_CHANNEL % MPWM_CHANNELS_PER_TIMER)
+#define BRAKE_TIMER (SPEEDCTRL_BRAKE_CHANNEL / MPWM_CHANNELS_PER_TIMER)
+#define BRAKE_CHANNEL (SPEEDCTRL_BRAKE_CHANNEL % MPWM_CHANNELS_PER_TIMER)
+
+static const MPWM_ConfigType motorPwmConfig = {SPEEDCTRL_MOTOR_CHANNEL, SPEEDCTRL_PWM_PERIOD, 0, PWM_LOW};
+static const MPWM_ConfigType brakePwmConfig = {SPEEDCTRL_BRAKE_CHANNEL, SPEEDCTRL_PWM_PERIOD, 0, PWM_LOW};
+
+static double speed;      //* m/s
+static u32 overlaps;      //* model steps with motor and brake driven together
+
+//* vehicle model, the same plant as the ego car of SIM_Lcfg.c
+void SIM_voidWorldInit(void) {}
+void SIM_voidWorldStep(u32 Copy_u32Us)
+{
+    double motor = SIM_u32TimerDutyQ16(MOTOR_TIMER, MOTOR_CHANNEL) / 65536.0;
+    double brake = SIM_u32TimerDutyQ16(BRAKE_TIMER, BRAKE_CHANNEL) / 65536.0;
+
+    if ((motor > 0) && (brake > 0))
+    {
+        overlaps++;
+    }
+    speed += ((motor * SIM_MAX_ACCEL_MS2) - (brake * SIM_MAX_BRAKE_MS2) - (SIM_DRAG_PER_S * speed)) * (Copy_u32Us * 1e-6);
+    if (speed < 0)
+    {
+        speed = 0;
+    }
+}
+u32 SIM_u32WorldHallPeriodUs(void) { return 0; }
+u8 SIM_u8WorldReport(void) { return 0; }
+
+//* runs the loop for STEP_WINDOW_MS after a new target and checks the response
+static void stepCase(u8 fromKm, u8 toKm)
+{
+    double direction = (toKm > fromKm) ? 1.0 : -1.0;
+    double limit = (toKm > fromKm) ? ACCEL_OVERSHOOT_LIMIT_KMH : BRAKE_OVERSHOOT_LIMIT_KMH;
+    double peak = 0;
+    double kmh;
+    u32 settledMs = 0;
+    u32 ms;
+
+    SPEEDCTRL_SetTarget(toKm);
+    for (ms = 0; ms < STEP_WINDOW_MS; ms += SPEEDCTRL_PERIOD_MS)
+    {
+        kmh = speed * 3.6;
+        SPEEDCTRL_Step((u8)(kmh + 0.5));
+        SIM_voidAdvance(SPEEDCTRL_PERIOD_MS * 1000);
+
+        kmh = speed * 3.6;
+        if ((kmh - toKm) * direction > peak)
+        {
+            peak = (kmh - toKm) * direction;
+        }
+        if ((kmh > toKm + SETTLE_BAND_KMH) || (kmh < toKm - SETTLE_BAND_KMH))
+        {
+            settledMs = ms + SPEEDCTRL_PERIOD_MS;
+        }
+    }
+
+    printf("step %u -> %u km/h: overshoot %.2f km/h, settled after %u ms, final %.2f km/h\n", fromKm, toKm, peak,
+           settledMs, speed * 3.6);
+    TEST_CHECK(peak <= limit, "step %u -> %u: overshoot %.2f km/h, limit %.2f", fromKm, toKm, peak, limit);
+    TEST_CHECK(settledMs <= SETTLE_LIMIT_MS, "step %u -> %u: settled after %u ms, limit %u", fromKm, toKm, settledMs,
+               SETTLE_LIMIT_MS);
+}
+
+int main(void)
+{
+    MPWM_Init(&motorPwmConfig);
+    MPWM_Init(&brakePwmConfig);
+    NVIC_u8EnableInterrupt(DMA_CHANNEL_IRQN(MPWM_Ramp_Dma_Channel));
+    SPEEDCTRL_Init();
+
+    stepCase(0, 40);
+    stepCase(40, 80);
+    stepCase(80, 30);
+    stepCase(30, 0);
+    TEST_CHECK(overlaps == 0, "motor and brake driven together during %u model steps", overlaps);
+
+    printf("speed control: %d failure(s)\n", hostTestFailures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,196 @@
+//* speed sample ring between the hall capture interrupt (producer) and the ACC task (consumer):
+//* a producer thread floods a ring while the main thread drains it, every sample must arrive once and
+//* in order, and the gaps seen by the consumer must add up to the drops counted by the producer.
+//* Then the hall driver on the virtual target: samples queued by the TIM2 capture interrupt, popped
+//* every ACC period, one per HALL_SAMPLE_PERIOD_MS with the right speed
+//* Sources: src/hall.c src/GPT1.c src/NVIC_program.c src/DMA_program.c src/PROF_program.c src/SIM_program.c
+
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "STD_TYPES.h"
+
+#include "NVIC_interface.h"
+#include "GPT.h"
+#include "RING_BUFFER.h"
+#include "hall.h"
+#include "hall_config.h"
+#include "SIM_interface.h"
+
+#include "host_test.h"
+
+#define STRESS_SAMPLES 200000UL
+#define STRESS_RING_SIZE 8
+//* out of every STRESS_BURST samples the last STRESS_BLIND_PUSH go in back to back without waiting for room,
+//* twice the ring size so they overrun it, the others wait like a slower interrupt
+#define STRESS_BURST 64
+#define STRESS_BLIND_PUSH (2 * STRESS_RING_SIZE)
+
+#define WHEEL_KMH 60.0
+#define ACC_PERIOD_MS 20
+#define RUN_MS 2000
+
+RING_DEFINE(stressRing, STRESS_RING_SIZE);
+
+static volatile u32 producerDone;
+
+static double wheelKmh;
+
+void SIM_voidWorldInit(void) {}
+void SIM_voidWorldStep(u32 Copy_u32Us) { (void)Copy_u32Us; }
+u32 SIM_u32WorldHallPeriodUs(void)
+{
+    if (wheelKmh <= 0)
+    {
+        return 0;
+    }
+    return (u32)(2.0 * M_PI * HALL_WHEEL_RADIUS_MM / 1000.0 / (wheelKmh / 3.6) / HALL_PULSES_PER_REV * 1e6);
+}
+u8 SIM_u8WorldReport(void) { return 0; }
+
+//* the interrupt side: sequence numbers in Value, the time stamp repeats it to catch torn copies.
+//* Most pushes wait for a free slot so the ring runs full and empty, the blind ones exercise the drops
+static void *producer(void *arg)
+{
+    RING_Sample_t sample;
+    u32 i;
+
+    (void)arg;
+    for (i = 1; i <= STRESS_SAMPLES; i++)
+    {
+        sample.TimeStamp = ~i;
+        sample.Value = i;
+        sample.Source = (u8)i;
+        while (((i % STRESS_BURST) < (STRESS_BURST - STRESS_BLIND_PUSH)) &&
+               (RING_u32Count(&stressRing) > stressRing.Mask))
+        {
+            //* hand the core over, the sandbox may have a single one
+            sched_yield();
+        }
+        RING_u8Push(&stressRing, &sample);
+    }
+    producerDone = 1;
+    return NULL;
+}
+
+static void stressRingTest(void)
+{
+    pthread_t thread;
+    RING_Sample_t sample;
+    u32 last = 0;
+    u32 received = 0;
+    u32 skipped = 0;
+    u32 disorders = 0;
+    u32 torn = 0;
+    u8 done = 0;
+
+    pthread_create(&thread, NULL, producer, NULL);
+    while (!done)
+    {
+        //* the last pops after the producer finished drain what it left behind
+        done = producerDone;
+        while (RING_u8Pop(&stressRing, &sample) == STD_TYPES_OK)
+        {
+            if ((sample.TimeStamp != ~sample.Value) || (sample.Source != (u8)sample.Value))
+            {
+                torn++;
+            }
+            if (sample.Value <= last)
+            {
+                disorders++;
+            }
+            else
+            {
+                skipped += sample.Value - last - 1;
+            }
+            last = sample.Value;
+            received++;
+        }
+        sched_yield();
+    }
+    pthread_join(thread, NULL);
+
+    //* samples dropped after the last one received are skipped too
+    skipped += STRESS_SAMPLES - last;
+    TEST_CHECK(torn == 0, "%u torn samples", torn);
+    TEST_CHECK(disorders == 0, "%u samples out of order or repeated", disorders);
+    TEST_CHECK(skipped == stressRing.Dropped, "%u samples missing, %u counted as dropped", skipped,
+               stressRing.Dropped);
+    TEST_CHECK(received + stressRing.Dropped == STRESS_SAMPLES, "%u received + %u dropped of %lu", received,
+               stressRing.Dropped, STRESS_SAMPLES);
+    TEST_CHECK(RING_u32Count(&stressRing) == 0, "%u samples left in the ring", RING_u32Count(&stressRing));
+    TEST_CHECK(received >= STRESS_SAMPLES - (STRESS_SAMPLES / STRESS_BURST) * STRESS_BLIND_PUSH,
+               "only %u samples received", received);
+    TEST_CHECK(stressRing.Dropped != 0, "no sample dropped, the overrun was not exercised");
+    printf("ring stress: %u received, %u dropped\n", received, stressRing.Dropped);
+}
+
+static void hallRingTest(void)
+{
+    RING_Sample_t sample;
+    u32 samples = 0;
+    u32 lastTime = 0;
+    u32 backwards = 0;
+    u32 wrongSpeed = 0;
+    u32 ms;
+
+    HALL_Init();
+    NVIC_u8EnableInterrupt(TIM2_IRQN);
+
+    wheelKmh = WHEEL_KMH;
+    //* the first edge is queued before a period is known
+    SIM_voidAdvance(3 * SIM_u32WorldHallPeriodUs());
+    while (HALL_u8PopSpeedSample(&sample) == STD_TYPES_OK)
+    {
+        lastTime = sample.TimeStamp;
+    }
+
+    for (ms = 0; ms < RUN_MS; ms += ACC_PERIOD_MS)
+    {
+        SIM_voidAdvance(ACC_PERIOD_MS * 1000);
+        while (HALL_u8PopSpeedSample(&sample) == STD_TYPES_OK)
+        {
+            if (sample.TimeStamp <= lastTime)
+            {
+                backwards++;
+            }
+            if ((sample.Source != CAR_MOVING) || (fabs(HALL_SAMPLE_SPEED(sample.Value) - WHEEL_KMH) > 1.5))
+            {
+                wrongSpeed++;
+            }
+            lastTime = sample.TimeStamp;
+            samples++;
+        }
+    }
+
+    //* one sample per edge, at most one per HALL_SAMPLE_PERIOD_MS
+    {
+        double edgesPerSample = ceil(HALL_SAMPLE_PERIOD_MS * 1000.0 / SIM_u32WorldHallPeriodUs());
+        u32 expected = (u32)(RUN_MS * 1000.0 / (edgesPerSample * SIM_u32WorldHallPeriodUs()));
+
+        TEST_CHECK((samples + 1 >= expected) && (samples <= expected + 1), "%u samples in %u ms, expected %u",
+                   samples, RUN_MS, expected);
+    }
+    TEST_CHECK(backwards == 0, "%u samples older than the one before", backwards);
+    TEST_CHECK(wrongSpeed == 0, "%u samples off the %.0f km/h wheel", wrongSpeed, WHEEL_KMH);
+
+    //* a stopped wheel queues nothing, the speed task reports the stop
+    wheelKmh = 0;
+    SIM_voidAdvance(HALL_STOP_TIMEOUT_MS * 1000UL);
+    while (HALL_u8PopSpeedSample(&sample) == STD_TYPES_OK)
+    {
+    }
+    SIM_voidAdvance(ACC_PERIOD_MS * 1000);
+    TEST_CHECK(HALL_u8PopSpeedSample(&sample) == STD_TYPES_NOK, "sample queued without a hall edge");
+    printf("hall ring: %u samples in %u ms\n", samples, RUN_MS);
+}
+
+int main(void)
+{
+    stressRingTest();
+    hallRingTest();
+
+    printf("speed ring: %d failure(s)\n", hostTestFailures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,195 @@
+//* software timer wheel under load: TIMER_COUNT timers with random delays up to MAX_DELAY_TICKS (past the
+//* SWT_RANGE of one pass, so they cascade), a third of them periodic, callbacks that stop and restart
+//* random timers. The scheduler tick is a fake counter starting near the 2^32 wrap. Dispatched on every
+//* tick each expiry must run on its exact tick, dispatched 1..MAX_LAG_TICKS late it must run in order,
+//* never before its tick and never be lost
+//* Sources: src/SWT_program.c
+
+#include <stdlib.h>
+
+#include "STD_TYPES.h"
+
+#include "SCH_interface.h"
+#include "SWT_interface.h"
+#include "SWT_config.h"
+#include "SWT_private.h"
+
+#include "host_test.h"
+
+#define TIMER_COUNT 1000
+#define MAX_DELAY_TICKS 600000UL
+#define RUN_TICKS 2000000UL
+#define MAX_LAG_TICKS 8
+//* the armed timers are checked against the tick count every SWEEP_TICKS ticks
+#define SWEEP_TICKS 4096
+
+//* what the test expects of each timer
+typedef struct
+{
+    u32 expiry;
+    u32 period;
+    u8 armed;
+} TimerShadow;
+
+static SWT_Timer_t timers[TIMER_COUNT];
+static TimerShadow shadows[TIMER_COUNT];
+
+static u32 tickCount;
+//* tick count of the dispatch before the current one, the callbacks run for the ticks after it
+static u32 lastDispatch;
+static u32 lastExpiry;
+static u32 expiries;
+static u8 lagged;
+
+//* scheduler stubs: the tick count is the fake counter, the timers task is never released
+u32 SCH_u32GetTickCount(void) { return tickCount; }
+void SCH_voidDeferTask(u8 Copy_u8TaskId, u32 Copy_u32Tick)
+{
+    (void)Copy_u8TaskId;
+    (void)Copy_u32Tick;
+}
+void SCH_voidAdvanceTask(u8 Copy_u8TaskId, u32 Copy_u32Tick)
+{
+    (void)Copy_u8TaskId;
+    (void)Copy_u32Tick;
+}
+
+static u32 randomTicks(u32 max) { return ((u32)rand() % max) + 1; }
+
+static void start(u32 i, u32 delay, u32 period)
+{
+    TEST_CHECK(SWT_u8Start(&timers[i], delay, period) == STD_TYPES_OK, "timer %u: start of %u ticks rejected", i,
+               delay);
+    shadows[i].expiry = tickCount + delay;
+    shadows[i].period = period;
+    shadows[i].armed = 1;
+}
+
+static void startRandom(u32 i)
+{
+    start(i, randomTicks(MAX_DELAY_TICKS), ((rand() % 3) == 0) ? randomTicks(MAX_DELAY_TICKS) : 0);
+}
+
+static void stop(u32 i)
+{
+    SWT_voidStop(&timers[i]);
+    shadows[i].armed = 0;
+}
+
+static void callBack(SWT_Timer_t *timer)
+{
+    u32 i = (u32)(timer - timers);
+    TimerShadow *shadow = &shadows[i];
+
+    TEST_CHECK(shadow->armed, "timer %u expired while stopped", i);
+    if (lagged)
+    {
+        TEST_CHECK(((s32)(shadow->expiry - lastDispatch) > 0) && ((s32)(shadow->expiry - tickCount) <= 0),
+                   "timer %u: expiry %u outside the dispatched ticks %u..%u", i, shadow->expiry, lastDispatch + 1,
+                   tickCount);
+    }
+    else
+    {
+        TEST_CHECK(shadow->expiry == tickCount, "timer %u: expiry %u run on tick %u", i, shadow->expiry, tickCount);
+    }
+    TEST_CHECK((s32)(shadow->expiry - lastExpiry) >= 0, "timer %u: expiry %u run after expiry %u", i, shadow->expiry,
+               lastExpiry);
+    lastExpiry = shadow->expiry;
+    expiries++;
+
+    if (shadow->period != 0)
+    {
+        shadow->expiry += shadow->period;
+    }
+    else
+    {
+        shadow->armed = 0;
+    }
+
+    //* the callbacks keep the wheel busy: stop or restart another timer, restart half of the one-shots
+    switch (rand() % 8)
+    {
+    case 0:
+        stop((u32)rand() % TIMER_COUNT);
+        break;
+    case 1:
+        startRandom((u32)rand() % TIMER_COUNT);
+        break;
+    default:
+        break;
+    }
+    if (!shadow->armed && ((rand() % 2) == 0))
+    {
+        startRandom(i);
+    }
+}
+
+//* no armed timer left behind the tick count, the wheel agrees on which ones are armed and their remaining ticks
+static void sweep(void)
+{
+    u32 i;
+
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        TEST_CHECK(SWT_u8IsRunning(&timers[i]) == shadows[i].armed, "tick %u: timer %u running %u, expected %u",
+                   tickCount, i, SWT_u8IsRunning(&timers[i]), shadows[i].armed);
+        if (!shadows[i].armed)
+        {
+            continue;
+        }
+        TEST_CHECK((s32)(shadows[i].expiry - tickCount) > 0, "tick %u: timer %u lost, expiry %u", tickCount, i,
+                   shadows[i].expiry);
+        TEST_CHECK(SWT_u32GetRemaining(&timers[i]) == shadows[i].expiry - tickCount,
+                   "tick %u: timer %u has %u ticks remaining, expected %u", tickCount, i,
+                   SWT_u32GetRemaining(&timers[i]), shadows[i].expiry - tickCount);
+    }
+}
+
+//* RUN_TICKS ticks from startTick, dispatched every tick or 1..MAX_LAG_TICKS ticks apart
+static void run(u32 startTick, u8 lag)
+{
+    u32 elapsed = 0;
+    u32 step;
+    u32 i;
+
+    tickCount = startTick;
+    lagged = lag;
+    lastDispatch = tickCount;
+    lastExpiry = tickCount;
+    expiries = 0;
+    SWT_voidInit();
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        SWT_voidCreate(&timers[i], callBack);
+        startRandom(i);
+    }
+
+    while (elapsed < RUN_TICKS)
+    {
+        step = lag ? randomTicks(MAX_LAG_TICKS) : 1;
+        tickCount += step;
+        SWT_voidDispatch();
+        lastDispatch = tickCount;
+        if ((elapsed / SWEEP_TICKS) != ((elapsed + step) / SWEEP_TICKS))
+        {
+            sweep();
+        }
+        elapsed += step;
+    }
+    sweep();
+
+    TEST_CHECK(expiries > RUN_TICKS / 1000, "only %u expiries", expiries);
+    printf("%s dispatch: %u expiries in %lu ticks from %u\n", lag ? "lagged" : "exact", expiries, RUN_TICKS,
+           startTick);
+}
+
+int main(void)
+{
+    srand(1);
+    //* both runs cross the 2^32 wrap half way
+    run(0xFFFFFFFFUL - RUN_TICKS / 2, 0);
+    run(0xFFFFFFFFUL - RUN_TICKS / 2, 1);
+
+    printf("swt: %u timers, %d failure(s)\n", TIMER_COUNT, hostTestFailures);
+    return TEST_RESULT();
+}
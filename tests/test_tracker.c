@@ -0,0 +1,115 @@
+//* alpha-beta lead car tracker on known trajectories, one reading per sonar sweep (SONAR_CONVERSION_MS):
+//* a constant closing speed, the same with +-NOISE_CM reading noise and an opening gap. After the
+//* CONVERGE_MS transient the gap, relative speed and time to collision must stay within their bounds
+//* Sources: src/tracker.c
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "STD_TYPES.h"
+
+#include "tracker.h"
+#include "tracker_config.h"
+#include "sonar_config.h"
+
+#include "host_test.h"
+
+#define START_GAP_CM 4000
+#define RUN_MS 10000
+#define CONVERGE_MS 3000
+
+#define NOISE_CM 5
+
+//* error bounds once converged: exact readings, then noisy ones (alpha 1/2, beta 1/8 smooth the noise)
+#define GAP_BOUND_CM 2.0
+#define SPEED_BOUND_CM_S 2.0
+#define TTC_BOUND 0.02
+#define NOISY_GAP_BOUND_CM 6.0
+#define NOISY_SPEED_BOUND_CM_S 20.0
+#define NOISY_TTC_BOUND 0.06
+
+typedef struct
+{
+    double gap;
+    double speed;
+    double ttc;
+} TrackErrors;
+
+//* runs one trajectory gap(t) = START_GAP_CM + speed * t, returns the worst errors after CONVERGE_MS
+static TrackErrors runTrajectory(double speedCmS, u32 noiseCm, u32 startMs)
+{
+    TrackErrors worst = {0, 0, 0};
+    TrackerState state;
+    double exactGap;
+    double exactTtc;
+    double error;
+    s32 noise;
+    u32 t;
+
+    TRACKER_Init();
+    srand(1);
+    for (t = 0; t <= RUN_MS; t += SONAR_CONVERSION_MS)
+    {
+        exactGap = START_GAP_CM + speedCmS * t / 1000.0;
+        noise = (noiseCm != 0) ? ((rand() % (2 * noiseCm + 1)) - (s32)noiseCm) : 0;
+        TRACKER_u8Update(startMs + t, (u16)(exactGap + 0.5 + noise));
+        TRACKER_GetState(&state);
+        if (t < CONVERGE_MS)
+        {
+            continue;
+        }
+
+        error = fabs(state.gapCm - exactGap);
+        worst.gap = (error > worst.gap) ? error : worst.gap;
+        error = fabs(state.relSpeedCmS - speedCmS);
+        worst.speed = (error > worst.speed) ? error : worst.speed;
+        if (speedCmS < 0)
+        {
+            exactTtc = exactGap * 1000.0 / -speedCmS;
+            error = fabs(state.ttcMs - exactTtc) / exactTtc;
+            worst.ttc = (error > worst.ttc) ? error : worst.ttc;
+        }
+        else
+        {
+            TEST_CHECK(state.ttcMs == TRACKER_TTC_NONE, "opening gap at %u ms: TTC %u ms", t, state.ttcMs);
+        }
+    }
+    printf("%+.0f cm/s, noise %u cm: gap error %.2f cm, speed error %.2f cm/s, TTC error %.2f%%\n", speedCmS,
+           noiseCm, worst.gap, worst.speed, 100.0 * worst.ttc);
+    return worst;
+}
+
+static void checkTrajectory(double speedCmS, u32 noiseCm, double gapBound, double speedBound, double ttcBound)
+{
+    TrackErrors worst = runTrajectory(speedCmS, noiseCm, 1000);
+
+    TEST_CHECK(worst.gap <= gapBound, "%+.0f cm/s: gap error %.2f cm, bound %.2f", speedCmS, worst.gap, gapBound);
+    TEST_CHECK(worst.speed <= speedBound, "%+.0f cm/s: speed error %.2f cm/s, bound %.2f", speedCmS, worst.speed,
+               speedBound);
+    TEST_CHECK(worst.ttc <= ttcBound, "%+.0f cm/s: TTC error %.2f%%, bound %.2f%%", speedCmS, 100.0 * worst.ttc,
+               100.0 * ttcBound);
+}
+
+int main(void)
+{
+    TrackerState state;
+
+    //* closing at 3 m/s from 40 m: 13.3 s to collision at the start, 3.3 s at the end
+    checkTrajectory(-300, 0, GAP_BOUND_CM, SPEED_BOUND_CM_S, TTC_BOUND);
+    checkTrajectory(-300, NOISE_CM, NOISY_GAP_BOUND_CM, NOISY_SPEED_BOUND_CM_S, NOISY_TTC_BOUND);
+    checkTrajectory(200, 0, GAP_BOUND_CM, SPEED_BOUND_CM_S, TTC_BOUND);
+
+    //* the same reading twice is ignored, a gap older than TRACKER_MAX_DT_MS restarts the track
+    TRACKER_Init();
+    TEST_CHECK(TRACKER_u8Update(100, 1000) == STD_TYPES_OK, "first reading rejected");
+    TEST_CHECK(TRACKER_u8Update(200, 900) == STD_TYPES_OK, "second reading rejected");
+    TEST_CHECK(TRACKER_u8Update(200, 900) == STD_TYPES_NOK, "repeated reading accepted");
+    TEST_CHECK(TRACKER_u8Update(200 + TRACKER_MAX_DT_MS + 1, 500) == STD_TYPES_OK, "late reading rejected");
+    TRACKER_GetState(&state);
+    TEST_CHECK((state.valid == 1) && (state.gapCm == 500) && (state.relSpeedCmS == 0) &&
+                   (state.ttcMs == TRACKER_TTC_NONE),
+               "restarted track: gap %u cm, speed %d cm/s, TTC %u ms", state.gapCm, state.relSpeedCmS, state.ttcMs);
+
+    printf("tracker: %d failure(s)\n", hostTestFailures);
+    return TEST_RESULT();
+}
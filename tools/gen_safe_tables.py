@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Generate the safe distance / safe speed tables (src/safe_distance_tables.c).
+
+The braking model comes from include/safe_distance_config.h:
+
+    distance(v) = v * reaction time + v^2 / (2 * deceleration) + margin
+
+SAFE_DistanceTable[speed km/h] is distance(speed) rounded up to whole meters.
+SAFE_SpeedTable[distance m] is the highest speed whose distance still fits,
+found by linear interpolation between the integer speed points of the model
+and rounded down. Both tables saturate at 255.
+
+The tables are checked before anything is written: both must be non
+decreasing, stay in range, and agree with each other (the safe speed of the
+safe distance of a speed is at least that speed).
+
+Usage:
+    gen_safe_tables.py            regenerate src/safe_distance_tables.c
+    gen_safe_tables.py --check    fail if the committed file is out of date
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir)
+CONFIG = os.path.join(ROOT, "include", "safe_distance_config.h")
+OUTPUT = os.path.join(ROOT, "src", "safe_distance_tables.c")
+
+PARAMETERS = ("SAFE_REACTION_TIME_MS", "SAFE_DECEL_CM_S2", "SAFE_MARGIN_CM")
+SIZE = 256
+
+
+def read_config(path):
+    defines = dict(re.findall(r"^\s*#define\s+(\w+)\s+(\d+)\s*$", open(path).read(), re.M))
+    missing = [name for name in PARAMETERS if name not in defines]
+    if missing:
+        sys.exit("%s: missing %s" % (path, ", ".join(missing)))
+    return {name: int(defines[name]) for name in PARAMETERS}
+
+
+def model(config):
+    """Returns distance(v) in m for v in km/h."""
+    reaction = config["SAFE_REACTION_TIME_MS"] / 1000.0
+    decel = config["SAFE_DECEL_CM_S2"] / 100.0
+    margin = config["SAFE_MARGIN_CM"] / 100.0
+    if decel <= 0:
+        sys.exit("SAFE_DECEL_CM_S2 must be > 0")
+
+    def distance(kmh):
+        v = kmh / 3.6
+        return v * reaction + v * v / (2 * decel) + margin
+
+    return distance
+
+
+def distance_table(distance):
+    # the small epsilon keeps exact meters from rounding up on float noise
+    return [min(SIZE - 1, int(math.ceil(distance(v) - 1e-9))) for v in range(SIZE)]
+
+
+def speed_table(distance):
+    points = [distance(v) for v in range(SIZE)]
+    table = []
+    for d in range(SIZE):
+        if d < points[0]:
+            table.append(0)
+            continue
+        if d >= points[-1]:
+            table.append(SIZE - 1)
+            continue
+        v = 0
+        while points[v + 1] <= d:
+            v += 1
+        # points[v] <= d < points[v + 1]
+        fraction = (d - points[v]) / (points[v + 1] - points[v])
+        table.append(min(SIZE - 1, int(math.floor(v + fraction))))
+    return table
+
+
+def check(distances, speeds):
+    for name, table in (("SAFE_DistanceTable", distances), ("SAFE_SpeedTable", speeds)):
+        if len(table) != SIZE or any(not 0 <= x < SIZE for x in table):
+            sys.exit("%s: out of range" % name)
+        for i in range(1, SIZE):
+            if table[i] < table[i - 1]:
+                sys.exit("%s: decreases at %d" % (name, i))
+    for v in range(SIZE):
+        if distances[v] < SIZE - 1 and speeds[distances[v]] < v:
+            sys.exit("tables disagree at %d km/h" % v)
+
+
+def format_table(name, comment, table):
+    lines = ["//* %s" % comment, "const u8 %s[256] = {" % name]
+    for i in range(0, SIZE, 16):
+        lines.append("    " + ", ".join("%3d" % x for x in table[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def render(config, distances, speeds):
+    return "\n".join([
+        "//* generated by tools/gen_safe_tables.py, do not edit",
+        "//* reaction %d ms, deceleration %d cm/s^2, margin %d cm" % (
+            config["SAFE_REACTION_TIME_MS"], config["SAFE_DECEL_CM_S2"], config["SAFE_MARGIN_CM"]),
+        "",
+        "#include \"STD_TYPES.h\"",
+        "",
+        "#include \"safe_distance.h\"",
+        "",
+        format_table("SAFE_DistanceTable", "speed (km/h) -> safe distance (m)", distances),
+        "",
+        format_table("SAFE_SpeedTable", "distance (m) -> safe speed (km/h)", speeds),
+        "",
+    ])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true", help="compare with the committed file instead of writing it")
+    args = parser.parse_args()
+
+    config = read_config(CONFIG)
+    distance = model(config)
+    distances = distance_table(distance)
+    speeds = speed_table(distance)
+    check(distances, speeds)
+    text = render(config, distances, speeds)
+
+    if args.check:
+        current = open(OUTPUT).read() if os.path.exists(OUTPUT) else ""
+        if current != text:
+            sys.exit("%s is out of date, run tools/gen_safe_tables.py" % os.path.relpath(OUTPUT, ROOT))
+        return
+    with open(OUTPUT, "w", newline="\n") as out:
+        out.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Build and run the HOST_SIM tests of tests/ on the virtual target (include/SIM_interface.h).
+
+Every tests/test_*.c is a program of its own: the "Sources:" line of its header
+comment lists the firmware files it links, "Flags:" (optional) the extra compiler
+flags. Each test runs in a scratch directory so the USART1 sink file of the virtual
+target never lands in the tree. The exit status is non zero when a test failed.
+
+Usage (from the repository root):
+    python3 tools/run_host_tests.py [--cc gcc] [test_name ...]
+"""
+
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# tests stop themselves, the run time limit of the virtual target must never end one
+CFLAGS = ["-DHOST_SIM", "-DSIM_RUN_TIME_MS=0xFFFFFFF0UL", "-O2", "-Wall", "-Iinclude", "-Itests"]
+LIBS = ["-lm", "-lpthread"]
+
+
+def header_field(path, name):
+    with open(path) as source:
+        for line in source:
+            match = re.match(r"\s*//\*\s*" + name + r":\s*(.*)", line)
+            if match:
+                return match.group(1).split()
+    return []
+
+
+def run_test(cc, path, scratch):
+    name = os.path.splitext(os.path.basename(path))[0]
+    binary = os.path.join(scratch, name)
+    command = ([cc] + CFLAGS + header_field(path, "Flags") + [os.path.relpath(path, ROOT)]
+               + header_field(path, "Sources") + LIBS + ["-o", binary])
+    build = subprocess.run(command, cwd=ROOT, capture_output=True, text=True)
+    if build.returncode != 0:
+        print(build.stderr)
+        return False
+    if build.stderr:
+        print(build.stderr)
+    result = subprocess.run([binary], cwd=scratch, capture_output=True, text=True)
+    sys.stdout.write(result.stdout)
+    return result.returncode == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("tests", nargs="*", help="test names (default: every tests/test_*.c)")
+    parser.add_argument("--cc", default="gcc")
+    args = parser.parse_args()
+
+    paths = sorted(glob.glob(os.path.join(ROOT, "tests", "test_*.c")))
+    if args.tests:
+        paths = [path for path in paths if os.path.splitext(os.path.basename(path))[0] in args.tests
+                 or os.path.splitext(os.path.basename(path))[0][len("test_"):] in args.tests]
+
+    failed = []
+    with tempfile.TemporaryDirectory() as scratch:
+        for path in paths:
+            name = os.path.basename(path)
+            passed = run_test(args.cc, path, scratch)
+            print("%s %s" % ("PASS" if passed else "FAIL", name))
+            if not passed:
+                failed.append(name)
+
+    print("%d test(s), %d failed" % (len(paths), len(failed)))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
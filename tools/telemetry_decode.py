@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Decode the binary telemetry stream sent on USART1 (see include/telemetry.h).
+
+Frames are COBS encoded and end with a 0x00 byte. Each decoded frame is
+type u8 | sequence u16 | time ms u32 | payload | CRC16-CCITT u16, little endian.
+Status frames are printed (or written as CSV), the latest statistics of every
+profiling zone (include/PROF_config.h) are summarized at the end, or written
+as JSON with --json (benchmark builds, see include/bench_config.h). Load
+frames (SCH_IDLE_MEASURE) are summed into the idle / active split of the run.
+
+Usage:
+    telemetry_decode.py /dev/ttyUSB0 [--baud 9600] [--csv out.csv]
+    telemetry_decode.py capture.bin --csv out.csv
+    telemetry_decode.py usart1.bin --json bench.json
+    cat capture.bin | telemetry_decode.py -
+"""
+
+import argparse
+import csv
+import json
+import struct
+import sys
+
+FRAME_STATUS = 1
+FRAME_PROFILE = 2
+FRAME_LOAD = 3
+
+HEADER = struct.Struct("<BHI")
+STATUS = struct.Struct("<4HBBHBBHHBH4H4H")
+PROFILE = struct.Struct("<B4I")
+LOAD = struct.Struct("<II")
+
+ZONES = ["acc", "hall_get_speed", "i2c1_transaction", "i2c2_transaction", "port_init",
+         "bench_baseline", "bench_dio_read", "bench_dio_write", "bench_port_init", "bench_pwm_set_duty",
+         "bench_hall_get_speed", "bench_required_distance", "bench_required_speed", "bench_acc",
+         "bench_dio_write_inline", "bench_tracker_update"]
+
+FIELDS = [
+    "seq", "time_ms",
+    "front1", "front2", "back1", "back2",
+    "speed_kmh", "status", "rpm", "target_kmh", "reference_kmh",
+    "motor_duty", "brake_duty", "motor_on", "brake_on", "break_latched", "uart_drops",
+    "reject_front1", "reject_front2", "reject_back1", "reject_back2",
+    "filtered_front1", "filtered_front2", "filtered_back1", "filtered_back2",
+]
+
+
+def crc16(data):
+    """CRC16-CCITT, polynomial 0x1021, initial value 0xFFFF."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            raise ValueError("bad COBS code")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_frame(encoded):
+    """Returns a dict for a valid status, profile or load frame, None otherwise."""
+    try:
+        frame = cobs_decode(encoded)
+    except ValueError:
+        return None
+    if len(frame) < HEADER.size + 2:
+        return None
+    body, crc = frame[:-2], struct.unpack("<H", frame[-2:])[0]
+    if crc16(body) != crc:
+        return None
+    kind, seq, time_ms = HEADER.unpack_from(body)
+    if kind == FRAME_PROFILE and len(body) == HEADER.size + PROFILE.size:
+        zone, count, low, high, mean = PROFILE.unpack_from(body, HEADER.size)
+        name = ZONES[zone] if zone < len(ZONES) else "zone%d" % zone
+        return dict(kind=FRAME_PROFILE, seq=seq, time_ms=time_ms, zone=name,
+                    count=count, min=low, max=high, mean=mean)
+    if kind == FRAME_LOAD and len(body) == HEADER.size + LOAD.size:
+        idle, active = LOAD.unpack_from(body, HEADER.size)
+        return dict(kind=FRAME_LOAD, seq=seq, time_ms=time_ms, idle_us=idle, active_us=active)
+    if kind != FRAME_STATUS or len(body) != HEADER.size + STATUS.size:
+        return None
+    (f1, f2, b1, b2, speed, status, rpm, target, reference,
+     motor, brake, flags, drops, r1, r2, r3, r4, g1, g2, g3, g4) = STATUS.unpack_from(body, HEADER.size)
+    return dict(zip(FIELDS, (seq, time_ms, f1, f2, b1, b2, speed, status, rpm,
+                             target, reference, motor, brake,
+                             flags & 1, (flags >> 1) & 1, (flags >> 2) & 1, drops, r1, r2, r3, r4, g1, g2, g3, g4)))
+
+
+def frames(stream, live=False):
+    """Splits the byte stream on 0x00 and yields (frame or None) per chunk.
+
+    A file or pipe ends on its first empty read (EOF). On a live port an empty
+    read is only the read timeout of a quiet line, the stream goes on.
+    """
+    pending = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if live:
+                continue
+            break
+        for byte in chunk:
+            if byte == 0:
+                if pending:
+                    yield decode_frame(bytes(pending))
+                pending.clear()
+            else:
+                pending.append(byte)
+
+
+def is_port(name):
+    return name.startswith("/dev/") or name.upper().startswith("COM")
+
+
+def open_input(name, baud):
+    if name == "-":
+        return sys.stdin.buffer
+    if is_port(name):
+        import serial  # pyserial, only needed for a live port
+        return serial.Serial(name, baud, timeout=1)
+    return open(name, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="serial port, capture file or - for stdin")
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("--csv", metavar="FILE", help="write frames as CSV instead of printing them")
+    parser.add_argument("--json", metavar="FILE", help="write the latest profiling zone statistics as JSON")
+    args = parser.parse_args()
+
+    writer = None
+    if args.csv:
+        out = open(args.csv, "w", newline="")
+        writer = csv.DictWriter(out, fieldnames=FIELDS)
+        writer.writeheader()
+
+    bad = lost = 0
+    last_seq = None
+    profile = {}
+    idle_us = active_us = 0
+    # a live port only ends with Ctrl-C, the summary below is still written
+    try:
+        for frame in frames(open_input(args.input, args.baud), live=is_port(args.input)):
+            if frame is None:
+                bad += 1
+                continue
+            if last_seq is not None:
+                lost += (frame["seq"] - last_seq - 1) & 0xFFFF
+            last_seq = frame["seq"]
+            if frame.get("kind") == FRAME_PROFILE:
+                profile[frame["zone"]] = frame
+            elif frame.get("kind") == FRAME_LOAD:
+                idle_us += frame["idle_us"]
+                active_us += frame["active_us"]
+            elif writer:
+                writer.writerow(frame)
+            else:
+                print(" ".join("%s=%s" % (k, frame[k]) for k in FIELDS))
+    except KeyboardInterrupt:
+        pass
+
+    if args.json:
+        # stable layout: sorted keys, integer cycles, so runs can be diffed
+        zones = {name: {key: zone[key] for key in ("count", "min", "max", "mean")}
+                 for name, zone in profile.items()}
+        with open(args.json, "w") as out:
+            json.dump({"unit": "cycles", "zones": zones}, out, indent=2, sort_keys=True)
+            out.write("\n")
+
+    for name in sorted(profile):
+        zone = profile[name]
+        print("profile %-24s count=%d min=%d max=%d mean=%d cycles" % (
+            name, zone["count"], zone["min"], zone["max"], zone["mean"]), file=sys.stderr)
+    if idle_us + active_us:
+        print("load: idle %.1f%%, active %.1f%% of %.3f s" % (
+            100.0 * idle_us / (idle_us + active_us), 100.0 * active_us / (idle_us + active_us),
+            (idle_us + active_us) / 1e6), file=sys.stderr)
+    print("bad frames: %d, lost frames: %d" % (bad, lost), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()